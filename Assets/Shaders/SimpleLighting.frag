@@ -3,13 +3,13 @@
 in vec4 _WorldPosition;
 in vec3 _Normal;
 in vec2 _TexCoord;
+in float _ViewDepth;
 
 out vec4 _OutColor;
 
 uniform sampler2D _MainTex;
 uniform vec4 _CameraWorldPosition;
 
-const int MAX_LIGHTS = 4;
 const int POINT_LIGHT_TYPE = 0;
 const int SPOT_LIGHT_TYPE = 1;
 const int DIRECTIONAL_LIGHT_TYPE = 2;
@@ -36,23 +36,64 @@ struct Directional
 
 const float SpecularPower = 90.0;
 
-uniform Light Lights[MAX_LIGHTS];
+// five texels per light, laid out as the Light struct
+uniform samplerBuffer _LightData;
+// offset and count into _LightIndices per cluster
+uniform usamplerBuffer _ClusterRanges;
+uniform usamplerBuffer _LightIndices;
+// tiles x, tiles y, slice scale, slice bias
+uniform vec4 _ClusterParams;
+// framebuffer width, height, slice count
+uniform vec4 _ClusterScreen;
+// light indices assigned to the object, a negative count uses the clusters
+uniform vec4 _ObjectLights;
+uniform float _ObjectLightCount;
 uniform Directional DirectionalLight;
 
+Light FetchLight(int index)
+{
+	Light light;
+	int texel = index * 5;
+	light.Position = texelFetch(_LightData, texel);
+	light.Direction = texelFetch(_LightData, texel + 1);
+	light.Color = texelFetch(_LightData, texel + 2);
+	light.Params0 = texelFetch(_LightData, texel + 3);
+	light.Params1 = texelFetch(_LightData, texel + 4);
+	return light;
+}
+
+int GetClusterIndex()
+{
+	ivec2 tiles = ivec2(_ClusterParams.xy);
+	ivec2 tile = ivec2(gl_FragCoord.xy / _ClusterScreen.xy * _ClusterParams.xy);
+	tile = clamp(tile, ivec2(0), tiles - 1);
+	int slices = int(_ClusterScreen.z);
+	int slice = int(log(max(_ViewDepth, 1e-4)) * _ClusterParams.z - _ClusterParams.w);
+	slice = clamp(slice, 0, slices - 1);
+	return (slice * tiles.y + tile.y) * tiles.x + tile.x;
+}
+
 void main()
 {
 	vec3 normal = normalize(_Normal);
 	vec3 lightColor = vec3(0.0);
 	// directional light
-	// Point / Spot Light calculation
-	for (int x = 0; x < MAX_LIGHTS; x++)
+	// Point / Spot Light calculation, only the lights assigned to the object
+	// or binned to the cluster
+	bool perObject = _ObjectLightCount >= 0.0;
+	uvec2 range = perObject ? uvec2(0u, uint(_ObjectLightCount))
+		: texelFetch(_ClusterRanges, GetClusterIndex()).xy;
+	for (uint i = 0u; i < range.y; i++)
 	{
-		vec3 lightToPos = Lights[x].Position.xyz - _WorldPosition.xyz;
+		int lightIndex = perObject ? int(_ObjectLights[int(i)])
+			: int(texelFetch(_LightIndices, int(range.x + i)).x);
+		Light light = FetchLight(lightIndex);
+		vec3 lightToPos = light.Position.xyz - _WorldPosition.xyz;
 		float distanceToLight = length(lightToPos);
 		vec3 lightVector = normalize(lightToPos);
 		float dotValue = dot(lightVector, normal);
 
-		vec3 diffuseContribution = Lights[x].Color.xyz * dotValue;
+		vec3 diffuseContribution = light.Color.xyz * dotValue;
 		vec3 specularContribution = vec3(0.0);
 
 		vec3 reflectionVector = reflect(-lightVector, normal);
@@ -62,19 +103,19 @@ void main()
 		specularContribution = vec3(pow(max(0.0, dot(posToCamera, reflectionVector)), SpecularPower) 
 			* specularMultiplier);
 
-		float attenuation = 1.0 / (Lights[x].Params1.x + Lights[x].Params1.y * distanceToLight +
-			Lights[x].Params1.z * distanceToLight * distanceToLight);
+		float attenuation = 1.0 / (light.Params1.x + light.Params1.y * distanceToLight +
+			light.Params1.z * distanceToLight * distanceToLight);
 
 		diffuseContribution *= attenuation;
 		specularContribution *= attenuation;
 
-		if (Lights[x].Params0.x == SPOT_LIGHT_TYPE)
+		if (light.Params0.x == SPOT_LIGHT_TYPE)
 		{
-			vec3 posToLight = normalize(_WorldPosition.xyz - Lights[x].Position.xyz);
-			float lightRayAngle = max(0.0, dot(posToLight, Lights[x].Direction.xyz));
+			vec3 posToLight = normalize(_WorldPosition.xyz - light.Position.xyz);
+			float lightRayAngle = max(0.0, dot(posToLight, light.Direction.xyz));
 
-			float innerCosAngle = cos(radians(Lights[x].Params0.y));
-			float outerCosAngle = cos(radians(Lights[x].Params0.z));
+			float innerCosAngle = cos(radians(light.Params0.y));
+			float outerCosAngle = cos(radians(light.Params0.z));
 
 			if (lightRayAngle < outerCosAngle)
 			{
@@ -88,7 +129,7 @@ void main()
 				specularContribution *= ratio;
 			}
 		}
-		lightColor += (diffuseContribution + specularContribution) * Lights[x].Color.w;
+		lightColor += (diffuseContribution + specularContribution) * light.Color.w;
 	}
 	vec4 tex = texture(_MainTex, _TexCoord);
 	vec4 objectColor = vec4(lightColor * tex.xyz, 1.0);
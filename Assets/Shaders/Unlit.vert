@@ -1,21 +1,48 @@
 #version 410 
 
-uniform mat4 _ModelMatrix;
-uniform mat4 _ModelMatrixInverseTransposed;
-uniform mat4 _ViewMatrix;
-uniform mat4 _ProjectionMatrix;
+// per draw data streamed through the upload ring
+layout(std140) uniform _PerDraw
+{
+	mat4 _ModelMatrix;
+	mat4 _ModelMatrixInverseTransposed;
+	mat4 _ViewMatrix;
+	mat4 _ProjectionMatrix;
+};
+
+// model matrices of batched draws, indexed by the draw index attribute
+const int MAX_BATCH_DRAWS = 128;
+layout(std140) uniform _DrawBatch
+{
+	mat4 _BatchMatrices[MAX_BATCH_DRAWS * 2];
+};
+
+// quantized positions are decoded with the mesh bounds, w is 0 for float
+// positions
+uniform vec4 _PositionScale;
+uniform vec4 _PositionOffset;
 
 in vec3 _PositionAttribute;
 in vec3 _NormalAttribute;
 in vec3 _TexCoordAttribute;
+in vec2 _DrawIndexAttribute;
 
 out vec4 _WorldPosition;
 
 void main()
 {
+	mat4 modelMatrix = _ModelMatrix;
+	mat4 modelMatrixInverse = _ModelMatrixInverseTransposed;
+	if (_DrawIndexAttribute.y > 0.5)
+	{
+		int drawIndex = int(_DrawIndexAttribute.x) * 2;
+		modelMatrix = _BatchMatrices[drawIndex];
+		modelMatrixInverse = _BatchMatrices[drawIndex + 1];
+	}
   vec3 position = _PositionAttribute;
-  mat4 MVP = _ProjectionMatrix * _ViewMatrix * _ModelMatrix;
+	if (_PositionScale.w > 0.5)
+		position = position * _PositionScale.xyz + _PositionOffset.xyz;
+  mat4 MVP = _ProjectionMatrix * _ViewMatrix * modelMatrix;
   gl_Position = MVP * vec4(position, 1.0);
 
-	_WorldPosition = _ModelMatrix * vec4(position, 1.0);
+	_WorldPosition = modelMatrix * vec4(position, 1.0);
 }
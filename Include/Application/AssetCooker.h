@@ -0,0 +1,9 @@
+#pragma once
+
+// shingine --cook <file>...
+// offline import of textures, so the encoding and mip generation done on
+// load is skipped at run time. Raw Texture2D nodes in ssd files are encoded
+// and written back in place, bitmaps are cooked into the AssetCache
+// directory. Scenes cook the external assets they reference.
+bool IsAssetCookerCommand(int argc, char **argv);
+int RunAssetCooker(int argc, char **argv);
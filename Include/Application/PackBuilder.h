@@ -0,0 +1,8 @@
+#pragma once
+// mounted at start up when it sits next to the executable
+#define PACK_DEFAULT_ARCHIVE "Assets.pak"
+
+// shingine --pack <archive> [--compress] <file>...
+// scenes pull in the external assets they reference
+bool IsPackBuilderCommand(int argc, char **argv);
+int RunPackBuilder(int argc, char **argv);
@@ -10,7 +10,25 @@ public:
   virtual void SetFileName(const String &newFileName) {
     FileName = newFileName;
   }
+  // called once the serialized attributes are set
+  virtual void OnLoad() {}
+  // bytes kept in memory and an estimate of the GPU resources, unused
+  // assets are cached within a budget of both
+  virtual size_t GetMemoryUsage() { return 0; }
+  virtual size_t GetGpuMemoryUsage() { return 0; }
+  // true for assets without references to other objects whose OnLoad
+  // output can be cached and loaded in place of the source
+  virtual bool IsCookable() { return false; }
+  // runs OnLoad once, loaders may call it on a worker thread before the
+  // asset is registered
+  void Prepare() {
+    if (Prepared)
+      return;
+    OnLoad();
+    Prepared = true;
+  }
 private:
+  bool Prepared = false;
   OriginType Origin = OriginType::Runtime;
   String FileName = "";
 };
@@ -3,6 +3,8 @@
 #include "Utility/Data/Serialization.h"
 #include "Asset.h"
 
+class ICommandBuffer;
+
 class Material : public Asset, public IMaterial, public IObject {
 public:
   SERIALIZE_CLASS(Material)
@@ -32,4 +34,16 @@ public:
   virtual void SetFloat(const String &name, float value);
   virtual void SetVector(const String &name, const glm::vec4 &value);
   virtual void SetTexture(const String &name, unsigned int textureId);
+
+  // resolves uniform names to command buffer handles once, the handles are
+  // dropped whenever a new uniform gets added to the material
+  void BindUniformHandles(ICommandBuffer *buffer);
+
+  std::vector<int> FloatUniformHandles;
+  std::vector<int> VectorUniformHandles;
+  std::vector<int> TextureUniformHandles;
+
+private:
+  void ResolveExternalTextures();
+  bool UniformHandlesResolved = false;
 };
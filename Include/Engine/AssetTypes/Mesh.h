@@ -1,7 +1,20 @@
 #pragma once
 #include "Asset.h"
+#include "Utility/Bounds.h"
 #include "Utility/Data/Serialization.h"
 
+// vertex compression flags, chosen per mesh when it's imported
+#define MESH_COMPRESS_NORMALS 0x01
+#define MESH_COMPRESS_TEXCOORDS 0x02
+#define MESH_COMPRESS_INDICES 0x04
+// positions become 16 bit with the mesh bounds as scale and offset, static
+// batches keep float positions
+#define MESH_QUANTIZE_POSITIONS 0x08
+#define MESH_COMPRESSION_DEFAULT                                               \
+  (MESH_COMPRESS_NORMALS | MESH_COMPRESS_TEXCOORDS | MESH_COMPRESS_INDICES)
+// levels of detail including the full mesh
+#define MAX_MESH_LODS 4
+
 class Mesh : public Asset, public IObject {
 public:
   SERIALIZE_CLASS(Mesh);
@@ -11,13 +24,40 @@ public:
     ATTRIBUTE_REGISTER(Mesh, Normals);
     ATTRIBUTE_REGISTER(Mesh, Positions);
     ATTRIBUTE_REGISTER(Mesh, TexCoord)
+    ATTRIBUTE_REGISTER(Mesh, VertexCompression)
+    ATTRIBUTE_REGISTER(Mesh, Optimized)
+    ATTRIBUTE_REGISTER(Mesh, LodIndices)
+    ATTRIBUTE_REGISTER(Mesh, LodIndexCounts)
+    ATTRIBUTE_REGISTER(Mesh, LodErrors)
+    VertexCompression = MESH_COMPRESSION_DEFAULT;
+    Optimized = 0;
   };
   virtual ~Mesh() {}
+  virtual void OnLoad();
+  virtual size_t GetMemoryUsage();
+  virtual size_t GetGpuMemoryUsage();
+  virtual bool IsCookable() { return true; }
+  // has to be called again when positions change at runtime
+  void CalculateBounds();
+  unsigned int GetLodCount() const {
+    return 1 + static_cast<unsigned int>(LodIndexCounts.size());
+  }
 
   ATTRIBUTE_VALUE(String, Name);
   ATTRIBUTE_VECTOR(unsigned int, Indices); // n
   ATTRIBUTE_GLM_VEC3_ARRAY(Normals);
   ATTRIBUTE_GLM_VEC3_ARRAY(Positions);
   ATTRIBUTE_GLM_VEC3_ARRAY(TexCoord);
-  // TODO add bounding box calculation
+  ATTRIBUTE_VALUE(unsigned char, VertexCompression);
+  // set once the vertex cache optimization ran, offline or at load
+  ATTRIBUTE_VALUE(unsigned char, Optimized);
+  // simplified index lists over the same vertices, one after another
+  ATTRIBUTE_VECTOR(unsigned int, LodIndices);
+  ATTRIBUTE_VECTOR(unsigned int, LodIndexCounts);
+  // object space error of each simplified level
+  ATTRIBUTE_VECTOR(float, LodErrors);
+
+  // object space bounds
+  BoundingBox Bounds;
+  BoundingSphere BoundsSphere = BoundingSphere(0);
 };
@@ -1,6 +1,9 @@
 #pragma once
 #include "Utility/Data/Serialization.h"
 
+#define LIGHT_ASSIGNMENT_CLUSTERED 0
+#define LIGHT_ASSIGNMENT_PER_OBJECT 1
+
 class RenderSettings : public IObject {
 public:
   SERIALIZE_CLASS(RenderSettings)
@@ -8,12 +11,25 @@ public:
     ATTRIBUTE_REGISTER(RenderSettings, ScreenWidth)
     ATTRIBUTE_REGISTER(RenderSettings, ScreenHeight)
     ATTRIBUTE_REGISTER(RenderSettings, WindowTitle)
+    ATTRIBUTE_REGISTER(RenderSettings, FrameLatency)
+    ATTRIBUTE_REGISTER(RenderSettings, LightAssignment)
+    ATTRIBUTE_REGISTER(RenderSettings, LodPixelError)
     // default settings
     ScreenWidth = 1280;
     ScreenHeight = 720;
     WindowTitle = "shingine";
+    FrameLatency = 0;
+    LightAssignment = LIGHT_ASSIGNMENT_CLUSTERED;
+    LodPixelError = 1.f;
   }
   ATTRIBUTE_VALUE(unsigned short, ScreenWidth)
   ATTRIBUTE_VALUE(unsigned short, ScreenHeight)
   ATTRIBUTE_VALUE(String, WindowTitle)
+  // frames the simulation may record ahead of the render thread,
+  // 0 renders on the main thread
+  ATTRIBUTE_VALUE(unsigned char, FrameLatency)
+  // clustered shading or the most important lights of each renderer
+  ATTRIBUTE_VALUE(unsigned char, LightAssignment)
+  // simplification error in pixels a level of detail may show on screen
+  ATTRIBUTE_VALUE(float, LodPixelError)
 };
@@ -4,7 +4,18 @@
 
 class Texture2D : public Asset, public IObject {
 public:
-  enum TextureFormat { Float_RGBA, Byte_RGBA };
+  // raw formats keep a single level in Pixels or Pixels32, the others keep
+  // the full mip chain in MipData. Auto is only used as the target format.
+  enum TextureFormat {
+    Float_RGBA,
+    Byte_RGBA,
+    Half_RGBA,
+    BC1_RGB,
+    BC3_RGBA,
+    BC5_RG,
+    BC7_RGBA,
+    Auto
+  };
   SERIALIZE_CLASS(Texture2D);
   Texture2D() {
     ATTRIBUTE_REGISTER(Texture2D, Name);
@@ -15,17 +26,38 @@ public:
 
     ATTRIBUTE_REGISTER(Texture2D, Pixels);
     ATTRIBUTE_REGISTER(Texture2D, Pixels32);
+    ATTRIBUTE_REGISTER(Texture2D, TargetFormat);
+    ATTRIBUTE_REGISTER(Texture2D, MipCount);
+    ATTRIBUTE_REGISTER(Texture2D, MipData);
+    TargetFormat = Auto;
+    MipCount = 0;
   };
   virtual ~Texture2D();
+  // raw pixels are converted to the target format
+  virtual void OnLoad();
+  virtual size_t GetMemoryUsage();
+  virtual size_t GetGpuMemoryUsage();
+  virtual bool IsCookable() { return true; }
 
   ATTRIBUTE_VALUE(String, Name);
+  // format raw pixels are converted to on import, Auto picks BC1 for opaque
+  // and BC3 for transparent byte textures and half floats for float ones
+  ATTRIBUTE_VALUE(unsigned int, TargetFormat);
 
   float *GetPixels();
   unsigned char *GetPixels32();
   void SetPixels(unsigned int width, unsigned int height, float *newData);
   void SetPixels(unsigned int width, unsigned int height, unsigned char *newData);
+  // replaces the pixels with a mip chain in a half float or block format
+  void SetMipData(TextureFormat format, unsigned int mipCount,
+                  std::vector<unsigned char> &data);
   void GetResolution(int &width, int &height);
   TextureFormat GetTextureFormat();
+  unsigned int GetMipCount() { return MipCount; }
+  const unsigned char *GetMipData() { return MipData.data(); }
+  unsigned int GetMipDataSize() {
+    return static_cast<unsigned int>(MipData.size());
+  }
 private:
   ATTRIBUTE_VALUE(unsigned int, Format);
   ATTRIBUTE_VALUE(unsigned int, Width);
@@ -33,4 +65,6 @@ private:
 
   ATTRIBUTE_VECTOR(float, Pixels);
   ATTRIBUTE_VECTOR(unsigned char, Pixels32);
+  ATTRIBUTE_VALUE(unsigned int, MipCount);
+  ATTRIBUTE_VECTOR(unsigned char, MipData);
 };
@@ -15,6 +15,11 @@ public:
 
 
   glm::vec4 GetColor();
+  // distance at which the attenuated light becomes negligible
+  float GetAttenuationRadius();
+
+  // proxy in the spatial index, directional lights don't have one
+  int SpatialProxyId = -1;
 
   ATTRIBUTE_GLM_VEC3(Color);
   ATTRIBUTE_VALUE(float, Exposure);
@@ -1,5 +1,6 @@
 #pragma once
 #include "ComponentSetup.h"
+#include "Utility/Bounds.h"
 
 class RendererComponent : public Component {
 public:
@@ -9,11 +10,23 @@ public:
     ATTRIBUTE_REGISTER(RendererComponent, DrawType);
     ATTRIBUTE_REGISTER(RendererComponent, MaterialReference);
     ATTRIBUTE_REGISTER(RendererComponent, MeshReference);
+    ATTRIBUTE_REGISTER(RendererComponent, Static);
+    Static = 0;
   }
-  virtual ~RendererComponent(){};
+  virtual ~RendererComponent();
 
   ATTRIBUTE_VALUE(unsigned char, Enabled);
   ATTRIBUTE_VALUE(unsigned char, DrawType);
   ATTRIBUTE_ID(MaterialReference);
   ATTRIBUTE_ID(MeshReference);
+  // static renderers are drawn in batches from shared mesh buffers
+  ATTRIBUTE_VALUE(unsigned char, Static);
+
+  // world space bounds, updated by the transform system
+  BoundingBox WorldBounds;
+  BoundingSphere WorldBoundsSphere = BoundingSphere(0);
+  bool HasWorldBounds = false;
+  int SpatialProxyId = -1;
+  // level of detail drawn last frame, kept for the hysteresis
+  unsigned int Lod = 0;
 };
\ No newline at end of file
@@ -77,5 +77,8 @@ public:
   glm::vec3 Horizontal;
   glm::vec3 CameraUp;
   glm::vec3 CameraFront;
+
+  // entity under the crosshair while the right mouse button is held
+  unsigned int PickedEntityId = 0;
 };
 }; // namespace FirstPersonController
@@ -18,6 +18,7 @@ private:
                       glm::vec3 &cameraFront, glm::vec3 &cameraUp);
   void UpdateMovement(glm::vec3 &position, glm::vec3 &Front,
                       glm::vec3 &Horizontal);
+  void UpdatePicking(const glm::vec3 &position, const glm::vec3 &cameraFront);
   class FirstPersonComponent *FirstPersonComponent = nullptr;
 
   TransformComponent *PlayerTransform = nullptr;
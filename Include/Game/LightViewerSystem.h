@@ -15,5 +15,6 @@ public:
 private:
   unsigned int CubeMeshAssetId = 0;
   unsigned int UnlitShaderId = 0;
+  int UnlitColorHandle = -1;
   ComponentMap<LightComponent> *LightComponentMap;
 };
@@ -2,6 +2,9 @@
 #include "Systems/System.h"
 #include "Utility/Data/Serialization.h"
 #include "Utility/Typedefs.h"
+#include <memory>
+
+class ISceneLoadOperation;
 
 class SceneSwitchingSystem : public System, public IObject {
 public:
@@ -13,6 +16,7 @@ public:
 private:
   const unsigned char SceneCount = 3;
   unsigned char CurrentLoadedScene = 0;
+  std::shared_ptr<ISceneLoadOperation> SceneLoad;
   String ScenePaths[3] = {"Assets/Scenes/test0.ssd", "Assets/Scenes/test1.ssd",
                           "Assets/Scenes/test2.ssd"};
 };
@@ -4,6 +4,7 @@
 class ICommandBuffer {
 public:
   enum EDrawPolygonMode { Fill, Point, Line };
+  enum ETextureBufferFormat { Float4, UInt2, UInt };
 
   virtual ~ICommandBuffer(){};
   virtual void ResetCommandBuffer() = 0;
@@ -17,9 +18,23 @@ public:
   virtual void DrawMesh(glm::mat4 &matrix, unsigned int &meshAssetId,
                         unsigned int &shaderId) = 0;
   virtual void DrawMesh(glm::mat4 &matrix, glm::mat4 &matrixInv,
-                        unsigned int &meshAssetId, unsigned int &shaderId) = 0;
+                        unsigned int &meshAssetId, unsigned int &shaderId,
+                        unsigned int lod = 0) = 0;
+  // draws meshes sharing the shader and material state from shared vertex
+  // and index buffers with as few submissions as possible, consecutive
+  // draws of the same mesh and lod are instanced. Lods may be null.
+  virtual void DrawMeshBatch(const glm::mat4 *matrices,
+                             const glm::mat4 *matricesInv,
+                             const unsigned int *meshAssetIds,
+                             const unsigned int *lods, unsigned int count,
+                             unsigned int shaderId) = 0;
 
   virtual void Execute() = 0;
+  // copies the recorded commands of the other buffer to the end of this one
+  virtual void Append(ICommandBuffer *buffer) = 0;
+
+  // resolves a uniform name to a handle which can be cached by the caller
+  virtual int GetUniformHandle(const std::string &name) = 0;
 
   virtual void SetMatrix(const std::string &name, unsigned int shaderId,
                          glm::mat4 matrix) = 0;
@@ -29,4 +44,22 @@ public:
                          const glm::vec4 &vector) = 0;
   virtual void SetTexture(const std::string &name, unsigned int shaderId,
                           unsigned int textureId) = 0;
+
+  virtual void SetMatrix(int uniformHandle, unsigned int shaderId,
+                         const glm::mat4 &matrix) = 0;
+  virtual void SetFloat(int uniformHandle, unsigned int shaderId,
+                        float value) = 0;
+  virtual void SetVector(int uniformHandle, unsigned int shaderId,
+                         const glm::vec4 &vector) = 0;
+  virtual void SetTexture(int uniformHandle, unsigned int shaderId,
+                          unsigned int textureId) = 0;
+
+  // buffer ids come from IGraphics::CreateBufferId, the data is copied into
+  // the command stream and uploaded on execute
+  virtual void UpdateTextureBuffer(unsigned int bufferId,
+                                   ETextureBufferFormat format,
+                                   const void *data,
+                                   unsigned int sizeInBytes) = 0;
+  virtual void SetTextureBuffer(int uniformHandle, unsigned int shaderId,
+                                unsigned int bufferId) = 0;
 };
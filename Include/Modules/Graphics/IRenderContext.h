@@ -13,6 +13,14 @@ public:
   virtual void SetFramebufferSize(int &width, int &height) = 0;
   virtual bool IsWindowCreated() = 0;
 
+  // presents the frame and polls window events
   virtual void Update() = 0;
+  // swaps the buffers, called from the thread owning the context
+  virtual void Present() = 0;
+  // window events and input, always called from the main thread
+  virtual void PollEvents() = 0;
+  // moves the context between the main and the render thread
+  virtual void AcquireContext() = 0;
+  virtual void ReleaseContext() = 0;
   virtual void Cleanup() = 0;
 };
@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+
+// renderers per batch, the batch matrices have to fit the minimum uniform
+// block size of 16 KB
+#define MAX_BATCH_DRAWS 128
+
+// layout expected by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+  unsigned int Count;
+  unsigned int InstanceCount;
+  unsigned int FirstIndex;
+  int BaseVertex;
+  unsigned int BaseInstance;
+};
+
+// location of a mesh in the shared vertex and index buffers
+struct MeshRange {
+  unsigned int FirstIndex = 0;
+  unsigned int IndexCount = 0;
+  int BaseVertex = 0;
+};
+
+// hands out element ranges of a shared buffer. Freed ranges are merged with
+// their free neighbours and reused first fit, so meshes that come and go
+// don't grow the buffer.
+class BatchRangeAllocator {
+public:
+  // first element of the range, the used count grows when no free range fits
+  unsigned int Allocate(unsigned int count);
+  void Free(unsigned int first, unsigned int count);
+  // elements up to the end of the last allocated range
+  unsigned int GetUsedCount() const { return UsedCount; }
+  // free elements below the used count
+  unsigned int GetFreeCount() const;
+  void Clear();
+
+private:
+  struct FreeRange {
+    unsigned int First;
+    unsigned int Count;
+  };
+  // sorted by first element, neighbours never touch
+  std::vector<FreeRange> FreeRanges;
+  unsigned int UsedCount = 0;
+};
+
+namespace IndirectDrawUtils {
+// one command per draw, consecutive draws of the same range are merged into
+// an instanced command. The base instance is the index of the first draw, so
+// an instanced attribute yields the draw index in the shader.
+void BuildCommands(const MeshRange *ranges, unsigned int count,
+                   std::vector<DrawElementsIndirectCommand> &commands);
+} // namespace IndirectDrawUtils
@@ -0,0 +1,72 @@
+#pragma once
+#include "Utility/Typedefs.h"
+#include <vector>
+
+#define LIGHT_CLUSTER_TILES_X 16
+#define LIGHT_CLUSTER_TILES_Y 9
+#define LIGHT_CLUSTER_SLICES 24
+
+// view space froxel grid used for clustered forward shading. Lights are
+// binned on the CPU every frame, the grid doesn't depend on the graphics api
+// so the binning can run and be inspected without a GPU.
+class LightClusterGrid {
+public:
+  // light as a view space sphere
+  struct ClusterLight {
+    glm::vec3 ViewPosition;
+    float Radius;
+  };
+
+  LightClusterGrid(unsigned int tilesX = LIGHT_CLUSTER_TILES_X,
+                   unsigned int tilesY = LIGHT_CLUSTER_TILES_Y,
+                   unsigned int slices = LIGHT_CLUSTER_SLICES);
+
+  // fovY in radians as passed to glm::perspective
+  void SetProjection(float fovY, float aspectRatio, float nearPlane,
+                     float farPlane);
+  void Build(const std::vector<ClusterLight> &lights);
+
+  unsigned int GetTilesX() const { return TilesX; }
+  unsigned int GetTilesY() const { return TilesY; }
+  unsigned int GetSlices() const { return Slices; }
+  unsigned int GetClusterCount() const { return TilesX * TilesY * Slices; }
+  unsigned int GetClusterIndex(unsigned int x, unsigned int y,
+                               unsigned int slice) const;
+  // slice = log(depth) * scale - bias
+  float GetSliceScale() const { return SliceScale; }
+  float GetSliceBias() const { return SliceBias; }
+  unsigned int GetSliceForDepth(float depth) const;
+
+  // offset and count into the light indices for each cluster
+  const std::vector<unsigned int> &GetClusterRanges() const {
+    return ClusterRanges;
+  }
+  const std::vector<unsigned int> &GetLightIndices() const {
+    return LightIndices;
+  }
+  // light count of a cluster, handy for debugging the binning
+  unsigned int GetLightCount(unsigned int clusterIndex) const;
+
+private:
+  void GetTileRange(float viewMin, float viewMax, float depthMin,
+                    float depthMax, float projectionScale,
+                    unsigned int tileCount, unsigned int &tileBegin,
+                    unsigned int &tileEnd) const;
+
+  unsigned int TilesX;
+  unsigned int TilesY;
+  unsigned int Slices;
+
+  float ProjectionScaleX = 1.f;
+  float ProjectionScaleY = 1.f;
+  float NearPlane = .1f;
+  float FarPlane = 1000.f;
+  float SliceScale = 1.f;
+  float SliceBias = 0.f;
+
+  std::vector<unsigned int> ClusterRanges;
+  std::vector<unsigned int> LightIndices;
+  // scratch cluster light pairs filled while binning
+  std::vector<unsigned int> PairClusters;
+  std::vector<unsigned int> PairLights;
+};
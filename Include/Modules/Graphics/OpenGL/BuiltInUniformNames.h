@@ -3,9 +3,44 @@
 #define PositionAttributeName "_PositionAttribute"
 #define NormalAttributeName "_NormalAttribute"
 #define TexCoordAttributeName "_TexCoordAttribute"
+// (draw index, 1) of a batched draw, (0, 0) for regular draws
+#define DrawIndexAttributeName "_DrawIndexAttribute"
+
+// attribute locations are bound before linking, vaos don't depend on the
+// program
+#define PositionAttributeLocation 0
+#define NormalAttributeLocation 1
+#define TexCoordAttributeLocation 2
+#define DrawIndexAttributeLocation 3
 
 #define ModelMatrixName "_ModelMatrix"
 #define ModelMatrixInverseName "_ModelMatrixInverseTransposed"
 #define ViewMatrixName "_ViewMatrix"
 #define ProjectionMatrixName "_ProjectionMatrix"
 #define CameraWorldPositionName "_CameraWorldPosition"
+// decoding of quantized positions, a zero scale marks float positions
+#define PositionScaleName "_PositionScale"
+#define PositionOffsetName "_PositionOffset"
+
+// uniform block holding the model, inverse transposed model, view and
+// projection matrices of a draw, streamed through the upload ring
+#define PerDrawBlockName "_PerDraw"
+#define PER_DRAW_BINDING 0
+#define PER_DRAW_DATA_SIZE 256
+// model and inverse transposed model matrices of every draw in a batch
+#define DrawBatchBlockName "_DrawBatch"
+#define DRAW_BATCH_BINDING 1
+#define DRAW_BATCH_DATA_SIZE (MAX_BATCH_DRAWS * 128)
+
+// handles of the built-in uniforms, OglShaderManager registers them first so
+// they can be used without a name lookup
+enum EBuiltInUniformHandle {
+  ModelMatrixHandle = 0,
+  ModelMatrixInverseHandle,
+  ViewMatrixHandle,
+  ProjectionMatrixHandle,
+  CameraWorldPositionHandle,
+  PositionScaleHandle,
+  PositionOffsetHandle,
+  BuiltInUniformHandleCount
+};
@@ -11,6 +11,10 @@
 #define CB_SET_MATRIX_UNIFORM 0x0a
 #define CB_SET_INTEGER_UNIFORM 0x0b
 #define CB_BIND_TEXTURE 0x0c
+#define CB_UPDATE_TEXTURE_BUFFER 0x0d
+#define CB_BIND_TEXTURE_BUFFER 0x0e
+#define CB_SET_DRAW_DATA_BASE 0x0f
+#define CB_DRAW_MESH_BATCH 0x10
 
 #define CB_USE_PROGRAM 0xcc
 
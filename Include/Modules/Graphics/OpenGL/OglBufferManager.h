@@ -0,0 +1,20 @@
+#pragma once
+#include <unordered_map>
+// owns GL buffers created for command buffer buffer ids
+class OglBufferManager {
+public:
+  OglBufferManager() {}
+  ~OglBufferManager();
+  // uploads the data and attaches it to the buffer texture
+  void UpdateTextureBuffer(unsigned int bufferId, int format, const void *data,
+                           unsigned int sizeInBytes);
+  unsigned int GetBufferTextureId(unsigned int bufferId);
+
+private:
+  struct TextureBuffer {
+    unsigned int BufferId = 0;
+    unsigned int TextureId = 0;
+  };
+  TextureBuffer &GetTextureBuffer(unsigned int bufferId);
+  std::unordered_map<unsigned int, TextureBuffer> TextureBuffers;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "Modules/Graphics/ICommandBuffer.h"
+#include "Modules/Graphics/IndirectDraw.h"
 #include <glm/glm.hpp>
 #include <vector>
 class OpenGLRender;
@@ -17,9 +18,18 @@ public:
   virtual void DrawMesh(glm::mat4 &matrix, unsigned int &meshAssetId,
                         unsigned int &shaderId);
   virtual void DrawMesh(glm::mat4 &matrix, glm::mat4 &matrixInv,
-                        unsigned int &meshAssetId, unsigned int &shaderId);
+                        unsigned int &meshAssetId, unsigned int &shaderId,
+                        unsigned int lod = 0);
+  virtual void DrawMeshBatch(const glm::mat4 *matrices,
+                             const glm::mat4 *matricesInv,
+                             const unsigned int *meshAssetIds,
+                             const unsigned int *lods, unsigned int count,
+                             unsigned int shaderId);
 
   virtual void Execute();
+  virtual void Append(ICommandBuffer *buffer);
+
+  virtual int GetUniformHandle(const std::string &name);
 
   virtual void SetMatrix(const std::string &name, unsigned int shaderId,
                          glm::mat4 matrix);
@@ -27,28 +37,45 @@ public:
                         float value);
   virtual void SetVector(const std::string &name, unsigned int shaderId,
                          const glm::vec4 &vector);
-
   virtual void SetTexture(const std::string &name, unsigned int shaderId,
                           unsigned int textureId);
 
+  virtual void SetMatrix(int uniformHandle, unsigned int shaderId,
+                         const glm::mat4 &matrix);
+  virtual void SetFloat(int uniformHandle, unsigned int shaderId, float value);
+  virtual void SetVector(int uniformHandle, unsigned int shaderId,
+                         const glm::vec4 &vector);
+  virtual void SetTexture(int uniformHandle, unsigned int shaderId,
+                          unsigned int textureId);
+
+  virtual void UpdateTextureBuffer(unsigned int bufferId,
+                                   ETextureBufferFormat format,
+                                   const void *data, unsigned int sizeInBytes);
+  virtual void SetTextureBuffer(int uniformHandle, unsigned int shaderId,
+                                unsigned int bufferId);
+
 private:
   void ReadValue(unsigned char &cmd);
+  // binds the texture to the slot assigned to the sampler of the program
+  void BindTextureToSampler(int uniformHandle, int programId,
+                            unsigned int target, unsigned int textureId);
   void AddCommand(const unsigned char &cmd);
   std::vector<unsigned char> Commands;
+  // per draw blocks uploaded to the ring once per execute, draw commands
+  // carry offsets into it
+  std::vector<unsigned char> DrawData;
   unsigned int CommandCount = 0;
   unsigned int CurrentByte = 0;
 
-  virtual void SetMatrixOgl(const std::string &name, int programId,
-                            glm::mat4 matrix);
-  virtual void SetFloatOgl(const std::string &name, int programId, float value);
-  virtual void SetVectorOgl(const std::string &name, int programId,
-                            const glm::vec4 &vector);
+  void SetMatrixOgl(int uniformHandle, unsigned int shaderId,
+                    const glm::mat4 &matrix);
+  void SetFloatOgl(int uniformHandle, unsigned int shaderId, float value);
+  void SetVectorOgl(int uniformHandle, unsigned int shaderId,
+                    const glm::vec4 &vector);
 
-  virtual void SetMatrixOgl(int uniformLocation, glm::mat4 &matrix);
-  virtual void SetFloatOgl(int uniformLocation, float value);
-  virtual void SetVectorOgl(int uniformLocation, const glm::vec4 &vector);
-
-  void UseProgram(int programId);
+  // recording only deals with asset ids, GL objects are resolved on execute
+  void UseShader(unsigned int shaderId);
+  unsigned int ResolveShaderId(unsigned int shaderId);
 
   OpenGLRender *GetContext();
 
@@ -56,6 +83,12 @@ private:
   class TransformComponent *ActiveCameraTransform = nullptr;
   void UpdateCamera();
 
+  // scratch state of batched draws on execute
+  std::vector<unsigned int> BatchMeshIds;
+  std::vector<unsigned int> BatchLods;
+  std::vector<MeshRange> BatchRanges;
+  std::vector<DrawElementsIndirectCommand> BatchCommands;
+
   OpenGLRender *CachedRenderContext = nullptr;
-  int CurrentShaderProgram = 0;
+  unsigned int CurrentShaderId = 0;
 };
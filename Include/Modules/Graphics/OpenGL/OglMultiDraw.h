@@ -0,0 +1,31 @@
+#pragma once
+#include "Modules/Graphics/IndirectDraw.h"
+#include <vector>
+
+// submits indirect draw commands with glMultiDrawElementsIndirect when the
+// context supports GL 4.3, otherwise loops over glDrawElementsBaseVertex
+class OglMultiDraw {
+public:
+  OglMultiDraw() {}
+  ~OglMultiDraw();
+  bool IsSupported();
+  // the instanced draw index attribute is set up by the vao
+  void SetAttributeDivisor(int location, unsigned int divisor);
+  // the batch vao has to be bound, the fallback sets the draw index as a
+  // constant attribute. The index type is GL_UNSIGNED_SHORT or
+  // GL_UNSIGNED_INT.
+  void Draw(const std::vector<DrawElementsIndirectCommand> &commands,
+            unsigned int indexType);
+  // backs the batch block with zeros for draws that aren't batched, a block
+  // without a buffer is undefined even when the shader doesn't read it
+  void BindEmptyBatchData();
+
+private:
+  void Initialize();
+
+  bool Initialized = false;
+  bool Supported = false;
+  unsigned int IndirectBuffer = 0;
+  unsigned int IndirectBufferSize = 0;
+  unsigned int EmptyBatchBuffer = 0;
+};
@@ -1,17 +1,26 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 class IShader;
 class String;
 // handles OpenGL shader compilation, fetches shader program id by shader asset
 // id
 class OglShaderManager {
 public:
+  // per program table of uniform locations indexed by uniform handle
+  typedef std::vector<int> UniformLocationTable;
+
   OglShaderManager();
   int GetShaderProgramId(unsigned int shaderId);
-  void GetUniformId(const std::string &uniformName, int programId,
-                    int &uniformLoc);
+  // uniform handles don't depend on the program, the name is hashed only once
+  // handles can be requested from any recording thread
+  int GetUniformHandle(const std::string &uniformName);
+  UniformLocationTable *GetUniformLocationTable(int programId);
+  int GetUniformLocation(UniformLocationTable *table, int programId,
+                         int uniformHandle);
 
 private:
   int CreateVertexFragmentShaderProgram(IShader *shader);
@@ -20,6 +29,8 @@ private:
   bool DidProgramLink(unsigned int programId, String &errorText);
 
   std::unordered_map<unsigned int, int> AssetIdToShaderProgramId;
-  std::unordered_map<int, std::unordered_map<std::string, int>>
-      UniformLocations;
+  std::unordered_map<std::string, int> UniformHandles;
+  std::vector<std::string> UniformNames;
+  std::mutex UniformHandleMutex;
+  std::unordered_map<int, UniformLocationTable> UniformLocations;
 };
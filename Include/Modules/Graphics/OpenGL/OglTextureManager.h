@@ -1,23 +1,46 @@
 #pragma once
 #include <string>
 #include <unordered_map>
+#include <vector>
+class OglUploadQueue;
+class Texture2D;
 class OglTextureManager {
 public:
   OglTextureManager() {}
-  unsigned int GetTextureIdByAssetId(unsigned int textureAssetId);
-  void LoadTextureToGpu(unsigned int textureAssetId, unsigned int &texture);
-  void GetTextureSlotForShaderProgramByName(const std::string &name,
-                                            int programId, int &textureSlot,
-                                            bool &isNew);
-  void DeleteUnusedResources();                                          
+  // textures which aren't resident yet are requested from the upload queue,
+  // a white placeholder is returned until they arrive
+  unsigned int GetTextureIdByAssetId(unsigned int textureAssetId,
+                                     OglUploadQueue *uploadQueue);
+  // stages the pixels in a pixel buffer and creates the texture, returns the
+  // uploaded bytes
+  unsigned int LoadTextureToGpu(unsigned int textureAssetId);
+  void GetTextureSlotForShaderProgram(int uniformHandle, int programId,
+                                     int &textureSlot, bool &isNew);
+  void DeleteUnusedResources();
 
 private:
+  // copies the data to the staging buffer, returns the pointer to pass to
+  // the upload calls
+  const void *Stage(const void *data, unsigned int sizeInBytes);
+  // uploads the stored mip chain of half float and block textures, block
+  // formats the driver lacks are decoded
+  void UploadMipChain(Texture2D *textureAsset);
+  // rgtc is core since GL 3.0 and bptc since 4.2, s3tc needs the extension
+  bool IsCompressedFormatSupported(unsigned int glFormat);
+  bool HasExtension(const char *name);
+
   typedef std::unordered_map<unsigned int, unsigned int> AssetTextureMapType;
-  typedef std::unordered_map<std::string, int> NameSlotMapType;
-  typedef std::unordered_map<int, NameSlotMapType> TextureSlotMapType;
+  typedef std::unordered_map<int, int> HandleSlotMapType;
+  typedef std::unordered_map<int, HandleSlotMapType> TextureSlotMapType;
   AssetTextureMapType AssetIdToTextureId;
+  unsigned int PlaceholderTexture = 0;
+  unsigned int StagingBuffer = 0;
+  bool CompressedFormatsQueried = false;
+  bool S3tcSupported = false;
+  bool RgtcSupported = false;
+  bool BptcSupported = false;
 
   // get texture slot location
-  // program id -> name -> texture slot
+  // program id -> uniform handle -> texture slot
   TextureSlotMapType TextureSlots;
 };
@@ -0,0 +1,39 @@
+#pragma once
+#include <deque>
+#include <unordered_set>
+
+class VaoMeshManager;
+class OglTextureManager;
+
+// bytes sent to the gpu per frame, a resource bigger than the budget still
+// goes alone so it can't block the queue
+#define UPLOAD_QUEUE_BUDGET (4 * 1024 * 1024)
+
+// resources first needed while executing a frame are queued instead of
+// uploaded in the middle of it. The queue is drained before the frame is
+// presented until the budget is spent, draws of missing meshes are skipped
+// and missing textures sample a placeholder meanwhile.
+class OglUploadQueue {
+public:
+  enum EResourceType { ResourceMesh, ResourceBatchMesh, ResourceTexture };
+
+  // requests of resources already queued are ignored
+  void Request(EResourceType type, unsigned int assetId);
+  void Process(VaoMeshManager *meshManager,
+               OglTextureManager *textureManager);
+  unsigned int GetPendingCount() const {
+    return static_cast<unsigned int>(Pending.size());
+  }
+
+private:
+  struct UploadRequest {
+    EResourceType Type;
+    unsigned int AssetId;
+  };
+  static unsigned long long GetKey(EResourceType type, unsigned int assetId) {
+    return (unsigned long long)type << 32 | assetId;
+  }
+
+  std::deque<UploadRequest> Pending;
+  std::unordered_set<unsigned long long> PendingKeys;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include "Utility/Graphics.h"
+
+// segments the persistent buffer is split into, one per frame in flight
+#define UPLOAD_RING_SEGMENTS 3
+#define UPLOAD_RING_DEFAULT_SIZE (1024 * 1024)
+
+// streams per draw data to a uniform buffer. Uses a persistently mapped
+// buffer when GL 4.4 buffer storage is available, otherwise the buffer is
+// orphaned when full and filled with glBufferSubData.
+class OglUploadRing {
+public:
+  OglUploadRing() {}
+  ~OglUploadRing();
+  // copies the data to the ring and returns its offset in the buffer
+  unsigned int Upload(const void *data, unsigned int size);
+  unsigned int GetBufferId() const { return BufferId; }
+
+private:
+  void Create(unsigned int segmentSize);
+  void Destroy();
+  void NextSegment();
+  unsigned int Align(unsigned int offset) const;
+
+  bool Initialized = false;
+  bool Persistent = false;
+  unsigned int Alignment = 256;
+  unsigned int BufferId = 0;
+  unsigned int SegmentSize = 0;
+  unsigned int Segment = 0;
+  unsigned int Offset = 0;
+  unsigned char *MappedData = nullptr;
+  GLsync Fences[UPLOAD_RING_SEGMENTS] = {};
+};
@@ -6,6 +6,10 @@
 class VaoMeshManager;
 class OglShaderManager;
 class OglTextureManager;
+class OglBufferManager;
+class OglUploadRing;
+class OglUploadQueue;
+class OglMultiDraw;
 class IObject;
 
 class OpenGLRender : public IRenderContext {
@@ -21,11 +25,19 @@ public:
   virtual void SetFramebufferSize(int &width, int &height);
   virtual bool IsWindowCreated();
   virtual void Update();
+  virtual void Present();
+  virtual void PollEvents();
+  virtual void AcquireContext();
+  virtual void ReleaseContext();
   virtual void Cleanup();
 
   VaoMeshManager *GetMeshManager();
   OglShaderManager *GetShaderManager();
   OglTextureManager *GetTextureManager();
+  OglBufferManager *GetBufferManager();
+  OglUploadRing *GetUploadRing();
+  OglUploadQueue *GetUploadQueue();
+  OglMultiDraw *GetMultiDraw();
 
 private:
   struct GLFWwindow *Window;
@@ -37,5 +49,9 @@ private:
   VaoMeshManager *MeshManager = nullptr;
   OglShaderManager *ShaderManager = nullptr;
   OglTextureManager *TextureManager = nullptr;
+  OglBufferManager *BufferManager = nullptr;
+  OglUploadRing *UploadRing = nullptr;
+  OglUploadQueue *UploadQueue = nullptr;
+  OglMultiDraw *MultiDraw = nullptr;
 
 };
@@ -1,15 +1,129 @@
 #pragma once
+#include "Modules/Graphics/IndirectDraw.h"
+#include <glm/glm.hpp>
 #include <unordered_map>
-// finds vao by ogl shader program id and mesh asset id
+#include <unordered_set>
+#include <vector>
+class Mesh;
+// owns the vertex and index buffers of meshes, one set per mesh asset.
+// Attribute locations are fixed for every program, so a single vao per mesh
+// works with any shader.
 class VaoMeshManager {
 public:
+  struct MeshBuffers {
+    unsigned int VaoId = 0;
+    unsigned int VertexBufferId = 0;
+    unsigned int IndexBufferId = 0;
+    unsigned int IndexCount = 0;
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    unsigned int IndexType = 0;
+    unsigned int SizeInBytes = 0;
+    // quantized positions are decoded as position * scale + offset
+    bool QuantizedPositions = false;
+    glm::vec4 PositionScale = glm::vec4(1.f);
+    glm::vec4 PositionOffset = glm::vec4(0.f);
+    // index ranges of the levels of detail, the full mesh comes first
+    std::vector<MeshRange> Lods;
+
+    // clamped to the coarsest level the mesh has
+    const MeshRange &GetLod(unsigned int lod) const {
+      return Lods[lod < Lods.size() ? lod : Lods.size() - 1];
+    }
+  };
+
   VaoMeshManager();
-  void GetVAOForMeshId(int programId, unsigned int meshAssetId,
-                       unsigned int &vaoId, unsigned int &indexCount);
+  // buffers of a resident mesh, otherwise the mesh is requested from the
+  // upload queue and nullptr is returned. Meshes packed in the shared
+  // buffers don't have buffers of their own, see GetPackedMeshRange.
+  const MeshBuffers *GetMeshBuffers(unsigned int meshAssetId,
+                                    class OglUploadQueue *uploadQueue);
+  // uploads the mesh in the vertex format selected by its compression flags,
+  // returns the uploaded bytes
+  unsigned int UploadMesh(unsigned int meshAssetId);
+  // sets the position decoding uniforms of the bound program when they
+  // differ from the mesh, pass nullptr for meshes with float positions
+  void SetPositionDequantization(class OglShaderManager *shaderManager,
+                                 int programId, const MeshBuffers *buffers);
+  // draws a level of detail from the buffers of the mesh
+  void DrawMesh(const MeshBuffers &buffers, unsigned int lod);
   void DeleteUnusedResources();
+  // bytes of vertex and index data uploaded for meshes and batches
+  unsigned int GetMemoryUsage() const { return MemoryUsage; }
+
+  // meshes drawn in batches are packed into one shared vertex and index
+  // buffer. Returns false and requests the mesh when it isn't packed yet.
+  bool GetMeshRange(unsigned int meshAssetId, unsigned int lod,
+                    MeshRange &range, class OglUploadQueue *uploadQueue);
+  // range of a packed mesh without requesting it, renderers that aren't
+  // batched draw packed meshes from the shared buffers too
+  bool GetPackedMeshRange(unsigned int meshAssetId, unsigned int lod,
+                          MeshRange &range) const;
+  // draws a range of the shared buffers outside of a batch
+  void DrawPackedMesh(const MeshRange &range);
+  // the shared buffers have float positions, compressed normals and texture
+  // coordinates, and 16 bit indices. Meshes that opt out of that compression
+  // or have too many vertices are drawn from their own buffers instead.
+  bool IsDrawnSeparately(unsigned int meshAssetId) const {
+    return SeparateMeshes.find(meshAssetId) != SeparateMeshes.end();
+  }
+  // copies the mesh and its lods to the shared buffers, or uploads meshes
+  // drawn separately, returns the uploaded bytes
+  unsigned int PackBatchMesh(unsigned int meshAssetId);
+  // vao over the shared buffers, the draw index attribute is instanced when
+  // multi draw is supported and the index comes from the base instance
+  unsigned int GetBatchVAO(class OglMultiDraw *multiDraw);
+
 private:
-  // [program id -> [mesh id -> vao id]]
-  std::unordered_map<int, std::unordered_map<unsigned int, unsigned int>>
-      VaoMap;
-  std::unordered_map<unsigned int, unsigned int> IndexCountMap;
+  // normals are 2_10_10_10 and texture coordinates two halfs, quantized
+  // positions depend on the mesh bounds so they are kept as floats
+  struct BatchVertex {
+    float x, y, z;
+    unsigned int Normal;
+    unsigned int TexCoord;
+  };
+  bool CanPackMesh(Mesh *mesh) const;
+  void FillBatchVertices(Mesh *mesh, std::vector<BatchVertex> &vertices);
+  void SetBatchVertexAttributes();
+  // interleaves the attributes in the compact layout and sets the pointers
+  void UploadCompactVertices(Mesh *mesh, MeshBuffers &buffers);
+  // grows the buffer keeping its contents, returns the new buffer id
+  unsigned int GrowBuffer(unsigned int target, unsigned int bufferId,
+                          unsigned int usedBytes, unsigned int newBytes);
+  void DeleteMeshBuffers(MeshBuffers &buffers);
+  void DeleteBatchVAO();
+  // full mesh followed by the lods, with the range of every level
+  void GatherLodIndices(Mesh *mesh, std::vector<unsigned int> &indices,
+                        std::vector<MeshRange> &lods);
+
+  // [mesh id -> buffers]
+  std::unordered_map<unsigned int, MeshBuffers> Meshes;
+  // [program id -> mesh whose dequantization is set, nullptr for none]
+  std::unordered_map<int, const MeshBuffers *> ProgramDequantization;
+  unsigned int MemoryUsage = 0;
+
+  struct PackedMesh {
+    unsigned int FirstVertex = 0;
+    unsigned int VertexCount = 0;
+    unsigned int FirstIndex = 0;
+    unsigned int IndexCount = 0;
+    // range of every lod
+    std::vector<MeshRange> Lods;
+  };
+
+  // shared buffers, the ranges of deleted meshes are reused
+  unsigned int BatchVertexBuffer = 0;
+  unsigned int BatchIndexBuffer = 0;
+  unsigned int BatchVertexCapacity = 0;
+  unsigned int BatchIndexCapacity = 0;
+  BatchRangeAllocator BatchVertices;
+  BatchRangeAllocator BatchIndices;
+  // (index, 1) pairs feeding the instanced draw index attribute
+  unsigned int DrawIndexBuffer = 0;
+  // [mesh id -> location in the shared buffers]
+  std::unordered_map<unsigned int, PackedMesh> PackedMeshes;
+  // batched meshes drawn from their buffers in Meshes
+  std::unordered_set<unsigned int> SeparateMeshes;
+  unsigned int BatchVao = 0;
+  // vao over the shared buffers without the draw index attribute
+  unsigned int PackedMeshVao = 0;
 };
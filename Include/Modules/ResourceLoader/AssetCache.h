@@ -0,0 +1,24 @@
+#pragma once
+#include "Common.h"
+
+class IObject;
+
+// bump when the import done in Asset::OnLoad changes, old cooked files are
+// ignored after that
+#define ASSET_IMPORTER_VERSION 1
+#define ASSET_CACHE_DIRECTORY "Cache/"
+
+// cooked copies of imported assets stored as version 2 ssd files. A file is
+// named after a hash of the source file contents and the importer version,
+// so edited sources miss the cache and no index has to be kept.
+namespace AssetCache {
+// hashes the source file, false if it can't be read
+bool GetKey(const String &sourceFileName, unsigned long long &key);
+String GetPath(unsigned long long key);
+// deserializes the cooked asset from a mapping of the cooked file, nullptr
+// on a miss. The asset has no unique id yet.
+IObject *Load(unsigned long long key);
+// writes the attributes of an asset after its import, safe to call from
+// several threads
+bool Save(unsigned long long key, IObject *asset);
+} // namespace AssetCache
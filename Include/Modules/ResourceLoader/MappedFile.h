@@ -0,0 +1,26 @@
+#pragma once
+#include "Common.h"
+#include <stddef.h>
+
+// read only memory mapping of a whole file, views into it stay valid until
+// the mapping is destroyed
+class MappedFile {
+public:
+  MappedFile();
+  ~MappedFile();
+  bool Open(const String &fileName);
+  void Close();
+  const unsigned char *GetData() const { return Data; }
+  size_t GetSize() const { return Size; }
+
+private:
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  const unsigned char *Data = nullptr;
+  size_t Size = 0;
+#if defined _WIN32 || defined _WIN64
+  void *FileHandle = nullptr;
+  void *MappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "Common.h"
+#include <memory>
+#include <vector>
+
+class MappedFile;
+namespace Pack {
+struct Header;
+struct Entry;
+} // namespace Pack
+
+// single file bundle of assets, the layout is described in Pack.h. The
+// archive is mapped, stored entries are read in place and compressed ones
+// are decoded on request.
+class PackArchive {
+public:
+  PackArchive();
+  bool Open(const String &fileName);
+  String GetFileName() { return FileName; }
+  bool Contains(const String &path);
+  // size of the entry once decompressed
+  bool GetSize(const String &path, size_t &size);
+  // owner keeps data valid, it holds the mapping or the decompressed copy.
+  // safe to call from several threads once the archive is open
+  bool Read(const String &path, const unsigned char *&data, size_t &size,
+            std::shared_ptr<void> &owner);
+  String GetLastError() { return LastError; }
+
+  // packs the files under their normalized paths, compressed entries are
+  // only kept when they come out smaller
+  static bool Write(const String &fileName, const std::vector<String> &files,
+                    bool compress, String &error);
+  // forward slashes, no "." segments and ".." folded into the parent
+  static String NormalizePath(const String &path);
+  static unsigned long long HashPath(const String &normalizedPath);
+
+private:
+  const Pack::Entry *FindEntry(const String &path);
+
+  String FileName;
+  String LastError;
+  std::shared_ptr<MappedFile> File;
+  const Pack::Header *Header = nullptr;
+  const Pack::Entry *Entries = nullptr;
+  const char *Paths = nullptr;
+};
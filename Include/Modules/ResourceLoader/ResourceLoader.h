@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <memory>
 #include <vector>
 class String;
 class ISerialized;
@@ -9,12 +11,24 @@ class ResourceLoader {
 public:
   static bool LoadSsd(const String &fileName,
                       std::vector<class IDataNode *> &nodes);
+  // writes the nodes as a version 2 ssd file
+  static bool SaveSsd(const String &fileName,
+                      const std::vector<class IDataNode *> &nodes);
   // static bool LoadScene(const String &fileName);
   static bool LoadAsset(const String &fileName, Asset *&loadedAsset,
                         unsigned int uniqueId = 0);
   static bool LoadText(const String &fileName, String &data);
   static bool LoadBitmap(const String &fileName,
                          IObject *&textureAsset);
+  // size of the file in bytes, 0 if it can't be opened
+  static size_t GetFileSize(const String &fileName);
+  // the data comes from the most recently mounted archive that has the file,
+  // from disk otherwise. owner keeps data valid
+  static bool MapFile(const String &fileName, const unsigned char *&data,
+                      size_t &size, std::shared_ptr<void> &owner);
+  // mounted archives are searched before the file system
+  static bool MountArchive(const String &fileName);
+  static void UnmountArchive(const String &fileName);
   static String GetLastError();
 
 private:
@@ -22,5 +36,9 @@ private:
   static void LoadExternalAssetFromScene(ISerialized *obj,
                                          const String &sceneFileName);
   static void SetupPath(const String &localPath, String &outPath);
+  static bool ReadFromArchive(const String &fileName,
+                              const unsigned char *&data, size_t &size,
+                              std::shared_ptr<void> &owner);
+  static void SetLastError(const String &error);
   static String LastError;
 };
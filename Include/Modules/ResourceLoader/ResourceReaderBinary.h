@@ -1,12 +1,8 @@
 #pragma once
 #include "IResourceReader.h"
 
-namespace SSD {
-struct Header;
-struct Node;
-struct Attribute;
-} // namespace SSD
-
+// reads the whole ssd file into memory with a single read and parses it in
+// place, for platforms without file mapping
 class ResourceReaderBinary : public IResourceReader {
 public:
   ResourceReaderBinary(const String &fileName);
@@ -15,15 +11,8 @@ public:
   virtual void Close();
   virtual void ReadNodes(std::vector<IDataNode *> &nodes);
   virtual String GetLastError() { return LastError; }
-  // virtual
-private:
-  void ReadHeader(SSD::Header &header);
-  void ReadUShort(unsigned short &val);
-  void ReadByte(unsigned char &val);
-  void ReadUInt32(unsigned int &val);
-  SSD::Node *ReadNode();
-  SSD::Attribute *ReadAttribute();
 
+private:
   String FileName;
   String LastError;
   std::ifstream FileStream;
@@ -0,0 +1,23 @@
+#pragma once
+#include "IResourceReader.h"
+#include <memory>
+
+// parses ssd files in place from a memory mapping or a mounted archive,
+// array attributes keep pointing into the data until their consumer decodes
+// them
+class ResourceReaderMapped : public IResourceReader {
+public:
+  ResourceReaderMapped(const String &fileName);
+  virtual ~ResourceReaderMapped();
+  virtual bool Open();
+  virtual void Close();
+  virtual void ReadNodes(std::vector<IDataNode *> &nodes);
+  virtual String GetLastError() { return LastError; }
+
+private:
+  String FileName;
+  String LastError;
+  std::shared_ptr<void> Owner;
+  const unsigned char *Data = nullptr;
+  size_t Size = 0;
+};
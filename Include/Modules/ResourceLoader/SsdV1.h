@@ -0,0 +1,14 @@
+#pragma once
+#include "Common.h"
+#include <memory>
+#include <vector>
+
+class IDataNode;
+
+// parses version 1 ssd files in place, the layout is described in SSD.h
+namespace SsdV1 {
+// array attributes point into data and keep owner alive
+bool ReadNodes(const unsigned char *data, size_t size,
+               const std::shared_ptr<void> &owner,
+               std::vector<IDataNode *> &nodes, String &error);
+} // namespace SsdV1
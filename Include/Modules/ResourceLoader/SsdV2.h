@@ -0,0 +1,19 @@
+#pragma once
+#include "Common.h"
+#include <memory>
+#include <vector>
+
+class IDataNode;
+
+// reads and writes version 2 ssd files, the layout is described in SSD.h
+namespace SsdV2 {
+// array attributes point into data and keep owner alive
+bool ReadNodes(const unsigned char *data, size_t size,
+               const std::shared_ptr<void> &owner,
+               std::vector<IDataNode *> &nodes, String &error);
+// reads one top level node through the node table without parsing the rest
+IDataNode *ReadNode(const unsigned char *data, size_t size, unsigned int index,
+                    const std::shared_ptr<void> &owner, String &error);
+void WriteNodes(const std::vector<IDataNode *> &nodes,
+                std::vector<unsigned char> &data);
+} // namespace SsdV2
@@ -0,0 +1,43 @@
+#pragma once
+#include "IAssetManager.h"
+#include <utility>
+
+// keeps an asset referenced, once the last handle is gone the asset stays
+// cached until the asset manager needs the memory
+class AssetHandle {
+public:
+  AssetHandle() {}
+  explicit AssetHandle(unsigned int assetId) : AssetId(assetId) { Acquire(); }
+  AssetHandle(const AssetHandle &other) : AssetId(other.AssetId) {
+    Acquire();
+  }
+  AssetHandle(AssetHandle &&other) : AssetId(other.AssetId) {
+    other.AssetId = 0;
+  }
+  ~AssetHandle() { Release(); }
+  AssetHandle &operator=(AssetHandle other) {
+    std::swap(AssetId, other.AssetId);
+    return *this;
+  }
+
+  unsigned int Id() const { return AssetId; }
+  bool IsValid() const { return AssetId != 0; }
+  template <class T> T *Get() const {
+    return dynamic_cast<T *>(Statics::Get<IAssetManager>()->GetAsset(AssetId));
+  }
+  void Reset() {
+    Release();
+    AssetId = 0;
+  }
+
+private:
+  void Acquire() {
+    if (AssetId)
+      Statics::Get<IAssetManager>()->AddReference(AssetId);
+  }
+  void Release() {
+    if (AssetId)
+      Statics::Get<IAssetManager>()->ReleaseReference(AssetId);
+  }
+  unsigned int AssetId = 0;
+};
@@ -2,8 +2,15 @@
 #include "Core.h"
 #include "IAssetManager.h"
 #include "Utility/Data/Serialization.h"
+#include <list>
 #include <unordered_map>
 
+// frames an asset stays unreferenced before it counts as cached
+#define ASSET_CACHE_UNUSED_FRAMES 120
+// memory the cached assets may hold before the least recently used go
+#define ASSET_CACHE_CPU_BUDGET_MB 256
+#define ASSET_CACHE_GPU_BUDGET_MB 256
+
 class AssetManager : public IAssetManager, public IObject {
 public:
   SERIALIZE_CLASS(AssetManager);
@@ -11,6 +18,7 @@ public:
 
   virtual ~AssetManager() {}
   virtual void RemoveAssetType(String assetType);
+  virtual IObject *GetAsset(unsigned int assetId);
   virtual IObject *GetAssetByFileName(const String &fileName);
   virtual IObject *GetAssetOfType(const String &typeName,
                                            unsigned int assetId = 0);
@@ -22,9 +30,31 @@ public:
                                      unsigned int assetId);
   virtual unsigned int IsExternalAssetLoaded(const String &fileName);
   virtual void UnloadSceneAssets();
+  virtual void UnloadAssets(const std::vector<unsigned int> &assetIds);
+  virtual void AddReference(unsigned int assetId);
+  virtual void ReleaseReference(unsigned int assetId);
+  virtual unsigned int GetReferenceCount(unsigned int assetId);
+  virtual void SetCacheBudget(size_t cpuBytes, size_t gpuBytes);
+  virtual void Update();
 
 private:
+  struct AssetReferences {
+    unsigned int Count = 0;
+    unsigned int ReleasedFrame = 0;
+    // sizes taken when the last reference went
+    size_t MemoryUsage = 0;
+    size_t GpuMemoryUsage = 0;
+  };
+  void ForgetReferences(unsigned int assetId);
+
   StringMap Assets;
   typedef std::unordered_map<std::string, unsigned int> ExternalPathMap;
   ExternalPathMap ExternalPathToAssetId;
+
+  std::unordered_map<unsigned int, AssetReferences> References;
+  // unreferenced assets, least recently released first
+  std::list<unsigned int> Unreferenced;
+  unsigned int Frame = 0;
+  size_t CacheCpuBudget = (size_t)ASSET_CACHE_CPU_BUDGET_MB << 20;
+  size_t CacheGpuBudget = (size_t)ASSET_CACHE_GPU_BUDGET_MB << 20;
 };
@@ -18,6 +18,7 @@ public:
   virtual unsigned int GetEntityCount();
   virtual unsigned int GetEntityIdAtIndex(unsigned int index);
   virtual void SetPersistentEntity(unsigned int entityId, bool state);
+  virtual bool IsPersistentEntity(unsigned int entityId);
 
 private:
   static EntityManager *Instance;
@@ -20,7 +20,7 @@ private:
   Function DelegateFunction;
 };
 
-enum EventType { OnInitialize, OnSceneLoad };
+enum EventType { OnInitialize, OnSceneLoad, OnSceneUnload };
 class Event {
 public:
   Event() {}
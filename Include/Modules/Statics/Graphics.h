@@ -3,10 +3,18 @@
 #include "Modules/Graphics/ICommandBuffer.h"
 #include "Modules/Graphics/IRenderContext.h"
 #include "Utility/Data/Serialization.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 class IShader;
 class RenderSettings;
 
+// triple buffering at most
+#define MAX_FRAME_LATENCY 2
+
 class Graphics : public IGraphics, public IObject {
 public:
   SERIALIZE_CLASS(Graphics);
@@ -15,12 +23,45 @@ public:
   virtual bool Render();
   virtual IRenderContext *GetContext();
   virtual ICommandBuffer *GetCommandBuffer(CommandBufferType type);
+  virtual ICommandBuffer *GetSecondaryCommandBuffer(unsigned int index);
   virtual void SetDefaultShader(IShader *shader);
   virtual IShader *DefaultShader();
   virtual void SetupWindow();
+  virtual void Flush();
+  virtual void ReleaseUnusedResources();
+  virtual FrameStats &GetFrameStats();
+  virtual unsigned int CreateBufferId();
 
 private:
+  // command buffers recorded for a single frame
+  struct FrameCommandBuffers {
+    ICommandBuffer *Buffers[CommandBufferType::COUNT];
+  };
+
+  void AddFrame();
+  void ExecuteFrame(unsigned int frameIndex);
+  bool IsFrameSubmitted(unsigned int frameIndex);
+  void StartRenderThread();
+  void StopRenderThread();
+  void RenderThreadLoop();
+  // runs the task on the render thread and waits for it to finish
+  void RunOnRenderThread(const std::function<void()> &task);
+
   IShader *defaultShader;
   IRenderContext *RenderContext = nullptr;
-  ICommandBuffer *CommandBuffers[CommandBufferType::COUNT];
+  std::vector<FrameCommandBuffers> Frames;
+  std::vector<ICommandBuffer *> SecondaryCommandBuffers;
+  // the frame the simulation is currently recording into
+  unsigned int RecordingFrame = 0;
+
+  // render thread state, guarded by FrameMutex
+  std::thread RenderThread;
+  std::mutex FrameMutex;
+  std::condition_variable FrameCondition;
+  std::deque<unsigned int> SubmittedFrames;
+  std::function<void()> RenderThreadTask;
+  bool RenderThreadStopping = false;
+
+  FrameStats Stats;
+  unsigned int LastBufferId = 0;
 };
@@ -2,6 +2,7 @@
 #include "Statics.h"
 #include <typeinfo>
 #include <unordered_map>
+#include <vector>
 
 class IAssetManager {
 public:
@@ -10,6 +11,7 @@ public:
 
   virtual ~IAssetManager() {}
   virtual void RemoveAssetType(String assetType) = 0;
+  virtual IObject *GetAsset(unsigned int assetId) = 0;
   virtual IObject *GetAssetByFileName(const String &fileName) = 0;
   virtual IObject *GetAssetOfType(const String &typeName,
                                            unsigned int assetId = 0) = 0;
@@ -20,6 +22,18 @@ public:
   virtual void SaveExternalAssetPath(const std::string &path,
                                      unsigned int assetId) = 0;
   virtual void UnloadSceneAssets() = 0;
+  // unregisters and deletes the given assets whatever their origin
+  virtual void UnloadAssets(const std::vector<unsigned int> &assetIds) = 0;
+
+  // use AssetHandle rather than calling these directly. Assets nobody
+  // references for a while are kept in a cache and only unloaded, least
+  // recently used first, when the cache goes over its budget.
+  virtual void AddReference(unsigned int assetId) = 0;
+  virtual void ReleaseReference(unsigned int assetId) = 0;
+  virtual unsigned int GetReferenceCount(unsigned int assetId) = 0;
+  virtual void SetCacheBudget(size_t cpuBytes, size_t gpuBytes) = 0;
+  // advances the frame counter and evicts cached assets, once per frame
+  virtual void Update() = 0;
   virtual unsigned int IsExternalAssetLoaded(const String &fileName) = 0;
 
   template <class T> T *GetAssetOfType(unsigned int assetId = 0) {
@@ -16,4 +16,5 @@ public:
   virtual unsigned int GetEntityIdAtIndex(unsigned int index) = 0;
   virtual void SetPersistentEntity(unsigned int entityId,
                                    bool state = true) = 0;
+  virtual bool IsPersistentEntity(unsigned int entityId) = 0;
 };
@@ -8,11 +8,28 @@ class ICommandBuffer;
 class IGraphics {
 public:
   enum CommandBufferType { FrameInit = 0, Main = 1, COUNT };
+  // counters of the last recorded frame
+  struct FrameStats {
+    unsigned int VisibleRenderers = 0;
+    unsigned int CulledRenderers = 0;
+  };
   virtual ~IGraphics() {}
   virtual bool Render() = 0;
   virtual IRenderContext *GetContext() = 0;
   virtual ICommandBuffer *GetCommandBuffer(CommandBufferType type) = 0;
+  // secondary buffers are recorded on worker threads, one per job range, and
+  // appended to a primary buffer in index order. Request them on the main
+  // thread before the workers start.
+  virtual ICommandBuffer *GetSecondaryCommandBuffer(unsigned int index) = 0;
   virtual void SetDefaultShader(IShader *shader) = 0;
   virtual IShader *DefaultShader() = 0;
   virtual void SetupWindow() = 0;
+  // blocks until the render thread executed all submitted frames, call it
+  // before destroying assets which might be referenced by recorded commands
+  virtual void Flush() = 0;
+  // deletes GPU resources of unloaded assets on the thread owning the context
+  virtual void ReleaseUnusedResources() = 0;
+  virtual FrameStats &GetFrameStats() = 0;
+  // unique id for buffers updated through the command buffer
+  virtual unsigned int CreateBufferId() = 0;
 };
@@ -0,0 +1,22 @@
+#pragma once
+#include "Statics.h"
+#include <functional>
+
+class IJobSystem {
+public:
+  // a job gets a half open range [begin, end) and the index of the range,
+  // range indices are stable so results can be merged in a fixed order
+  typedef std::function<void(unsigned int begin, unsigned int end,
+                             unsigned int rangeIndex)>
+      RangeJob;
+
+  virtual ~IJobSystem() {}
+  // number of worker threads plus the calling thread
+  virtual unsigned int GetThreadCount() = 0;
+  // how many ranges ParallelFor is going to split the count into
+  virtual unsigned int GetRangeCount(unsigned int count,
+                                     unsigned int minRangeSize) = 0;
+  // splits the work into contiguous ranges and blocks until all are done
+  virtual void ParallelFor(unsigned int count, unsigned int minRangeSize,
+                           const RangeJob &job) = 0;
+};
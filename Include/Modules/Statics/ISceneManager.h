@@ -1,14 +1,54 @@
 #pragma once
 #include "Statics.h"
+#include "Utility/Typedefs.h"
+#include <cstddef>
 #include <map>
+#include <memory>
 class IScene;
 
+// handle of a scene loaded with LoadSceneAsync
+class ISceneLoadOperation {
+public:
+  virtual ~ISceneLoadOperation() {}
+  virtual String GetFileName() = 0;
+  // 0 to 1, reaches 1 once the scene is swapped in or the load failed
+  virtual float GetProgress() = 0;
+  virtual bool IsDone() = 0;
+  virtual bool Failed() = 0;
+};
+
 class ISceneManager {
 public:
+  // single unloads every loaded scene on the swap, additive keeps them
+  enum LoadMode { Single, Additive };
+
   virtual ~ISceneManager() {}
-  virtual bool LoadScene(const String &fileName) = 0;
+  virtual bool LoadScene(const String &fileName,
+                         LoadMode mode = LoadMode::Single) = 0;
+  // parses and deserializes on a background thread and registers the
+  // external assets a slice per frame, the current scene stays live until
+  // the new one is swapped in
+  virtual std::shared_ptr<ISceneLoadOperation>
+  LoadSceneAsync(const String &fileName, LoadMode mode = LoadMode::Single) = 0;
+  // destroys the entities and assets of one loaded scene, external assets
+  // go to the asset cache once no loaded scene uses them
+  virtual bool UnloadScene(const String &fileName) = 0;
+  virtual bool IsSceneLoaded(const String &fileName) = 0;
+  // advances asynchronous loads, called once per frame
+  virtual void Update() = 0;
   virtual void SetCurrentScene(const String &fileName) = 0;
   virtual String GetCurrentSceneFileName() = 0;
   virtual String
   GetExternalAssetPathRelativeToTheSceneFile(const String &assetFileName) = 0;
+
+  // streaming cells are sub-scenes loaded additively once the viewer is
+  // within their radius and unloaded once it leaves it
+  virtual void AddStreamingCell(const String &fileName,
+                                const glm::vec3 &center, float radius) = 0;
+  virtual void RemoveStreamingCell(const String &fileName) = 0;
+  // bytes of scene and external asset files the loaded scenes hold,
+  // streaming doesn't load past it, 0 means no limit
+  virtual void SetStreamingMemoryBudget(size_t bytes) = 0;
+  virtual size_t GetMemoryUsage() = 0;
+  virtual void UpdateStreaming(const glm::vec3 &viewerPosition) = 0;
 };
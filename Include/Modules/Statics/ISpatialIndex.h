@@ -0,0 +1,38 @@
+#pragma once
+#include "Modules/Utility/CullingUtils.h"
+#include "Statics.h"
+#include <vector>
+
+#define SPATIAL_PROXY_NONE -1
+#define SPATIAL_PROXY_RENDERER 0x01
+#define SPATIAL_PROXY_LIGHT 0x02
+#define SPATIAL_PROXY_ALL 0xff
+
+// world space acceleration structure over renderer and light bounds
+class ISpatialIndex {
+public:
+  virtual ~ISpatialIndex() {}
+  // returns the proxy id which has to be kept by the owner of the bounds
+  virtual int CreateProxy(const BoundingBox &box, unsigned int entityId,
+                          unsigned char typeMask) = 0;
+  // proxy without bounds, frustum and box queries always return it and ray
+  // casts never hit it
+  virtual int CreateUnboundedProxy(unsigned int entityId,
+                                   unsigned char typeMask) = 0;
+  virtual void DestroyProxy(int proxyId) = 0;
+  // returns true if the proxy had to be reinserted
+  virtual bool MoveProxy(int proxyId, const BoundingBox &box) = 0;
+  virtual void Clear() = 0;
+  virtual unsigned int GetProxyCount(unsigned char typeMask) = 0;
+
+  // queries append entity ids of proxies matching the type mask
+  virtual void QueryFrustum(const CullingUtils::Frustum &frustum,
+                            unsigned char typeMask,
+                            std::vector<unsigned int> &entityIds) = 0;
+  virtual void QueryBox(const BoundingBox &box, unsigned char typeMask,
+                        std::vector<unsigned int> &entityIds) = 0;
+  // closest proxy bounds hit by the ray, direction has to be normalized
+  virtual bool RayCast(const glm::vec3 &origin, const glm::vec3 &direction,
+                       float maxDistance, unsigned char typeMask,
+                       unsigned int &entityId, float &distance) = 0;
+};
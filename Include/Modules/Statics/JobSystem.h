@@ -0,0 +1,31 @@
+#pragma once
+#include "IJobSystem.h"
+#include "Utility/Data/Serialization.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem : public IJobSystem, public IObject {
+public:
+  SERIALIZE_CLASS(JobSystem);
+  JobSystem();
+  virtual ~JobSystem();
+  virtual unsigned int GetThreadCount();
+  virtual unsigned int GetRangeCount(unsigned int count,
+                                     unsigned int minRangeSize);
+  virtual void ParallelFor(unsigned int count, unsigned int minRangeSize,
+                           const RangeJob &job);
+
+private:
+  void WorkerLoop();
+  // runs one queued task on the calling thread, false if the queue is empty
+  bool RunPendingTask();
+
+  std::vector<std::thread> Workers;
+  std::deque<std::function<void()>> Tasks;
+  std::mutex TaskMutex;
+  std::condition_variable TaskCondition;
+  bool ShuttingDown = false;
+};
@@ -1,25 +1,157 @@
 #pragma once
+#include "AssetHandle.h"
 #include "ISceneManager.h"
 #include "Utility/Data/Serialization.h"
+#include <atomic>
+#include <deque>
 #include <map>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// threads reading the external assets of a scene
+#define SCENE_LOADER_MAX_THREADS 4
+// main thread time spent registering loaded assets per frame
+#define SCENE_INSTANTIATE_BUDGET_MS 2.0
+// default memory budget of the streamed scenes
+#define SCENE_STREAMING_BUDGET_MB 512
+// cells unload a bit further than they load so they don't flicker at the
+// border
+#define SCENE_STREAMING_UNLOAD_FACTOR 1.25f
+
+class IDataNode;
 
 class SceneManager : public ISceneManager, public IObject {
 public:
   SERIALIZE_CLASS(SceneManager);
   SceneManager();
-  virtual ~SceneManager() {}
-  virtual bool LoadScene(const String &fileName);
+  virtual ~SceneManager();
+  virtual bool LoadScene(const String &fileName, LoadMode mode);
+  virtual std::shared_ptr<ISceneLoadOperation>
+  LoadSceneAsync(const String &fileName, LoadMode mode);
+  virtual bool UnloadScene(const String &fileName);
+  virtual bool IsSceneLoaded(const String &fileName);
+  virtual void Update();
   virtual void SetCurrentScene(const String &fileName);
   virtual String GetCurrentSceneFileName();
   String
   GetExternalAssetPathRelativeToTheSceneFile(const String &assetFileName);
-
-private:
-  bool UnloadCurrentScene();
-  void LoadExternalAssetFromScene(ISerialized *obj, const String &sceneFileName,
-                                  class UniqueIdSetter *uidSetter);
-  String
+  // external asset paths are relative to the directory of the scene file,
+  // tools reading scenes offline resolve them here too
+  static String
   GetExternalAssetPathRelativeToTheSceneFile(const String &assetFileName,
                                              const String &sceneFileName);
+
+  virtual void AddStreamingCell(const String &fileName,
+                                const glm::vec3 &center, float radius);
+  virtual void RemoveStreamingCell(const String &fileName);
+  virtual void SetStreamingMemoryBudget(size_t bytes);
+  virtual size_t GetMemoryUsage();
+  virtual void UpdateStreaming(const glm::vec3 &viewerPosition);
+
+private:
+  struct ExternalAssetLoad {
+    String FileName;
+    unsigned int UniqueId = 0;
+    IObject *Object = nullptr;
+    size_t FileSize = 0;
+  };
+
+  // what a loaded scene brought in, so it can be unloaded on its own
+  struct LoadedScene {
+    String FileName;
+    size_t FileSize = 0;
+    std::vector<unsigned int> EntityIds;
+    std::vector<unsigned int> AssetIds;
+    std::vector<unsigned int> ExternalAssetIds;
+  };
+
+  // external assets are shared between scenes, the handle keeps them out
+  // of the asset cache while any loaded scene uses them
+  struct ExternalAssetUse {
+    unsigned int Users = 0;
+    size_t FileSize = 0;
+    AssetHandle Handle;
+  };
+
+  struct StreamingCell {
+    String FileName;
+    glm::vec3 Center;
+    float Radius = 0.f;
+    // file size until the cell has been loaded once
+    size_t EstimatedSize = 0;
+  };
+
+  enum SceneLoadStage {
+    // background
+    Parsing,
+    // main thread, checks which external assets are already loaded
+    Resolving,
+    // background
+    Deserializing,
+    // main thread, registers external assets within the frame budget
+    Instantiating,
+    // main thread, unloads the current scene and registers the new one
+    Swapping,
+    Done,
+    Failed
+  };
+
+  class SceneLoad : public ISceneLoadOperation {
+  public:
+    SceneLoad(const String &fileName, LoadMode mode)
+        : FileName(fileName), Mode(mode) {}
+    virtual ~SceneLoad();
+    virtual String GetFileName() { return FileName; }
+    virtual float GetProgress();
+    virtual bool IsDone() {
+      return Stage == Done || Stage == SceneLoadStage::Failed;
+    }
+    virtual bool Failed() { return Stage == SceneLoadStage::Failed; }
+
+    String FileName;
+    LoadMode Mode;
+    SceneLoadStage Stage = Parsing;
+    bool StageSucceeded = true;
+    std::thread Worker;
+    std::atomic<bool> WorkerDone{false};
+
+    std::vector<IDataNode *> Nodes;
+    size_t FileSize = 0;
+    class UniqueIdSetter *UidSetter = nullptr;
+    std::vector<IObject *> SceneObjects;
+    std::vector<ExternalAssetLoad> ExternalAssets;
+    std::atomic<unsigned int> ExternalAssetsRead{0};
+    unsigned int ExternalAssetsRegistered = 0;
+    // external assets the scene uses, counted as soon as they're known so
+    // the swap can't release them
+    std::vector<unsigned int> ExternalAssetIds;
+  };
+
+  void UnloadAllScenes();
+  LoadedScene *FindLoadedScene(const String &fileName);
+  std::shared_ptr<SceneLoad> FindPendingLoad(const String &fileName);
+  void UseExternalAsset(SceneLoad &load, unsigned int assetId,
+                        size_t fileSize);
+  void ReleaseExternalAssets(const std::vector<unsigned int> &assetIds);
+  size_t GetSceneMemoryUsage(const LoadedScene &scene);
+  // advances the load by at most one stage, blocking runs the background
+  // stages on the calling thread and ignores the budget
+  void StepSceneLoad(SceneLoad &load, bool blocking);
+  // true once the stage has run, either on the worker or inline
+  bool RunStage(SceneLoad &load, void (SceneManager::*stage)(SceneLoad &),
+                bool blocking);
+  void ParseScene(SceneLoad &load);
+  void ResolveExternalAssets(SceneLoad &load);
+  void DeserializeScene(SceneLoad &load);
+  bool InstantiateExternalAssets(SceneLoad &load, bool blocking);
+  void SwapScene(SceneLoad &load);
+  static IObject *ReadExternalAsset(const ExternalAssetLoad &load,
+                                    class UniqueIdSetter *uidSetter);
   String CurrentSceneFileName = "";
+  std::deque<std::shared_ptr<SceneLoad>> PendingLoads;
+  std::vector<LoadedScene> LoadedScenes;
+  std::unordered_map<unsigned int, ExternalAssetUse> ExternalAssetUsers;
+  std::vector<StreamingCell> StreamingCells;
+  size_t StreamingMemoryBudget = (size_t)SCENE_STREAMING_BUDGET_MB << 20;
 };
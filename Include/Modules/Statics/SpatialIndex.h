@@ -0,0 +1,75 @@
+#pragma once
+#include "ISpatialIndex.h"
+#include "Utility/Data/Serialization.h"
+
+// dynamic AABB tree, leaves store fattened boxes so small movements don't
+// need a reinsert
+class SpatialIndex : public ISpatialIndex, public IObject {
+public:
+  SERIALIZE_CLASS(SpatialIndex);
+  SpatialIndex();
+  virtual ~SpatialIndex() {}
+  virtual int CreateProxy(const BoundingBox &box, unsigned int entityId,
+                          unsigned char typeMask);
+  virtual int CreateUnboundedProxy(unsigned int entityId,
+                                   unsigned char typeMask);
+  virtual void DestroyProxy(int proxyId);
+  virtual bool MoveProxy(int proxyId, const BoundingBox &box);
+  virtual void Clear();
+  virtual unsigned int GetProxyCount(unsigned char typeMask);
+
+  virtual void QueryFrustum(const CullingUtils::Frustum &frustum,
+                            unsigned char typeMask,
+                            std::vector<unsigned int> &entityIds);
+  virtual void QueryBox(const BoundingBox &box, unsigned char typeMask,
+                        std::vector<unsigned int> &entityIds);
+  virtual bool RayCast(const glm::vec3 &origin, const glm::vec3 &direction,
+                       float maxDistance, unsigned char typeMask,
+                       unsigned int &entityId, float &distance);
+
+private:
+  struct TreeNode {
+    glm::vec3 Min;
+    glm::vec3 Max;
+    // bounds of the proxy before the margin, leaves only
+    glm::vec3 BoundsMin;
+    glm::vec3 BoundsMax;
+    // parent for nodes in the tree, next free node otherwise
+    int Parent = SPATIAL_PROXY_NONE;
+    int Child1 = SPATIAL_PROXY_NONE;
+    int Child2 = SPATIAL_PROXY_NONE;
+    // leaf = 0, free node = -1
+    int Height = -1;
+    unsigned int EntityId = 0;
+    // union of the children masks for internal nodes
+    unsigned char TypeMask = 0;
+    // unbounded proxies are kept out of the tree
+    bool Unbounded = false;
+    bool IsLeaf() const { return Child1 == SPATIAL_PROXY_NONE; }
+  };
+
+  int AllocateNode();
+  void FreeNode(int nodeId);
+  void InsertLeaf(int leafId);
+  void RemoveLeaf(int leafId);
+  int Balance(int nodeId);
+  // refits boxes, heights and masks from the node to the root
+  void Refit(int nodeId);
+  void AppendLeaves(int nodeId, unsigned char typeMask,
+                    std::vector<unsigned int> &entityIds);
+  void AppendUnboundedProxies(unsigned char typeMask,
+                              std::vector<unsigned int> &entityIds);
+  void CountProxy(unsigned char typeMask, int count);
+
+  std::vector<TreeNode> Nodes;
+  int Root = SPATIAL_PROXY_NONE;
+  std::vector<int> UnboundedProxies;
+  int FreeList = SPATIAL_PROXY_NONE;
+  unsigned int ProxyCounts[8];
+
+  // scratch data of the frustum query
+  std::vector<int> Stack;
+  std::vector<int> CandidateLeaves;
+  CullingUtils::BoxSoA CandidateBoxes;
+  std::vector<unsigned char> CandidateVisibility;
+};
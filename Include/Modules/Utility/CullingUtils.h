@@ -0,0 +1,26 @@
+#pragma once
+#include "Utility/Bounds.h"
+#include <vector>
+
+namespace CullingUtils {
+// planes point inwards, xyz is the normal and w the distance
+struct Frustum {
+  glm::vec4 Planes[6];
+};
+
+// boxes laid out per component so four of them can be tested at once
+struct BoxSoA {
+  std::vector<float> CenterX, CenterY, CenterZ;
+  std::vector<float> ExtentX, ExtentY, ExtentZ;
+
+  void Clear();
+  void Add(const BoundingBox &box);
+  unsigned int Count() const;
+};
+
+Frustum ExtractFrustum(const glm::mat4 &viewProjection);
+// sets visible[i] to 1 if the box intersects the frustum, returns the amount
+// of visible boxes
+unsigned int CullBoxes(const Frustum &frustum, const BoxSoA &boxes,
+                       std::vector<unsigned char> &visible);
+} // namespace CullingUtils
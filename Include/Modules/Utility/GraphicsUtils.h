@@ -1,11 +1,17 @@
 #pragma once
 #include "Modules/Graphics/IShader.h"
 class ICommandBuffer;
+class Material;
 class String;
 
 namespace GraphicsUtils {
+Material *GetMaterial(unsigned int materialId);
 void SetUniformsFromMaterial(ICommandBuffer *buffer, unsigned int materialId,
                              unsigned int &shaderId);
+// doesn't touch the asset manager, safe to call from recording threads once
+// the material handles were bound
+void SetUniformsFromMaterial(ICommandBuffer *buffer, Material *material,
+                             unsigned int &shaderId);
 IShader *CreateVertexFragmentShader(const String &vertexFileName,
                                     const String &fragmentFileName);
 } // namespace GraphicsUtils
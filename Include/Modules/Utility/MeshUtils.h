@@ -0,0 +1,53 @@
+#pragma once
+#include "Utility/Typedefs.h"
+#include <vector>
+
+class Mesh;
+
+// post transform cache size assumed by the optimization and the report
+#define VERTEX_CACHE_SIZE 16
+// meshes with fewer triangles keep a single level of detail
+#define MIN_LOD_TRIANGLES 256
+
+namespace MeshUtils {
+// average cache miss ratio per triangle and per vertex, lower is better
+struct OptimizationReport {
+  unsigned int VerticesBefore = 0;
+  unsigned int VerticesAfter = 0;
+  float AcmrBefore = 0.f;
+  float AcmrAfter = 0.f;
+  float AtvrBefore = 0.f;
+  float AtvrAfter = 0.f;
+};
+
+// merges vertices with identical attributes, returns the new vertex count
+unsigned int WeldVertices(Mesh *mesh);
+// Tipsify triangle reordering for a fifo post transform cache
+void OptimizeVertexCache(std::vector<unsigned int> &indices,
+                         unsigned int vertexCount,
+                         unsigned int cacheSize = VERTEX_CACHE_SIZE);
+// orders vertices by first use so fetches walk the buffer linearly
+void OptimizeVertexFetch(Mesh *mesh);
+
+// cache misses per triangle of a simulated fifo cache
+float CalculateAcmr(const std::vector<unsigned int> &indices,
+                    unsigned int cacheSize = VERTEX_CACHE_SIZE);
+// cache misses per vertex, 1 is optimal
+float CalculateAtvr(const std::vector<unsigned int> &indices,
+                    unsigned int vertexCount,
+                    unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+// runs all passes, the mesh keeps its shape. Existing lods are dropped
+// since the vertices move.
+void Optimize(Mesh *mesh, OptimizationReport &report);
+
+// quadric error edge collapse towards the target index count. Vertices only
+// collapse onto other vertices, so the result indexes the same vertex
+// buffer. Returns the largest error of a collapse in object space units.
+float Simplify(const std::vector<glm::vec3> &positions,
+               const std::vector<unsigned int> &indices,
+               unsigned int targetIndexCount,
+               std::vector<unsigned int> &result);
+// fills the lod attributes of the mesh, every level halves the triangles
+void GenerateLods(Mesh *mesh);
+} // namespace MeshUtils
@@ -0,0 +1,29 @@
+#pragma once
+#include "Engine/AssetTypes/Texture2D.h"
+#include <vector>
+
+namespace TextureUtils {
+// levels down to 1x1
+unsigned int GetMipCount(unsigned int width, unsigned int height);
+// bytes of a single level, block formats round up to whole 4x4 blocks
+unsigned int GetLevelSize(Texture2D::TextureFormat format, unsigned int width,
+                          unsigned int height);
+bool IsBlockFormat(Texture2D::TextureFormat format);
+
+// box filters the raw pixels into a full mip chain and converts it to the
+// target format, the import step of textures which are still raw
+void Import(Texture2D *texture, Texture2D::TextureFormat targetFormat);
+
+// block encoders, 16 rgba texels in row order go in
+void EncodeBC1(const unsigned char *texels, unsigned char *block);
+void EncodeBC3(const unsigned char *texels, unsigned char *block);
+void EncodeBC5(const unsigned char *texels, unsigned char *block);
+// mode 6 only, a single subset with rgba endpoints
+void EncodeBC7(const unsigned char *texels, unsigned char *block);
+
+// decodes a level to rgba bytes for drivers lacking the block format, BC7
+// blocks other than mode 6 decode to black
+void DecodeLevel(Texture2D::TextureFormat format, const unsigned char *data,
+                 unsigned int width, unsigned int height,
+                 std::vector<unsigned char> &pixels);
+} // namespace TextureUtils
@@ -1,8 +1,13 @@
+#include "Engine/AssetTypes/Settings/RenderSettings.h"
+#include "Modules/Graphics/LightClusterGrid.h"
+#include "Modules/Utility/CullingUtils.h"
 #include "System.h"
 #include "Utility/Data/Serialization.h"
+#include <glm/glm.hpp>
 #include <vector>
 
 class IRenderContext;
+template <class T> class ComponentMap;
 class ICommandBuffer;
 class RenderingSystem : public System, public IObject {
 public:
@@ -17,15 +22,105 @@ private:
   void DrawSkyBox();
   void DrawOpaqueMeshes();
 
-  void SetLightParameters(unsigned int shaderId);
+  void UpdateLightParameters();
+  void UpdateLightClusters();
+  void AssignObjectLights(unsigned int begin, unsigned int end);
+  void SetLightParameters(ICommandBuffer *buffer, unsigned int shaderId,
+                          unsigned int rendererIndex);
+  void DrawRenderers(ICommandBuffer *buffer, unsigned int begin,
+                     unsigned int end);
+  // moves static renderers to the end, returns the count of the others
+  unsigned int PartitionStaticRenderers();
+  void DrawStaticBatches(unsigned int begin);
+  // picks the level of detail from the projected size of the bounds
+  void SelectLod(class RendererComponent *renderer);
+  void CullRenderers(
+      ComponentMap<class TransformComponent> *transformComponents,
+      ComponentMap<class RendererComponent> *rendererComponents);
   // private helper methods
   ICommandBuffer *ActiveCommandBuffer = nullptr;
-  
-#define MAX_LIGHTS 4
 
-  unsigned char LightsFound = 0;
-  class LightComponent *LightComponents[MAX_LIGHTS] = {nullptr, nullptr,
-                                                       nullptr, nullptr};
+// smallest amount of renderers worth recording on a separate thread
+#define MIN_RENDERERS_PER_JOB 64
+// lights a renderer gets when lights are assigned per object
+#define MAX_OBJECT_LIGHTS 4
+// a coarser lod is taken once the renderer is this much below its
+// threshold, keeps objects near a threshold from switching every frame
+#define LOD_HYSTERESIS 0.2f
+
+  std::vector<class LightComponent *> LightComponents;
   class LightComponent *CachedDirectionalLight = nullptr;
   class SkyLightComponent *CachedSkyLight = nullptr;
+
+  // uniform handles of the lighting uniforms, resolved once on initialize
+  int DirectionalLightColorHandle = -1;
+  int DirectionalLightDirectionHandle = -1;
+  int LightDataHandle = -1;
+  int ClusterRangesHandle = -1;
+  int LightIndicesHandle = -1;
+  int ClusterParamsHandle = -1;
+  int ClusterScreenHandle = -1;
+
+  // light values are gathered once per frame and uploaded as a texture
+  // buffer, the layout matches the Light struct of the lighting shader
+  struct LightUniformValues {
+    glm::vec4 Position;
+    glm::vec4 Direction;
+    glm::vec4 Color;
+    glm::vec4 Params0;
+    glm::vec4 Params1;
+  };
+  std::vector<LightUniformValues> LightValues;
+  // world position and attenuation radius of each light
+  std::vector<glm::vec4> LightSpheres;
+  glm::vec4 DirectionalLightColor;
+  glm::vec4 DirectionalLightDirection;
+  unsigned char LightAssignment = LIGHT_ASSIGNMENT_CLUSTERED;
+  // camera position and framebuffer height over the tangent of half the fov
+  glm::vec3 LodCameraPosition;
+  float LodPixelScale = 0.f;
+  float LodPixelError = 1.f;
+
+  // lights binned into view space clusters, uploaded every frame
+  LightClusterGrid ClusterGrid;
+  std::vector<LightClusterGrid::ClusterLight> ClusterLights;
+  unsigned int LightDataBufferId = 0;
+  unsigned int ClusterRangesBufferId = 0;
+  unsigned int LightIndicesBufferId = 0;
+  // tiles x, tiles y, slice scale, slice bias
+  glm::vec4 ClusterParams;
+  // framebuffer width, height, slice count
+  glm::vec4 ClusterScreen;
+  int ObjectLightsHandle = -1;
+  int ObjectLightCountHandle = -1;
+
+  // indices into the light data of the most important lights of each
+  // visible renderer, unused slots are -1
+  struct ObjectLightList {
+    glm::vec4 Indices;
+    float Count;
+  };
+  std::vector<ObjectLightList> ObjectLights;
+  // candidates for the per object assignment, lights touching the frustum
+  std::vector<unsigned int> VisibleLightIds;
+  std::vector<unsigned int> VisibleLightIndices;
+
+  // entities of the renderers returned by the spatial index
+  std::vector<unsigned int> VisibleEntityIds;
+
+  // renderers and their materials resolved on the main thread
+  std::vector<class RendererComponent *> VisibleRenderers;
+  std::vector<class TransformComponent *> VisibleTransforms;
+  std::vector<class Material *> VisibleMaterials;
+
+  // scratch of the partition, swapped with the visible lists
+  std::vector<class RendererComponent *> PartitionedRenderers;
+  std::vector<class TransformComponent *> PartitionedTransforms;
+  std::vector<class Material *> PartitionedMaterials;
+  // static renderers sorted by material and mesh, and the batch being built
+  std::vector<unsigned int> StaticRendererIndices;
+  std::vector<glm::mat4> BatchMatrices;
+  std::vector<glm::mat4> BatchMatricesInv;
+  std::vector<unsigned int> BatchMeshIds;
+  std::vector<unsigned int> BatchLods;
 };
@@ -0,0 +1,13 @@
+#pragma once
+#include "System.h"
+#include "Utility/Data/Serialization.h"
+
+// loads and unloads the streaming cells around the active camera
+class SceneStreamingSystem : public System, public IObject {
+public:
+  SERIALIZE_CLASS(SceneStreamingSystem);
+  SceneStreamingSystem(){};
+  virtual ~SceneStreamingSystem(){};
+  virtual bool Initialize();
+  virtual bool Update();
+};
@@ -7,6 +7,8 @@
 
 class IComponent;
 class TransformComponent;
+class RendererComponent;
+class LightComponent;
 template <class T> class ComponentMap;
 class TransformSystem : public System, public IObject {
 public:
@@ -24,5 +26,9 @@ private:
                              std::unordered_map<unsigned int, IComponent *>>
       StringMap;
   void CalculateWorldTransforms(bool ignoreStatic);
+  void UpdateRendererBounds(TransformComponent *transform,
+                            RendererComponent *renderer);
+  void UpdateLightBounds(TransformComponent *transform, LightComponent *light);
+  void ResetSpatialIndex();
   ComponentMap<TransformComponent> *TransformComponentMap;
 };
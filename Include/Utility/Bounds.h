@@ -0,0 +1,25 @@
+#pragma once
+#include "Utility/Typedefs.h"
+#include <vector>
+
+// axis aligned box stored as center and half size
+struct BoundingBox {
+  glm::vec3 Center = glm::vec3(0);
+  glm::vec3 Extents = glm::vec3(0);
+
+  static BoundingBox FromMinMax(const glm::vec3 &min, const glm::vec3 &max);
+  glm::vec3 GetMin() const { return Center - Extents; }
+  glm::vec3 GetMax() const { return Center + Extents; }
+  // box enclosing this box transformed by the matrix
+  BoundingBox Transform(const glm::mat4 &matrix) const;
+};
+
+// xyz is the center, w is the radius
+typedef glm::vec4 BoundingSphere;
+
+namespace BoundsUtils {
+void Calculate(const std::vector<glm::vec3> &points, BoundingBox &box,
+               BoundingSphere &sphere);
+BoundingSphere TransformSphere(const BoundingSphere &sphere,
+                               const glm::mat4 &matrix);
+} // namespace BoundsUtils
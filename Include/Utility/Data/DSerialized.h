@@ -79,7 +79,7 @@ class ISerialized;
 #define ATTRIBUTE_ID_VECTOR(NAME)                                              \
   std::vector<unsigned int> NAME;                                              \
   void Attrib_Set_##NAME(ISerialized *&attr) {                                 \
-    NAME = ((TypedAttribute<unsigned int> *)attr)->Get();                      \
+    NAME = ((TypedAttribute<unsigned int> *)attr)->Take();                     \
   }                                                                            \
   void Attrib_Get_##NAME(ISerialized *&attr) {                                 \
     attr = new TypedAttribute<unsigned int>(#NAME, "uid", NAME);               \
@@ -100,7 +100,7 @@ class ISerialized;
     TypedAttribute<TYPE_NAME> *typedAttr = (TypedAttribute<TYPE_NAME> *)attr;  \
     if (!typedAttr)                                                            \
       return;                                                                  \
-    NAME = typedAttr->Get();                                                   \
+    NAME = typedAttr->Take();                                                  \
   }                                                                            \
   void Attrib_Get_##NAME(ISerialized *&attr) {                                 \
     attr = new TypedAttribute<TYPE_NAME>(#NAME, #TYPE_NAME, NAME);             \
@@ -115,13 +115,21 @@ class ISerialized;
 
 #define ATTRIBUTE_GLM_VEC3_ARRAY(NAME)                                         \
   std::vector<glm::vec3> NAME;                                                 \
-  ___GET_ATTR_VEC_BOY(NAME)                                                    \
-  NAME = std::vector<glm::vec3>();                                             \
-  float vectorSize = raw.size() / 3;                                           \
-  for (unsigned int x = 0; x < vectorSize; x++) {                              \
-    unsigned int index = x * 3;                                                \
-    NAME.push_back(glm::vec3(raw[index + 0], raw[index + 1], raw[index + 2])); \
-  }                                                                            \
+  void Attrib_Set_##NAME(ISerialized *&attr) {                                 \
+    TypedAttribute<float> *typedAttr = (TypedAttribute<float> *)attr;          \
+    if (!typedAttr)                                                            \
+      return;                                                                  \
+    NAME = std::vector<glm::vec3>(typedAttr->Size() / 3);                      \
+    if (NAME.empty())                                                          \
+      return;                                                                  \
+    /* decoded straight from the file into the vector */                       \
+    if (NAME.size() * 3 == typedAttr->Size()) {                                \
+      typedAttr->CopyTo(&NAME[0].x);                                           \
+      return;                                                                  \
+    }                                                                          \
+    std::vector<float> raw = typedAttr->Take();                                \
+    for (unsigned int x = 0; x < NAME.size(); x++)                             \
+      NAME[x] = glm::vec3(raw[x * 3 + 0], raw[x * 3 + 1], raw[x * 3 + 2]);     \
   }                                                                            \
   void Attrib_Get_##NAME(ISerialized *&attr) {                                 \
     std::vector<float> outVec;                                                 \
@@ -1,12 +1,13 @@
 #pragma once
 #include "IDataNode.h"
-
-namespace SSD { struct Node; struct Attribute; }
+#include <memory>
 
 class DataNode : public IDataNode 
 {
 public:
-    DataNode(SSD::Node* node);
+    DataNode(const String &name, unsigned int uniqueID,
+             std::vector<ISerialized*> &attributes,
+             std::vector<IDataNode*> &nodes);
     virtual ~DataNode();
     virtual String Name();
     virtual std::vector<ISerialized*> GetAttributes();
@@ -16,8 +17,15 @@ public:
     virtual void SetUniqueID(const unsigned int &newID);
 
     static void GetStride(const String &typeName, unsigned char &stride);
+    // with an owner array values keep pointing at the bytes in the file until
+    // the attribute is released, without one they are decoded right away
+    // v1 integers are big endian, v2 payloads are in host order
+    static ISerialized* MakeValueAttribute(
+        const String &name, const String &typeName, bool isSingleElement,
+        const unsigned char *values, unsigned int byteCount,
+        unsigned int elementCount, const std::shared_ptr<void> &owner,
+        bool bigEndian = true);
 private:
-    ISerialized* MakeTypedAttribute(SSD::Attribute* attribute);
     String NodeName;
     std::vector<ISerialized*> Attributes;
     std::vector<IDataNode*> Nodes;
@@ -1,8 +1,18 @@
 #pragma once
+#include <stddef.h>
 class String;
 namespace DataStruct
 {
+// attribute value types, resolved from the type name once per attribute
+enum DataType { Unknown, Char, UChar, Short, UShort, Int, UInt, Float };
+
 void GetStride(const String &typeName, unsigned char &stride);
+DataType GetDataType(const String &typeName);
+unsigned char GetStride(DataType type);
+// decodes count elements of an ssd array into out, integers are stored big
+// endian and floats in host order
+void UnpackArray(DataType type, const unsigned char *bytes, size_t count,
+                 void *out);
 void UnpackUInt32(unsigned int &val, unsigned char *bytes);
 void UnpackUShort(unsigned short &val, unsigned char *bytes);
 void UnpackShort(short &val, unsigned char *bytes);
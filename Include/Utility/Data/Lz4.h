@@ -0,0 +1,14 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+// lz4 block format, compatible with LZ4_compress_default and
+// LZ4_decompress_safe without the frame around it
+namespace Lz4 {
+// appends the compressed block to out, returns its size
+size_t Compress(const unsigned char *data, size_t size,
+                std::vector<unsigned char> &out);
+// false if the block is corrupt or doesn't decode to exactly outSize bytes
+bool Decompress(const unsigned char *data, size_t size, unsigned char *out,
+                size_t outSize);
+} // namespace Lz4
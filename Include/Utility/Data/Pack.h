@@ -0,0 +1,32 @@
+#pragma once
+
+namespace Pack {
+const unsigned int Version = 1;
+const unsigned int DataAlignment = 16;
+// entry data is an lz4 block
+const unsigned int CompressedFlag = 1;
+
+// layout: header, entry data, index, paths
+// every offset is counted from the start of the file, fields are little
+// endian. Entry data is aligned to DataAlignment so version 2 ssd files can
+// be read in place.
+struct Header {
+  char Signature[4];
+  unsigned int Version;
+  unsigned int EntryCount;
+  unsigned int PathsSize;
+  unsigned long long IndexOffset;
+  unsigned long long PathsOffset;
+};
+
+// the index is sorted by PathHash, a hash of the normalized path
+struct Entry {
+  unsigned long long PathHash;
+  unsigned long long Offset;
+  unsigned long long StoredSize;
+  unsigned long long Size;
+  // offset of the null terminated path in the paths block
+  unsigned int Path;
+  unsigned int Flags;
+};
+} // namespace Pack
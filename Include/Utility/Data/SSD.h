@@ -6,34 +6,66 @@ const unsigned char NodeEnd = 0xab;
 const unsigned char AttributeBegin = 0xba;
 const unsigned char AttributeEnd = 0xbb;
 
+const unsigned char Version1 = 1;
+const unsigned char Version2 = 2;
+
+// version 1, integers are big endian, floats in host order
+// header: signature, version byte, 16 bit top level node count
+// node: NodeBegin, 32 bit unique id, name length byte, name, attribute count
+// byte, child count byte, attributes, children, NodeEnd
+// attribute: AttributeBegin, name length byte, name, type length byte, type,
+// single element byte, 32 bit byte count, 32 bit element count, values or
+// element count nodes for SerializedClass, AttributeEnd
 struct Header {
   char Signature[3];
   unsigned char Version;
 };
 
-struct Node;
+// version 2, all fields are little endian 32 bit values
+// layout: header, string table, node table, node records, payloads
+// every offset is counted from the start of the file
+const unsigned int PayloadAlignment = 16;
+const unsigned int SingleElementFlag = 1;
 
-struct Attribute {
-  unsigned char NameLength;
-  char *Name;
-  unsigned char DataTypeLength;
-  char *DataType;
-  unsigned char IsSingleElement;
-  unsigned int ByteCount;
-  unsigned int ElementCount;
-  unsigned char *Values;
-  Node **Nodes;
-  ~Attribute();
+struct HeaderV2 {
+  char Signature[3];
+  unsigned char Version;
+  // StringCount offsets relative to the end of the offsets, then the
+  // null terminated strings
+  unsigned int StringCount;
+  unsigned int StringTableOffset;
+  // a NodeEntryV2 per top level node
+  unsigned int NodeCount;
+  unsigned int NodeTableOffset;
+  unsigned int PayloadOffset;
+  unsigned int PayloadSize;
+  unsigned int Reserved;
 };
 
-struct Node {
-  unsigned char NameLength;
-  char *Name;
+// random access to top level nodes
+struct NodeEntryV2 {
+  unsigned int Offset;
+  unsigned int Size;
+};
+
+// followed by AttributeCount attributes and NodeCount child nodes
+struct NodeV2 {
   unsigned int UniqueID;
-  unsigned char AttributeCount;
-  unsigned char NodeCount;
-  Attribute **Attributes;
-  Node **Nodes;
-  ~Node();
+  unsigned int Name;
+  unsigned int AttributeCount;
+  unsigned int NodeCount;
+};
+
+// Name and DataType index the string table, Offset is relative to
+// PayloadOffset and aligned to PayloadAlignment. SerializedClass attributes
+// have no payload, their ElementCount nodes follow the record and take
+// ByteCount bytes
+struct AttributeV2 {
+  unsigned int Name;
+  unsigned int DataType;
+  unsigned int Flags;
+  unsigned int ElementCount;
+  unsigned int ByteCount;
+  unsigned int Offset;
 };
 }; // namespace SSD
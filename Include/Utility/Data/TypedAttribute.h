@@ -1,6 +1,8 @@
 #pragma once
 #include "../Common.h"
 #include "ISerialized.h"
+#include <algorithm>
+#include <memory>
 #include <vector>
 
 // for ATTRIBUTE_VECTOR
@@ -12,17 +14,68 @@ public:
     Data = data;
   };
 
+  // decodes raw file bytes into count elements
+  typedef void (*Decoder)(const unsigned char *bytes, size_t count, T *out);
+
+  // values stay in the mapped file until the consumer asks for them, owner
+  // keeps the mapping alive
+  TypedAttribute(String name, String type, const unsigned char *bytes,
+                 size_t count, Decoder decoder,
+                 const std::shared_ptr<void> &owner) {
+    AttributeName = name;
+    AttributeType = type;
+    MappedBytes = bytes;
+    MappedCount = count;
+    MappedDecoder = decoder;
+    MappedOwner = owner;
+  };
+
   virtual ~TypedAttribute(){};
   virtual String SerializedName() { return AttributeName; };
   virtual String TypeName() { return AttributeType; };
 
-  std::vector<T> Get() { return Data; }
-  void Set(std::vector<T> &data) { Data = data; }
+  std::vector<T> Get() {
+    if (!MappedBytes)
+      return Data;
+    std::vector<T> data(MappedCount);
+    CopyTo(data.data());
+    return data;
+  }
+  // moves the values out for the final consumer, the attribute is left empty
+  std::vector<T> Take() {
+    std::vector<T> data;
+    if (!MappedBytes) {
+      data.swap(Data);
+      return data;
+    }
+    data.resize(MappedCount);
+    CopyTo(data.data());
+    MappedBytes = nullptr;
+    MappedOwner.reset();
+    return data;
+  }
+  void Set(std::vector<T> &data) {
+    Data = data;
+    MappedBytes = nullptr;
+    MappedOwner.reset();
+  }
+  size_t Size() { return MappedBytes ? MappedCount : Data.size(); }
+  // writes Size() elements straight into the consumer's storage
+  void CopyTo(T *out) {
+    if (MappedBytes)
+      MappedDecoder(MappedBytes, MappedCount, out);
+    else
+      std::copy(Data.begin(), Data.end(), out);
+  }
 
 private:
   std::vector<T> Data;
   String AttributeName;
   String AttributeType;
+  const unsigned char *MappedBytes = nullptr;
+  size_t MappedCount = 0;
+  Decoder MappedDecoder = nullptr;
+  std::shared_ptr<void> MappedOwner;
 };
 
 // for ATTRIBUTE_VALUE
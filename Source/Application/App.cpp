@@ -1,13 +1,25 @@
 #include <iostream>
 
+#include "Application/AssetCooker.h"
+#include "Application/PackBuilder.h"
 #include "Application/Prototyping.h"
 #include "Application/Setup.h"
 #include "Core.h"
+#include "Modules/Statics/IAssetManager.h"
 #include "Modules/Statics/IGraphics.h"
 #include "Modules/Statics/ISceneManager.h"
 #include "Solver/Solver.h"
 
-int main() {
+int main(int argc, char **argv) {
+  if (IsPackBuilderCommand(argc, argv))
+    return RunPackBuilder(argc, argv);
+  if (IsAssetCookerCommand(argc, argv))
+    return RunAssetCooker(argc, argv);
+  // files in the archive take precedence over loose files
+  if (ResourceLoader::GetFileSize(PACK_DEFAULT_ARCHIVE) &&
+      !ResourceLoader::MountArchive(PACK_DEFAULT_ARCHIVE)) {
+    S_LOG_FUNC("%s", ResourceLoader::GetLastError().GetCharArray());
+  }
   InitializeEngine();
 
   if (!Statics::Get<ISceneManager>()->LoadScene(
@@ -23,6 +35,7 @@ int main() {
   solver->AddSystem("TransformSystem");
   solver->AddSystem("RenderingSystem");
   solver->AddSystem("FirstPersonSystem");
+  solver->AddSystem("SceneStreamingSystem");
   // Test systems
   solver->AddSystem("SceneSwitchingSystem");
   solver->AddSystem("LightViewerSystem");
@@ -30,6 +43,10 @@ int main() {
   solver->InitializeSystems();
 
   while (solver->Simulate()) {
+    // advances asynchronous scene loads, swaps scenes between frames
+    Statics::Get<ISceneManager>()->Update();
+    // evicts cached assets over the budget
+    Statics::Get<IAssetManager>()->Update();
     if (!Statics::Get<IGraphics>()->Render())
       break;
   }
@@ -0,0 +1,138 @@
+#include "Application/AssetCooker.h"
+
+#include "Core.h"
+#include "Engine/AssetTypes/Texture2D.h"
+#include "Modules/ResourceLoader/AssetCache.h"
+#include "Modules/ResourceLoader/BitmapReader/BitmapReader.h"
+#include "Modules/ResourceLoader/ResourceLoader.h"
+#include "Modules/Statics/SceneManager.h"
+#include "Utility/Data/DataNode.h"
+#include "Utility/Data/SerializedFactory.h"
+#include "Utility/Data/TypedAttribute.h"
+
+#include <cstdio>
+#include <string.h>
+
+static String GetExtension(const String &fileName) {
+  std::vector<String> segments = fileName.Split('.');
+  return segments[segments.size() - 1];
+}
+
+// encoded into the cache directory, where the loader looks first
+static bool CookBitmap(const String &fileName) {
+  unsigned long long key;
+  if (!AssetCache::GetKey(fileName, key))
+    return false;
+  if (ResourceLoader::GetFileSize(AssetCache::GetPath(key)))
+    return true;
+  Texture2D texture;
+  if (!BitmapReader::ReadBitmapToTexture(fileName.GetCharArray(), &texture))
+    return false;
+  return AssetCache::Save(key, &texture);
+}
+
+// replaces the node of a raw texture with one holding the encoded mip chain,
+// the unique id stays so references to the texture still resolve
+static bool CookTextureNode(IDataNode *&node) {
+  Texture2D *texture = dynamic_cast<Texture2D *>(node->Deserialize());
+  if (!texture)
+    return false;
+  Texture2D::TextureFormat format = texture->GetTextureFormat();
+  bool raw = format == Texture2D::Float_RGBA || format == Texture2D::Byte_RGBA;
+  if (raw) {
+    texture->Prepare();
+    std::vector<ISerialized *> attributes;
+    texture->GetAllAttributes(attributes);
+    std::vector<IDataNode *> nodes;
+    IDataNode *cookedNode = new DataNode(node->Name(), node->GetUniqueID(),
+                                         attributes, nodes);
+    delete node;
+    node = cookedNode;
+  }
+  delete texture;
+  return raw;
+}
+
+static bool CookFile(const String &fileName, std::vector<String> &cooked) {
+  for (size_t x = 0; x < cooked.size(); x++) {
+    if (cooked[x] == fileName)
+      return true;
+  }
+  cooked.push_back(fileName);
+
+  String extension = GetExtension(fileName);
+  if (extension == "bmp")
+    return CookBitmap(fileName);
+  if ((extension == "ssd") == false)
+    return true;
+
+  std::vector<IDataNode *> nodes;
+  if (!ResourceLoader::LoadSsd(fileName, nodes))
+    return false;
+  bool ok = true;
+  unsigned int texturesCooked = 0;
+  std::vector<String> externalAssets;
+  for (size_t z = 0; z < nodes.size(); z++) {
+    if (nodes[z]->Name() == "Texture2D") {
+      if (CookTextureNode(nodes[z]))
+        texturesCooked++;
+      continue;
+    }
+    if ((nodes[z]->Name() == "ExternalAsset") == false)
+      continue;
+    std::vector<ISerialized *> attributes = nodes[z]->GetAttributes();
+    for (size_t x = 0; x < attributes.size(); x++) {
+      if ((attributes[x]->SerializedName() == "FileName") == false)
+        continue;
+      TypedAttributeValue<String> *stringAttribute =
+          dynamic_cast<TypedAttributeValue<String> *>(attributes[x]);
+      if (stringAttribute)
+        externalAssets.push_back(
+            SceneManager::GetExternalAssetPathRelativeToTheSceneFile(
+                stringAttribute->Get(), fileName));
+    }
+  }
+
+  // written next to the source and moved over it, the nodes may still point
+  // into a mapping of the source until they are deleted
+  String temporaryPath = fileName + ".cook";
+  if (texturesCooked && !ResourceLoader::SaveSsd(temporaryPath, nodes))
+    ok = false;
+  for (size_t x = 0; x < nodes.size(); x++)
+    delete nodes[x];
+  if (texturesCooked && ok) {
+    remove(fileName.GetCharArray());
+    ok = rename(temporaryPath.GetCharArray(), fileName.GetCharArray()) == 0;
+  }
+  if (!ok) {
+    S_LOG_FUNC("couldn't write %s", fileName.GetCharArray());
+  } else if (texturesCooked) {
+    S_LOG_FUNC("cooked %u textures in %s", texturesCooked,
+               fileName.GetCharArray());
+  }
+
+  for (size_t x = 0; x < externalAssets.size(); x++)
+    ok = CookFile(externalAssets[x], cooked) && ok;
+  return ok;
+}
+
+bool IsAssetCookerCommand(int argc, char **argv) {
+  return argc > 1 && strcmp(argv[1], "--cook") == 0;
+}
+
+int RunAssetCooker(int argc, char **argv) {
+  if (argc < 3) {
+    S_LOG("usage: shingine --cook <file>...\n");
+    return 1;
+  }
+  std::vector<String> cooked;
+  bool ok = true;
+  for (int x = 2; x < argc; x++) {
+    if (!CookFile(argv[x], cooked)) {
+      S_LOG_FUNC("couldn't cook %s", argv[x]);
+      ok = false;
+    }
+  }
+  S_LOG_FUNC("cooked %u files", (unsigned int)cooked.size());
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+#include "Application/PackBuilder.h"
+
+#include "Core.h"
+#include "Modules/ResourceLoader/PackArchive.h"
+#include "Modules/ResourceLoader/ResourceLoader.h"
+#include "Modules/Statics/SceneManager.h"
+#include "Utility/Data/IDataNode.h"
+#include "Utility/Data/TypedAttribute.h"
+
+#include <string.h>
+
+static void AddFile(const String &fileName, std::vector<String> &files) {
+  String path = PackArchive::NormalizePath(fileName);
+  for (size_t x = 0; x < files.size(); x++) {
+    if (files[x] == path)
+      return;
+  }
+  files.push_back(path);
+}
+
+// pulls in the external assets a scene references
+static void AddSceneAssets(const String &sceneFileName,
+                           std::vector<String> &files) {
+  std::vector<IDataNode *> nodes;
+  if (!ResourceLoader::LoadSsd(sceneFileName, nodes))
+    return;
+
+  for (size_t z = 0; z < nodes.size(); z++) {
+    if ((nodes[z]->Name() == "ExternalAsset") == false)
+      continue;
+    std::vector<ISerialized *> attributes = nodes[z]->GetAttributes();
+    for (size_t x = 0; x < attributes.size(); x++) {
+      if ((attributes[x]->SerializedName() == "FileName") == false)
+        continue;
+      TypedAttributeValue<String> *stringAttribute =
+          dynamic_cast<TypedAttributeValue<String> *>(attributes[x]);
+      if (stringAttribute)
+        AddFile(SceneManager::GetExternalAssetPathRelativeToTheSceneFile(
+                    stringAttribute->Get(), sceneFileName),
+                files);
+    }
+  }
+  for (size_t x = 0; x < nodes.size(); x++)
+    delete nodes[x];
+}
+
+bool IsPackBuilderCommand(int argc, char **argv) {
+  return argc > 1 && strcmp(argv[1], "--pack") == 0;
+}
+
+int RunPackBuilder(int argc, char **argv) {
+  if (argc < 4) {
+    S_LOG("usage: shingine --pack <archive> [--compress] <file>...\n");
+    return 1;
+  }
+  String archiveFileName = argv[2];
+  bool compress = false;
+  std::vector<String> files;
+  for (int x = 3; x < argc; x++) {
+    if (strcmp(argv[x], "--compress") == 0) {
+      compress = true;
+      continue;
+    }
+    String fileName = PackArchive::NormalizePath(argv[x]);
+    AddFile(fileName, files);
+    std::vector<String> segments = fileName.Split('.');
+    if (segments[segments.size() - 1] == "ssd")
+      AddSceneAssets(fileName, files);
+  }
+
+  String error;
+  if (!PackArchive::Write(archiveFileName, files, compress, error)) {
+    S_LOG_FUNC("%s", error.GetCharArray());
+    return 1;
+  }
+  S_LOG_FUNC("packed %u files into %s", (unsigned int)files.size(),
+             archiveFileName.GetCharArray());
+  return 0;
+}
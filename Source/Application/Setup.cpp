@@ -5,7 +5,9 @@
 #include "Modules/Statics/EntityManager.h"
 #include "Modules/Statics/Graphics.h"
 #include "Modules/Statics/Input.h"
+#include "Modules/Statics/JobSystem.h"
 #include "Modules/Statics/SceneManager.h"
+#include "Modules/Statics/SpatialIndex.h"
 #include "Modules/Statics/EventSystem.h"
 
 #include "Modules/Graphics/IShader.h"
@@ -17,11 +19,13 @@
 
 void SetStaticObjects() {
   Statics::AddStaticObject<IEventSystem, EventSystem>();
+  Statics::AddStaticObject<IJobSystem, JobSystem>();
   Statics::AddStaticObject<IEntityManager, EntityManager>();
   Statics::AddStaticObject<IAssetManager, AssetManager>();
   Statics::AddStaticObject<IComponentManager, ComponentManager>();
   Statics::AddStaticObject<IInput, Input>();
   Statics::AddStaticObject<ISceneManager, SceneManager>();
+  Statics::AddStaticObject<ISpatialIndex, SpatialIndex>();
   Statics::AddStaticObject<IGraphics, Graphics>();
 }
 
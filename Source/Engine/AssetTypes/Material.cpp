@@ -1,6 +1,7 @@
 #include "Engine/AssetTypes/Material.h"
 #include "Modules/Statics/IAssetManager.h"
 #include "Modules/Statics/ISceneManager.h"
+#include "Modules/Graphics/ICommandBuffer.h"
 
 REGISTER_SERIALIZED_CLASS(Material);
 
@@ -37,6 +38,7 @@ void Material::SetFloat(const String &name, float value) {
   int index;
   FindUniformIndex(index, FloatUniformNames, name);
   if (index == -1) {
+    UniformHandlesResolved = false;
     FloatUniformNames.push_back(name);
     FloatUniformValues.push_back(value);
     return;
@@ -48,6 +50,7 @@ void Material::SetVector(const String &name, const glm::vec4 &value) {
   int index;
   FindUniformIndex(index, VectorUniformNames, name);
   if (index == -1) {
+    UniformHandlesResolved = false;
     VectorUniformNames.push_back(name);
     VectorUniformValues.push_back(value.x);
     VectorUniformValues.push_back(value.y);
@@ -66,6 +69,7 @@ void Material::SetTexture(const String &name, unsigned int textureId) {
   int index;
   FindUniformIndex(index, TextureUniformNames, name);
   if (index == -1) {
+    UniformHandlesResolved = false;
     TextureUniformNames.push_back(name);
     TextureUniformValues.push_back(textureId);
     return;
@@ -96,23 +100,53 @@ void Material::GetVectorUniforms(std::vector<std::string> &names,
   }
 }
 
+void Material::ResolveExternalTextures() {
+  if (TextureUniformNames.size() == TextureUniformValues.size())
+    return;
+  ISceneManager *sceneManager = Statics::Get<ISceneManager>();
+  assert(TextureUniformNames.size() == ExternalTexturePaths.size());
+  TextureUniformValues.clear();
+  for (unsigned int x = 0; x < TextureUniformNames.size(); x++) {
+    String path = sceneManager->GetExternalAssetPathRelativeToTheSceneFile(
+        ExternalTexturePaths[x]);
+    IObject *obj = Statics::Get<IAssetManager>()->GetAssetByFileName(path);
+    unsigned int uid = obj != nullptr ? obj->UniqueID() : 0;
+    TextureUniformValues.push_back(uid);
+  }
+}
+
 void Material::GetTextureUniforms(std::vector<std::string> &names,
                                   std::vector<unsigned int> &values) {
-  if (TextureUniformNames.size() != TextureUniformValues.size()) {
-    ISceneManager *sceneManager = Statics::Get<ISceneManager>();
-    assert(TextureUniformNames.size() == ExternalTexturePaths.size());
-    TextureUniformValues.clear();
-    for (unsigned int x = 0; x < TextureUniformNames.size(); x++) {
-      String path = sceneManager->GetExternalAssetPathRelativeToTheSceneFile(
-          ExternalTexturePaths[x]);
-      IObject *obj = Statics::Get<IAssetManager>()->GetAssetByFileName(path);
-      unsigned int uid = obj != nullptr ? obj->UniqueID() : 0;
-      TextureUniformValues.push_back(uid);
-    }
-  }
+  ResolveExternalTextures();
   names.clear();
   for (size_t x = 0; x < TextureUniformNames.size(); x++) {
     names.push_back(TextureUniformNames[x]);
     values.push_back(TextureUniformValues[x]);
   }
 }
+
+void Material::BindUniformHandles(ICommandBuffer *buffer) {
+  if (UniformHandlesResolved)
+    return;
+  ResolveExternalTextures();
+
+  FloatUniformHandles.clear();
+  for (size_t x = 0; x < FloatUniformNames.size(); x++)
+    FloatUniformHandles.push_back(
+        buffer->GetUniformHandle(FloatUniformNames[x]));
+
+  VectorUniformHandles.clear();
+  for (size_t x = 0; x < VectorUniformNames.size(); x++) {
+    if (x * 4 >= VectorUniformValues.size())
+      throw 1;
+    VectorUniformHandles.push_back(
+        buffer->GetUniformHandle(VectorUniformNames[x]));
+  }
+
+  TextureUniformHandles.clear();
+  for (size_t x = 0; x < TextureUniformNames.size(); x++)
+    TextureUniformHandles.push_back(
+        buffer->GetUniformHandle(TextureUniformNames[x]));
+
+  UniformHandlesResolved = true;
+}
@@ -1,2 +1,41 @@
 #include "Engine/AssetTypes/Mesh.h"
+#include "Core.h"
+#include "Modules/Utility/MeshUtils.h"
 REGISTER_SERIALIZED_CLASS(Mesh);
+
+void Mesh::OnLoad() {
+  if (!Optimized) {
+    MeshUtils::OptimizationReport report;
+    MeshUtils::Optimize(this, report);
+    Optimized = 1;
+    S_LOG_FUNC("Mesh #%d: vertices %u -> %u, acmr %.3f -> %.3f, "
+               "atvr %.3f -> %.3f",
+               UniqueID(), report.VerticesBefore,
+               report.VerticesAfter, report.AcmrBefore, report.AcmrAfter,
+               report.AtvrBefore, report.AtvrAfter);
+  }
+  if (LodIndexCounts.empty()) {
+    MeshUtils::GenerateLods(this);
+    if (!LodIndexCounts.empty()) {
+      S_LOG_FUNC("Mesh #%d: %u lods, coarsest %u triangles", UniqueID(),
+                 GetLodCount(), LodIndexCounts.back() / 3);
+    }
+  }
+  CalculateBounds();
+}
+
+void Mesh::CalculateBounds() {
+  BoundsUtils::Calculate(Positions, Bounds, BoundsSphere);
+}
+
+size_t Mesh::GetMemoryUsage() {
+  size_t vertexCount = Positions.size() + Normals.size() + TexCoord.size();
+  return vertexCount * sizeof(glm::vec3) +
+         (Indices.size() + LodIndices.size()) * sizeof(unsigned int);
+}
+
+size_t Mesh::GetGpuMemoryUsage() {
+  // upper bound, the full float vertex with 32 bit indices
+  return Positions.size() * 9 * sizeof(float) +
+         (Indices.size() + LodIndices.size()) * sizeof(unsigned int);
+}
@@ -1,7 +1,24 @@
 #include "Engine/AssetTypes/Texture2D.h"
+#include "Modules/Utility/TextureUtils.h"
 REGISTER_SERIALIZED_CLASS(Texture2D);
 
 Texture2D::~Texture2D() {}
+
+void Texture2D::OnLoad() {
+  // textures cooked with --cook or read from the asset cache are encoded
+  // already, only raw pixels pay for the import here
+  if (Format == Float_RGBA || Format == Byte_RGBA)
+    TextureUtils::Import(this, static_cast<TextureFormat>(TargetFormat));
+}
+
+void Texture2D::SetMipData(TextureFormat format, unsigned int mipCount,
+                           std::vector<unsigned char> &data) {
+  MipData.swap(data);
+  MipCount = mipCount;
+  Format = format;
+  std::vector<float>().swap(Pixels);
+  std::vector<unsigned char>().swap(Pixels32);
+}
 float *Texture2D::GetPixels() { return Pixels.data(); }
 unsigned char *Texture2D::GetPixels32() { return Pixels32.data(); }
 void Texture2D::SetPixels(unsigned int width, unsigned int height,
@@ -32,3 +49,14 @@ void Texture2D::SetPixels(unsigned int width, unsigned int height,
 Texture2D::TextureFormat Texture2D::GetTextureFormat() {
   return (TextureFormat)Format;
 }
+
+size_t Texture2D::GetMemoryUsage() {
+  return Pixels.size() * sizeof(float) + Pixels32.size() + MipData.size();
+}
+
+size_t Texture2D::GetGpuMemoryUsage() {
+  if (Format != Float_RGBA && Format != Byte_RGBA)
+    return MipData.size();
+  // raw pixels are uploaded as 8 bit rgba with generated mips
+  return (size_t)Width * Height * 4 * 4 / 3;
+}
@@ -1,4 +1,7 @@
 #include "Engine/Components/LightComponent.h"
+#include "Modules/Statics/ISpatialIndex.h"
+#include <algorithm>
+#include <cmath>
 
 REGISTER_COMPONENT(LightComponent);
 
@@ -35,8 +38,30 @@ LightComponent::LightComponent() {
   OuterAngle = 45.f;
 };
 
-LightComponent::~LightComponent() {}
+LightComponent::~LightComponent() {
+  if (SpatialProxyId != SPATIAL_PROXY_NONE)
+    Statics::Get<ISpatialIndex>()->DestroyProxy(SpatialProxyId);
+}
 
 glm::vec4 LightComponent::GetColor() {
   return glm::vec4(Color[0], Color[1], Color[2], 1.f);
 }
+
+// light below this fraction of the brightest channel is ignored
+#define LIGHT_ATTENUATION_THRESHOLD (5.f / 256.f)
+
+float LightComponent::GetAttenuationRadius() {
+  float brightest =
+      std::max(std::max(Color[0], Color[1]), Color[2]) * Intensity;
+  // solve Constant + Linear * d + Quadratic * d^2 = brightest / threshold
+  float c = Constant - brightest / LIGHT_ATTENUATION_THRESHOLD;
+  if (Quadratic <= 0.f) {
+    if (Linear <= 0.f)
+      return 0.f;
+    return std::max(0.f, -c / Linear);
+  }
+  float discriminant = Linear * Linear - 4.f * Quadratic * c;
+  if (discriminant < 0.f)
+    return 0.f;
+  return std::max(0.f, (-Linear + sqrtf(discriminant)) / (2.f * Quadratic));
+}
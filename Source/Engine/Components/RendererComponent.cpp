@@ -1,2 +1,9 @@
 #include "Engine/Components/RendererComponent.h"
+#include "Modules/Statics/ISpatialIndex.h"
 REGISTER_COMPONENT(RendererComponent);
+
+// entity ids are recycled, a proxy left behind would match the next owner
+RendererComponent::~RendererComponent() {
+  if (SpatialProxyId != SPATIAL_PROXY_NONE)
+    Statics::Get<ISpatialIndex>()->DestroyProxy(SpatialProxyId);
+}
@@ -3,15 +3,18 @@
 #include "Engine/Components/TransformComponent.h"
 #include "Game/FirstPersonController/FirstPersonComponent.h"
 #include "Modules/Statics/IComponentManager.h"
+#include "Modules/Statics/ISpatialIndex.h"
 
 #include "Modules/Statics/IInput.h"
 
+#include "Core.h"
 #include "Utility/Typedefs.h"
 
 #include <iostream>
 
 #define DEG2RAD 0.017453292522222223f
 #define RAD2DEG 57.29577950560105f
+#define PICKING_DISTANCE 100.f
 
 // TODO optimize
 namespace FirstPersonController {
@@ -113,6 +116,27 @@ void FirstPersonSystem::UpdateMovement(glm::vec3 &position, glm::vec3 &Front,
   position += translation;
 }
 
+void FirstPersonSystem::UpdatePicking(const glm::vec3 &position,
+                                      const glm::vec3 &cameraFront) {
+  if (!Statics::Get<IInput>()->GetMousePressed(S_INPUT_MOUSE_RIGHT)) {
+    FirstPersonComponent->PickedEntityId = 0;
+    return;
+  }
+
+  unsigned int entityId = 0;
+  float distance = 0.f;
+  if (!Statics::Get<ISpatialIndex>()->RayCast(position, cameraFront,
+                                              PICKING_DISTANCE,
+                                              SPATIAL_PROXY_RENDERER,
+                                              entityId, distance))
+    entityId = 0;
+
+  if (entityId != FirstPersonComponent->PickedEntityId && entityId != 0) {
+    S_LOG_FUNC("Picked entity %d at %f", entityId, distance);
+  }
+  FirstPersonComponent->PickedEntityId = entityId;
+}
+
 bool FirstPersonSystem::Update() {
   if (!Active)
     return true;
@@ -130,6 +154,7 @@ bool FirstPersonSystem::Update() {
       glm::lookAt(position, position + cameraFront, cameraUp));
 
   PlayerTransform->SetPosition(position);
+  UpdatePicking(position, cameraFront);
 
   return true;
 }
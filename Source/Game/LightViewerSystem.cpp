@@ -28,12 +28,15 @@ bool LightViewerSystem::Initialize() {
   IShader *unlitShader = GraphicsUtils::CreateVertexFragmentShader(
       vertexShaderPath, fragmentShaderPath);
   UnlitShaderId = unlitShader->AssetId();
+  UnlitColorHandle =
+      Statics::Get<IGraphics>()
+          ->GetCommandBuffer(IGraphics::CommandBufferType::Main)
+          ->GetUniformHandle("_UnlitColor");
 
   return true;
 }
 
 const float cubeScale = .15f;
-const std::string UnlitShaderName = "_UnlitColor";
 
 bool LightViewerSystem::Update() {
   IComponentManager *componentManager = Statics::Get<IComponentManager>();
@@ -48,7 +51,8 @@ bool LightViewerSystem::Update() {
     LightComponent *light = LightComponentMap->AtIndex(x);
     if (light->LightType == DIRECTIONAL_LIGHT_TYPE)
       continue;
-    commandBuffer->SetVector(UnlitShaderName, UnlitShaderId, light->GetColor());
+    commandBuffer->SetVector(UnlitColorHandle, UnlitShaderId,
+                             light->GetColor());
     TransformComponent *transform =
         componentManager->GetComponentOfType<TransformComponent>(
             light->EntityId());
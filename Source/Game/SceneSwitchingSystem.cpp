@@ -22,7 +22,16 @@ bool SceneSwitchingSystem::Update() {
   if (input->GetKeyUp(S_INPUT_KEY_EQUAL)) {
     CurrentLoadedScene = (CurrentLoadedScene + 1) % SceneCount;
     S_LOG_FUNC("Triggering the scene switch");
-    SceneManager->LoadScene(ScenePaths[CurrentLoadedScene]);
+    // the current scene keeps running until the new one is ready
+    SceneLoad = SceneManager->LoadSceneAsync(ScenePaths[CurrentLoadedScene]);
+  }
+  if (SceneLoad && SceneLoad->IsDone()) {
+    if (SceneLoad->Failed()) {
+      S_LOG_FUNC("Couldn't load %s", SceneLoad->GetFileName().GetCharArray());
+    } else {
+      S_LOG_FUNC("Switched to %s", SceneLoad->GetFileName().GetCharArray());
+    }
+    SceneLoad = nullptr;
   }
   return true;
 }
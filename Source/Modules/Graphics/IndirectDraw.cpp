@@ -0,0 +1,85 @@
+#include "Modules/Graphics/IndirectDraw.h"
+#include <stddef.h>
+
+unsigned int BatchRangeAllocator::Allocate(unsigned int count) {
+  for (size_t x = 0; x < FreeRanges.size(); x++) {
+    FreeRange &range = FreeRanges[x];
+    if (range.Count < count)
+      continue;
+    unsigned int first = range.First;
+    range.First += count;
+    range.Count -= count;
+    if (range.Count == 0)
+      FreeRanges.erase(FreeRanges.begin() + x);
+    return first;
+  }
+  unsigned int first = UsedCount;
+  UsedCount += count;
+  return first;
+}
+
+void BatchRangeAllocator::Free(unsigned int first, unsigned int count) {
+  if (count == 0)
+    return;
+  size_t x = 0;
+  while (x < FreeRanges.size() && FreeRanges[x].First < first)
+    x++;
+  // merge with the free range before and after it
+  if (x > 0 && FreeRanges[x - 1].First + FreeRanges[x - 1].Count == first) {
+    x--;
+    FreeRanges[x].Count += count;
+  } else {
+    FreeRange range;
+    range.First = first;
+    range.Count = count;
+    FreeRanges.insert(FreeRanges.begin() + x, range);
+  }
+  if (x + 1 < FreeRanges.size() &&
+      FreeRanges[x].First + FreeRanges[x].Count == FreeRanges[x + 1].First) {
+    FreeRanges[x].Count += FreeRanges[x + 1].Count;
+    FreeRanges.erase(FreeRanges.begin() + x + 1);
+  }
+  // space at the end goes back to the unused part of the buffer
+  if (FreeRanges.back().First + FreeRanges.back().Count == UsedCount) {
+    UsedCount = FreeRanges.back().First;
+    FreeRanges.pop_back();
+  }
+}
+
+unsigned int BatchRangeAllocator::GetFreeCount() const {
+  unsigned int count = 0;
+  for (size_t x = 0; x < FreeRanges.size(); x++)
+    count += FreeRanges[x].Count;
+  return count;
+}
+
+void BatchRangeAllocator::Clear() {
+  FreeRanges.clear();
+  UsedCount = 0;
+}
+
+namespace IndirectDrawUtils {
+void BuildCommands(const MeshRange *ranges, unsigned int count,
+                   std::vector<DrawElementsIndirectCommand> &commands) {
+  commands.clear();
+  for (unsigned int x = 0; x < count; x++) {
+    const MeshRange &range = ranges[x];
+    if (!commands.empty()) {
+      DrawElementsIndirectCommand &last = commands.back();
+      if (last.FirstIndex == range.FirstIndex &&
+          last.Count == range.IndexCount &&
+          last.BaseVertex == range.BaseVertex) {
+        last.InstanceCount++;
+        continue;
+      }
+    }
+    DrawElementsIndirectCommand command;
+    command.Count = range.IndexCount;
+    command.InstanceCount = 1;
+    command.FirstIndex = range.FirstIndex;
+    command.BaseVertex = range.BaseVertex;
+    command.BaseInstance = x;
+    commands.push_back(command);
+  }
+}
+} // namespace IndirectDrawUtils
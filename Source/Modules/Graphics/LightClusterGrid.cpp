@@ -0,0 +1,112 @@
+#include "Modules/Graphics/LightClusterGrid.h"
+#include <algorithm>
+#include <cmath>
+
+LightClusterGrid::LightClusterGrid(unsigned int tilesX, unsigned int tilesY,
+                                   unsigned int slices)
+    : TilesX(tilesX), TilesY(tilesY), Slices(slices) {
+  SetProjection(.6f, 1.f, .1f, 1000.f);
+}
+
+void LightClusterGrid::SetProjection(float fovY, float aspectRatio,
+                                     float nearPlane, float farPlane) {
+  float tanHalfFov = tanf(fovY * .5f);
+  ProjectionScaleY = 1.f / tanHalfFov;
+  ProjectionScaleX = 1.f / (aspectRatio * tanHalfFov);
+  NearPlane = nearPlane;
+  FarPlane = farPlane;
+  // exponential slices keep the clusters roughly cubic
+  float logRange = logf(FarPlane / NearPlane);
+  SliceScale = Slices / logRange;
+  SliceBias = Slices * logf(NearPlane) / logRange;
+}
+
+unsigned int LightClusterGrid::GetClusterIndex(unsigned int x, unsigned int y,
+                                               unsigned int slice) const {
+  return (slice * TilesY + y) * TilesX + x;
+}
+
+unsigned int LightClusterGrid::GetSliceForDepth(float depth) const {
+  if (depth <= NearPlane)
+    return 0;
+  float slice = logf(depth) * SliceScale - SliceBias;
+  return std::min(static_cast<unsigned int>(slice), Slices - 1);
+}
+
+unsigned int LightClusterGrid::GetLightCount(unsigned int clusterIndex) const {
+  return ClusterRanges[clusterIndex * 2 + 1];
+}
+
+void LightClusterGrid::GetTileRange(float viewMin, float viewMax,
+                                    float depthMin, float depthMax,
+                                    float projectionScale,
+                                    unsigned int tileCount,
+                                    unsigned int &tileBegin,
+                                    unsigned int &tileEnd) const {
+  // x / depth is monotonic in depth, checking both ends is conservative
+  float ndcMin = std::min(viewMin / depthMin, viewMin / depthMax);
+  float ndcMax = std::max(viewMax / depthMin, viewMax / depthMax);
+  ndcMin = std::max(-1.f, ndcMin * projectionScale);
+  ndcMax = std::min(1.f, ndcMax * projectionScale);
+  if (ndcMin > ndcMax) {
+    tileBegin = tileEnd = 0;
+    return;
+  }
+  tileBegin = static_cast<unsigned int>((ndcMin * .5f + .5f) * tileCount);
+  tileEnd = static_cast<unsigned int>((ndcMax * .5f + .5f) * tileCount) + 1;
+  tileBegin = std::min(tileBegin, tileCount - 1);
+  tileEnd = std::min(tileEnd, tileCount);
+}
+
+void LightClusterGrid::Build(const std::vector<ClusterLight> &lights) {
+  PairClusters.clear();
+  PairLights.clear();
+
+  for (unsigned int lightIndex = 0; lightIndex < lights.size(); lightIndex++) {
+    const ClusterLight &light = lights[lightIndex];
+    // camera looks down negative z
+    float depth = -light.ViewPosition.z;
+    float depthMin = std::max(depth - light.Radius, NearPlane);
+    float depthMax = std::min(depth + light.Radius, FarPlane);
+    if (depthMin > depthMax)
+      continue;
+
+    unsigned int sliceBegin = GetSliceForDepth(depthMin);
+    unsigned int sliceEnd = GetSliceForDepth(depthMax) + 1;
+
+    unsigned int xBegin, xEnd, yBegin, yEnd;
+    GetTileRange(light.ViewPosition.x - light.Radius,
+                 light.ViewPosition.x + light.Radius, depthMin, depthMax,
+                 ProjectionScaleX, TilesX, xBegin, xEnd);
+    GetTileRange(light.ViewPosition.y - light.Radius,
+                 light.ViewPosition.y + light.Radius, depthMin, depthMax,
+                 ProjectionScaleY, TilesY, yBegin, yEnd);
+
+    for (unsigned int slice = sliceBegin; slice < sliceEnd; slice++)
+      for (unsigned int y = yBegin; y < yEnd; y++)
+        for (unsigned int x = xBegin; x < xEnd; x++) {
+          PairClusters.push_back(GetClusterIndex(x, y, slice));
+          PairLights.push_back(lightIndex);
+        }
+  }
+
+  // counting sort of the pairs by cluster
+  unsigned int clusterCount = GetClusterCount();
+  ClusterRanges.assign(clusterCount * 2, 0);
+  for (size_t x = 0; x < PairClusters.size(); x++)
+    ClusterRanges[PairClusters[x] * 2 + 1]++;
+
+  unsigned int offset = 0;
+  for (unsigned int x = 0; x < clusterCount; x++) {
+    ClusterRanges[x * 2] = offset;
+    offset += ClusterRanges[x * 2 + 1];
+    // reused as the write cursor below
+    ClusterRanges[x * 2 + 1] = 0;
+  }
+
+  LightIndices.resize(PairLights.size());
+  for (size_t x = 0; x < PairClusters.size(); x++) {
+    unsigned int *range = &ClusterRanges[PairClusters[x] * 2];
+    LightIndices[range[0] + range[1]++] = PairLights[x];
+  }
+}
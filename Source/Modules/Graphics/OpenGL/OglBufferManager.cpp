@@ -0,0 +1,54 @@
+#include "Modules/Graphics/OpenGL/OglBufferManager.h"
+#include "Modules/Graphics/ICommandBuffer.h"
+#include "Utility/Graphics.h"
+
+OglBufferManager::~OglBufferManager() {
+  std::unordered_map<unsigned int, TextureBuffer>::iterator it;
+  for (it = TextureBuffers.begin(); it != TextureBuffers.end(); it++) {
+    glDeleteTextures(1, &it->second.TextureId);
+    glDeleteBuffers(1, &it->second.BufferId);
+  }
+}
+
+OglBufferManager::TextureBuffer &
+OglBufferManager::GetTextureBuffer(unsigned int bufferId) {
+  TextureBuffer &textureBuffer = TextureBuffers[bufferId];
+  if (textureBuffer.BufferId == 0) {
+    glGenBuffers(1, &textureBuffer.BufferId);
+    glGenTextures(1, &textureBuffer.TextureId);
+  }
+  return textureBuffer;
+}
+
+void OglBufferManager::UpdateTextureBuffer(unsigned int bufferId, int format,
+                                           const void *data,
+                                           unsigned int sizeInBytes) {
+  GLenum internalFormat = GL_R32UI;
+  switch (ICommandBuffer::ETextureBufferFormat(format)) {
+  case ICommandBuffer::ETextureBufferFormat::Float4:
+    internalFormat = GL_RGBA32F;
+    break;
+  case ICommandBuffer::ETextureBufferFormat::UInt2:
+    internalFormat = GL_RG32UI;
+    break;
+  case ICommandBuffer::ETextureBufferFormat::UInt:
+  default:
+    internalFormat = GL_R32UI;
+    break;
+  }
+
+  TextureBuffer &textureBuffer = GetTextureBuffer(bufferId);
+  glBindBuffer(GL_TEXTURE_BUFFER, textureBuffer.BufferId);
+  // orphan the previous storage, empty buffers still get a texel
+  glBufferData(GL_TEXTURE_BUFFER, sizeInBytes ? sizeInBytes : 16, nullptr,
+               GL_STREAM_DRAW);
+  if (sizeInBytes)
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, sizeInBytes, data);
+  glBindTexture(GL_TEXTURE_BUFFER, textureBuffer.TextureId);
+  glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, textureBuffer.BufferId);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+unsigned int OglBufferManager::GetBufferTextureId(unsigned int bufferId) {
+  return GetTextureBuffer(bufferId).TextureId;
+}
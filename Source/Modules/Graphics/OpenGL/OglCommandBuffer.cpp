@@ -1,8 +1,13 @@
 #include "Modules/Graphics/OpenGL/OglCommandBuffer.h"
 #include "Modules/Graphics/OpenGL/BuiltInUniformNames.h"
+#include "Modules/Graphics/IShader.h"
 #include "Modules/Graphics/OpenGL/DOglCommandBuffer.h"
+#include "Modules/Graphics/OpenGL/OglBufferManager.h"
+#include "Modules/Graphics/OpenGL/OglMultiDraw.h"
 #include "Modules/Graphics/OpenGL/OglShaderManager.h"
 #include "Modules/Graphics/OpenGL/OglTextureManager.h"
+#include "Modules/Graphics/OpenGL/OglUploadQueue.h"
+#include "Modules/Graphics/OpenGL/OglUploadRing.h"
 #include "Modules/Graphics/OpenGL/OpenGLRender.h"
 #include "Modules/Graphics/OpenGL/VaoMeshManager.h"
 
@@ -13,6 +18,7 @@
 #include "Engine/Components/TransformComponent.h"
 
 #include "Utility/Graphics.h"
+#include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 
@@ -22,7 +28,9 @@ OglCommandBuffer::~OglCommandBuffer() {}
 
 void OglCommandBuffer::ResetCommandBuffer() {
   CommandCount = 0;
+  CurrentShaderId = 0;
   Commands.clear();
+  DrawData.clear();
 }
 
 void OglCommandBuffer::AddCommand(const unsigned char &cmd) {
@@ -34,10 +42,38 @@ void OglCommandBuffer::EnableDepth() { AddCommand(CB_ENABLE_DEPTH); }
 void OglCommandBuffer::EnableCullFace() { AddCommand(CB_ENABLE_CULL_FACE); }
 void OglCommandBuffer::Clear() { AddCommand(CB_CLEAR); }
 
-void OglCommandBuffer::UseProgram(int programId) {
-  CurrentShaderProgram = programId;
+void OglCommandBuffer::UseShader(unsigned int shaderId) {
+  CurrentShaderId = shaderId;
   AddCommand(CB_USE_PROGRAM);
-  WRITE_INT(programId)
+  WRITE_UINT(shaderId)
+}
+
+unsigned int OglCommandBuffer::ResolveShaderId(unsigned int shaderId) {
+  // 0 stands for the default shader, in the stream it means no program
+  if (shaderId == 0)
+    shaderId = Statics::Get<IGraphics>()->DefaultShader()->AssetId();
+  return shaderId;
+}
+
+void OglCommandBuffer::Append(ICommandBuffer *buffer) {
+  OglCommandBuffer *other = dynamic_cast<OglCommandBuffer *>(buffer);
+  if (other == nullptr)
+    throw 1;
+  if (other->CommandCount == 0)
+    return;
+  // draw offsets of the other buffer are relative to its own draw data
+  unsigned int drawDataBase = static_cast<unsigned int>(DrawData.size());
+  AddCommand(CB_SET_DRAW_DATA_BASE);
+  { WRITE_UINT(drawDataBase); }
+  Commands.insert(Commands.end(), other->Commands.begin(),
+                  other->Commands.end());
+  CommandCount += other->CommandCount;
+  DrawData.insert(DrawData.end(), other->DrawData.begin(),
+                  other->DrawData.end());
+  drawDataBase = 0;
+  AddCommand(CB_SET_DRAW_DATA_BASE);
+  { WRITE_UINT(drawDataBase); }
+  CurrentShaderId = other->CurrentShaderId;
 }
 
 void OglCommandBuffer::SetPolygonMode(ICommandBuffer::EDrawPolygonMode mode) {
@@ -69,40 +105,109 @@ void OglCommandBuffer::UpdateCamera() {
 
 void OglCommandBuffer::DrawMesh(glm::mat4 &matrix, glm::mat4 &matrixInv,
                                 unsigned int &meshAssetId,
-                                unsigned int &shaderId) {
+                                unsigned int &shaderId, unsigned int lod) {
   UpdateCamera();
-  OpenGLRender *oglRender = GetContext();
-
-  // set material uniforms
-  int programId = oglRender->GetShaderManager()->GetShaderProgramId(shaderId);
+  unsigned int shaderAssetId = ResolveShaderId(shaderId);
 
-  SetMatrixOgl(ModelMatrixName, programId, matrix);
-  SetMatrixOgl(ModelMatrixInverseName, programId, matrixInv);
-  SetMatrixOgl(ProjectionMatrixName, programId,
-               ActiveCamera->GetProjectionMatrix());
-  SetMatrixOgl(ViewMatrixName, programId, ActiveCamera->GetViewMatrix());
+  // matrices go to the per draw block instead of the uniform stream
+  unsigned int drawDataOffset = static_cast<unsigned int>(DrawData.size());
+  DrawData.resize(drawDataOffset + PER_DRAW_DATA_SIZE);
+  glm::mat4 matrices[4] = {matrix, matrixInv,
+                           ActiveCamera->GetViewMatrix(),
+                           ActiveCamera->GetProjectionMatrix()};
+  memcpy(&DrawData[drawDataOffset], matrices, sizeof(matrices));
 
   glm::vec4 pos;
   ActiveCameraTransform->GetPosition(pos);
-  SetVectorOgl(CameraWorldPositionName, programId, pos);
-
-  unsigned int vaoId, indexCount;
-  oglRender->GetMeshManager()->GetVAOForMeshId(programId, meshAssetId, vaoId,
-                                               indexCount);
+  SetVectorOgl(CameraWorldPositionHandle, shaderAssetId, pos);
 
   SetPolygonMode(ICommandBuffer::EDrawPolygonMode::Fill);
-  if (CurrentShaderProgram != programId)
-    UseProgram(programId);
+  if (CurrentShaderId != shaderAssetId)
+    UseShader(shaderAssetId);
+  // the vao is looked up on execute, which keeps recording free of GL calls
   AddCommand(CB_DRAW_MESH);
-  { WRITE_UINT(vaoId); }
-  { WRITE_UINT(indexCount); }
-  UseProgram(0);
+  { WRITE_UINT(meshAssetId); }
+  { WRITE_UINT(lod); }
+  { WRITE_UINT(drawDataOffset); }
+  UseShader(0);
+}
+
+void OglCommandBuffer::DrawMeshBatch(const glm::mat4 *matrices,
+                                     const glm::mat4 *matricesInv,
+                                     const unsigned int *meshAssetIds,
+                                     const unsigned int *lods,
+                                     unsigned int count,
+                                     unsigned int shaderId) {
+  UpdateCamera();
+  unsigned int shaderAssetId = ResolveShaderId(shaderId);
+  SetPolygonMode(ICommandBuffer::EDrawPolygonMode::Fill);
+  if (CurrentShaderId != shaderAssetId)
+    UseShader(shaderAssetId);
+
+  glm::vec4 pos;
+  ActiveCameraTransform->GetPosition(pos);
+  SetVectorOgl(CameraWorldPositionHandle, shaderAssetId, pos);
+
+  // the per draw block only carries the camera, the model matrices of the
+  // batch go to the batch block indexed by the draw index attribute
+  glm::mat4 identity(1.f);
+  glm::mat4 cameraMatrices[4] = {identity, identity,
+                                 ActiveCamera->GetViewMatrix(),
+                                 ActiveCamera->GetProjectionMatrix()};
+  unsigned int perDrawOffset = static_cast<unsigned int>(DrawData.size());
+  DrawData.resize(perDrawOffset + PER_DRAW_DATA_SIZE);
+  memcpy(&DrawData[perDrawOffset], cameraMatrices, sizeof(cameraMatrices));
+
+  for (unsigned int begin = 0; begin < count; begin += MAX_BATCH_DRAWS) {
+    unsigned int batchCount =
+        std::min(count - begin, static_cast<unsigned int>(MAX_BATCH_DRAWS));
+    // the whole block is allocated, the binding has to cover its size
+    unsigned int batchOffset = static_cast<unsigned int>(DrawData.size());
+    DrawData.resize(batchOffset + DRAW_BATCH_DATA_SIZE);
+    unsigned char *batchMatrices = &DrawData[batchOffset];
+    for (unsigned int x = 0; x < batchCount; x++) {
+      memcpy(batchMatrices, &matrices[begin + x], sizeof(glm::mat4));
+      batchMatrices += sizeof(glm::mat4);
+      memcpy(batchMatrices, &matricesInv[begin + x], sizeof(glm::mat4));
+      batchMatrices += sizeof(glm::mat4);
+    }
+
+    AddCommand(CB_DRAW_MESH_BATCH);
+    { WRITE_UINT(perDrawOffset); }
+    { WRITE_UINT(batchOffset); }
+    { WRITE_UINT(batchCount); }
+    unsigned int noLod = 0;
+    for (unsigned int x = 0; x < batchCount; x++) {
+      { WRITE_UINT(meshAssetIds[begin + x]); }
+      { WRITE_UINT(lods ? lods[begin + x] : noLod); }
+    }
+  }
+  UseShader(0);
 }
 
 void OglCommandBuffer::ReadValue(unsigned char &cmd) {
   cmd = Commands[CurrentByte++];
 }
 
+void OglCommandBuffer::BindTextureToSampler(int uniformHandle, int programId,
+                                            unsigned int target,
+                                            unsigned int textureId) {
+  OpenGLRender *context = GetContext();
+  OglShaderManager *shaderManager = context->GetShaderManager();
+  int textureSlot = 0;
+  bool isNew = false;
+  context->GetTextureManager()->GetTextureSlotForShaderProgram(
+      uniformHandle, programId, textureSlot, isNew);
+  // sampler uniforms keep their value, so the slot is set only once
+  if (isNew)
+    glUniform1i(shaderManager->GetUniformLocation(
+                    shaderManager->GetUniformLocationTable(programId),
+                    programId, uniformHandle),
+                textureSlot);
+  glActiveTexture(GL_TEXTURE0 + textureSlot);
+  glBindTexture(target, textureId);
+}
+
 OpenGLRender *OglCommandBuffer::GetContext() {
   if (!CachedRenderContext)
     CachedRenderContext =
@@ -110,84 +215,86 @@ OpenGLRender *OglCommandBuffer::GetContext() {
   return CachedRenderContext;
 }
 
+int OglCommandBuffer::GetUniformHandle(const std::string &name) {
+  return GetContext()->GetShaderManager()->GetUniformHandle(name);
+}
+
 void OglCommandBuffer::SetTexture(const std::string &name,
                                   unsigned int shaderId,
                                   unsigned int textureId) {
-  OpenGLRender *context = GetContext();
-  OglTextureManager *textureManager = context->GetTextureManager();
-  OglShaderManager *shaderManager = context->GetShaderManager();
-  unsigned int textureOglId = textureManager->GetTextureIdByAssetId(textureId);
-  int programId = shaderManager->GetShaderProgramId(shaderId);
-  int textureSlot = 0;
-  bool isNew = false;
-  textureManager->GetTextureSlotForShaderProgramByName(name, programId,
-                                                       textureSlot, isNew);
-  if (isNew) {
-    // need to set texture slot first
-    UseProgram(programId);
-    int uniformLoc;
-    shaderManager->GetUniformId(name, programId, uniformLoc);
-
-    AddCommand(CB_SET_INTEGER_UNIFORM);
-    WRITE_INT(uniformLoc);
-    { WRITE_INT(textureSlot); }
-  }
-  AddCommand(CB_BIND_TEXTURE);
-  { WRITE_INT(textureSlot); }
-  { WRITE_INT(textureOglId); }
+  SetTexture(GetUniformHandle(name), shaderId, textureId);
 }
 
 void OglCommandBuffer::SetMatrix(const std::string &name, unsigned int shaderId,
                                  glm::mat4 matrix) {
-  int programId =
-      GetContext()->GetShaderManager()->GetShaderProgramId(shaderId);
-  SetMatrixOgl(name, programId, matrix);
+  SetMatrix(GetUniformHandle(name), shaderId, matrix);
 }
 
 void OglCommandBuffer::SetFloat(const std::string &name, unsigned int shaderId,
                                 float value) {
-  int programId =
-      GetContext()->GetShaderManager()->GetShaderProgramId(shaderId);
-  SetFloatOgl(name, programId, value);
+  SetFloat(GetUniformHandle(name), shaderId, value);
 }
 
 void OglCommandBuffer::SetVector(const std::string &name, unsigned int shaderId,
                                  const glm::vec4 &vector) {
-  int programId =
-      GetContext()->GetShaderManager()->GetShaderProgramId(shaderId);
-  SetVectorOgl(name, programId, vector);
+  SetVector(GetUniformHandle(name), shaderId, vector);
+}
+
+void OglCommandBuffer::SetTexture(int uniformHandle, unsigned int shaderId,
+                                  unsigned int textureId) {
+  shaderId = ResolveShaderId(shaderId);
+  if (CurrentShaderId != shaderId)
+    UseShader(shaderId);
+  // texture slots and GL textures are assigned on execute
+  AddCommand(CB_BIND_TEXTURE);
+  { WRITE_INT(uniformHandle); }
+  { WRITE_UINT(textureId); }
 }
 
-void OglCommandBuffer::SetMatrixOgl(const std::string &name, int programId,
-                                    glm::mat4 matrix) {
-  if (CurrentShaderProgram != programId)
-    UseProgram(programId);
-  int uniformLoc;
-  GetContext()->GetShaderManager()->GetUniformId(name, programId, uniformLoc);
-  SetMatrixOgl(uniformLoc, matrix);
+void OglCommandBuffer::UpdateTextureBuffer(unsigned int bufferId,
+                                           ETextureBufferFormat format,
+                                           const void *data,
+                                           unsigned int sizeInBytes) {
+  AddCommand(CB_UPDATE_TEXTURE_BUFFER);
+  { WRITE_UINT(bufferId); }
+  Commands.push_back(static_cast<unsigned char>(format));
+  { WRITE_UINT(sizeInBytes); }
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  Commands.insert(Commands.end(), bytes, bytes + sizeInBytes);
 }
 
-void OglCommandBuffer::SetFloatOgl(const std::string &name, int programId,
-                                   float value) {
-  if (CurrentShaderProgram != programId)
-    UseProgram(programId);
-  int uniformLoc;
-  GetContext()->GetShaderManager()->GetUniformId(name, programId, uniformLoc);
-  SetFloatOgl(uniformLoc, value);
+void OglCommandBuffer::SetTextureBuffer(int uniformHandle,
+                                        unsigned int shaderId,
+                                        unsigned int bufferId) {
+  shaderId = ResolveShaderId(shaderId);
+  if (CurrentShaderId != shaderId)
+    UseShader(shaderId);
+  AddCommand(CB_BIND_TEXTURE_BUFFER);
+  { WRITE_INT(uniformHandle); }
+  { WRITE_UINT(bufferId); }
 }
 
-void OglCommandBuffer::SetVectorOgl(const std::string &name, int programId,
-                                    const glm::vec4 &vector) {
-  if (CurrentShaderProgram != programId)
-    UseProgram(programId);
-  int uniformLoc;
-  GetContext()->GetShaderManager()->GetUniformId(name, programId, uniformLoc);
-  SetVectorOgl(uniformLoc, vector);
+void OglCommandBuffer::SetMatrix(int uniformHandle, unsigned int shaderId,
+                                 const glm::mat4 &matrix) {
+  SetMatrixOgl(uniformHandle, ResolveShaderId(shaderId), matrix);
 }
 
-void OglCommandBuffer::SetMatrixOgl(int uniformLocation, glm::mat4 &matrix) {
+void OglCommandBuffer::SetFloat(int uniformHandle, unsigned int shaderId,
+                                float value) {
+  SetFloatOgl(uniformHandle, ResolveShaderId(shaderId), value);
+}
+
+void OglCommandBuffer::SetVector(int uniformHandle, unsigned int shaderId,
+                                 const glm::vec4 &vector) {
+  SetVectorOgl(uniformHandle, ResolveShaderId(shaderId), vector);
+}
+
+void OglCommandBuffer::SetMatrixOgl(int uniformHandle, unsigned int shaderId,
+                                    const glm::mat4 &matrix) {
+  if (CurrentShaderId != shaderId)
+    UseShader(shaderId);
   AddCommand(CB_SET_MATRIX_UNIFORM);
-  WRITE_INT(uniformLocation);
+  WRITE_INT(uniformHandle);
   WRITE_MATRIX(matrix, 0, 0);
   WRITE_MATRIX(matrix, 0, 1);
   WRITE_MATRIX(matrix, 0, 2);
@@ -206,16 +313,21 @@ void OglCommandBuffer::SetMatrixOgl(int uniformLocation, glm::mat4 &matrix) {
   WRITE_MATRIX(matrix, 3, 3);
 }
 
-void OglCommandBuffer::SetFloatOgl(int uniformLocation, float value) {
+void OglCommandBuffer::SetFloatOgl(int uniformHandle, unsigned int shaderId,
+                                   float value) {
+  if (CurrentShaderId != shaderId)
+    UseShader(shaderId);
   AddCommand(CB_SET_FLOAT_UNIFORM);
-  WRITE_INT(uniformLocation);
+  WRITE_INT(uniformHandle);
   { WRITE_FLOAT(value); }
 }
 
-void OglCommandBuffer::SetVectorOgl(int uniformLocation,
+void OglCommandBuffer::SetVectorOgl(int uniformHandle, unsigned int shaderId,
                                     const glm::vec4 &vector) {
+  if (CurrentShaderId != shaderId)
+    UseShader(shaderId);
   AddCommand(CB_SET_VECTOR_UNIFORM);
-  WRITE_INT(uniformLocation);
+  WRITE_INT(uniformHandle);
   { WRITE_FLOAT(vector.x); }
   { WRITE_FLOAT(vector.y); }
   { WRITE_FLOAT(vector.z); }
@@ -227,6 +339,25 @@ void OglCommandBuffer::SetVectorOgl(int uniformLocation,
 void OglCommandBuffer::Execute() {
   CurrentByte = 0;
   unsigned char cmd;
+  // uniform commands carry handles, locations come from the bound program
+  OpenGLRender *context = GetContext();
+  OglShaderManager *shaderManager = context->GetShaderManager();
+  OglTextureManager *textureManager = context->GetTextureManager();
+  VaoMeshManager *meshManager = context->GetMeshManager();
+  OglUploadQueue *uploadQueue = context->GetUploadQueue();
+  OglBufferManager *bufferManager = context->GetBufferManager();
+  OglShaderManager::UniformLocationTable *uniformLocations = nullptr;
+  int boundProgramId = 0;
+
+  // all per draw blocks of the buffer go to the ring with a single copy
+  OglUploadRing *uploadRing = context->GetUploadRing();
+  unsigned int drawDataOffset = 0;
+  unsigned int drawDataBase = 0;
+  // the batch block is backed by the batch data or by zeros
+  bool emptyBatchDataBound = false;
+  if (!DrawData.empty())
+    drawDataOffset = uploadRing->Upload(
+        DrawData.data(), static_cast<unsigned int>(DrawData.size()));
   for (unsigned int x = 0; x < CommandCount; x++) {
     ReadValue(cmd);
     switch (cmd) {
@@ -255,28 +386,43 @@ void OglCommandBuffer::Execute() {
       }
     } break;
     case CB_USE_PROGRAM: {
-      int programId;
-      { READ_INT(programId); }
+      unsigned int shaderId;
+      { READ_UINT(shaderId); }
+      int programId =
+          shaderId ? shaderManager->GetShaderProgramId(shaderId) : 0;
       glUseProgram(programId);
+      boundProgramId = programId;
+      uniformLocations = programId
+                             ? shaderManager->GetUniformLocationTable(programId)
+                             : nullptr;
     } break;
     case CB_SET_INTEGER_UNIFORM: {
       int uniformLoc;
       int intValue;
-      { READ_INT(uniformLoc); }
+      int uniformHandle;
+      { READ_INT(uniformHandle); }
+      uniformLoc = shaderManager->GetUniformLocation(
+          uniformLocations, boundProgramId, uniformHandle);
       { READ_INT(intValue); }
       glUniform1i(uniformLoc, intValue);
     } break;
     case CB_SET_FLOAT_UNIFORM: {
       int uniformLocFloat;
       float floatValue;
-      { READ_INT(uniformLocFloat); }
+      int uniformHandle;
+      { READ_INT(uniformHandle); }
+      uniformLocFloat = shaderManager->GetUniformLocation(
+          uniformLocations, boundProgramId, uniformHandle);
       { READ_FLOAT(floatValue); }
       glUniform1f(uniformLocFloat, floatValue);
     } break;
     case CB_SET_VECTOR_UNIFORM: {
       int uniformLocInt;
       glm::vec4 vectorValue;
-      { READ_INT(uniformLocInt); }
+      int uniformHandle;
+      { READ_INT(uniformHandle); }
+      uniformLocInt = shaderManager->GetUniformLocation(
+          uniformLocations, boundProgramId, uniformHandle);
       { READ_FLOAT(vectorValue.x); }
       { READ_FLOAT(vectorValue.y); }
       { READ_FLOAT(vectorValue.z); }
@@ -287,7 +433,10 @@ void OglCommandBuffer::Execute() {
     case CB_SET_MATRIX_UNIFORM: {
       int uniformLocMat;
       glm::mat4 matrix;
-      { READ_INT(uniformLocMat); }
+      int uniformHandle;
+      { READ_INT(uniformHandle); }
+      uniformLocMat = shaderManager->GetUniformLocation(
+          uniformLocations, boundProgramId, uniformHandle);
       READ_MATRIX(matrix, 0, 0);
       READ_MATRIX(matrix, 0, 1);
       READ_MATRIX(matrix, 0, 2);
@@ -307,19 +456,124 @@ void OglCommandBuffer::Execute() {
       glUniformMatrix4fv(uniformLocMat, 1, GL_FALSE, glm::value_ptr(matrix));
     } break;
     case CB_BIND_TEXTURE: {
-      int textureSlot, textureId;
-      { READ_INT(textureSlot); }
-      { READ_INT(textureId); }
-      glActiveTexture(GL_TEXTURE0 + textureSlot);
-      glBindTexture(GL_TEXTURE_2D, textureId);
+      int uniformHandle;
+      unsigned int textureAssetId;
+      { READ_INT(uniformHandle); }
+      { READ_UINT(textureAssetId); }
+      BindTextureToSampler(
+          uniformHandle, boundProgramId, GL_TEXTURE_2D,
+          textureManager->GetTextureIdByAssetId(textureAssetId, uploadQueue));
     } break;
-    case CB_DRAW_MESH: {
-      unsigned int vaoId, indexCount;
-      { READ_UINT(vaoId); }
-      { READ_UINT(indexCount); }
-      glBindVertexArray(vaoId);
-      glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    case CB_UPDATE_TEXTURE_BUFFER: {
+      unsigned int bufferId, sizeInBytes;
+      unsigned char format;
+      { READ_UINT(bufferId); }
+      ReadValue(format);
+      { READ_UINT(sizeInBytes); }
+      bufferManager->UpdateTextureBuffer(
+          bufferId, format, sizeInBytes ? &Commands[CurrentByte] : nullptr,
+          sizeInBytes);
+      CurrentByte += sizeInBytes;
+    } break;
+    case CB_BIND_TEXTURE_BUFFER: {
+      int uniformHandle;
+      unsigned int bufferId;
+      { READ_INT(uniformHandle); }
+      { READ_UINT(bufferId); }
+      BindTextureToSampler(uniformHandle, boundProgramId, GL_TEXTURE_BUFFER,
+                           bufferManager->GetBufferTextureId(bufferId));
+    } break;
+    case CB_SET_DRAW_DATA_BASE: {
+      READ_UINT(drawDataBase);
+    } break;
+    case CB_DRAW_MESH_BATCH: {
+      unsigned int perDrawOffset, batchOffset, batchCount;
+      { READ_UINT(perDrawOffset); }
+      { READ_UINT(batchOffset); }
+      { READ_UINT(batchCount); }
+      BatchMeshIds.resize(batchCount);
+      BatchLods.resize(batchCount);
+      BatchRanges.resize(batchCount);
+      for (unsigned int x = 0; x < batchCount; x++) {
+        { READ_UINT(BatchMeshIds[x]); }
+        { READ_UINT(BatchLods[x]); }
+      }
+      // meshes still in the upload queue keep an empty range, which draws
+      // nothing and leaves the draw indices of the others in place
+      for (unsigned int x = 0; x < batchCount; x++)
+        if (!meshManager->GetMeshRange(BatchMeshIds[x], BatchLods[x],
+                                       BatchRanges[x], uploadQueue))
+          BatchRanges[x] = MeshRange();
+      IndirectDrawUtils::BuildCommands(BatchRanges.data(), batchCount,
+                                       BatchCommands);
+
+      unsigned int dataOffset = drawDataOffset + drawDataBase;
+      glBindBufferRange(GL_UNIFORM_BUFFER, PER_DRAW_BINDING,
+                        uploadRing->GetBufferId(), dataOffset + perDrawOffset,
+                        PER_DRAW_DATA_SIZE);
+      glBindBufferRange(GL_UNIFORM_BUFFER, DRAW_BATCH_BINDING,
+                        uploadRing->GetBufferId(), dataOffset + batchOffset,
+                        DRAW_BATCH_DATA_SIZE);
+      emptyBatchDataBound = false;
+
+      // the shared buffers keep float positions
+      meshManager->SetPositionDequantization(shaderManager, boundProgramId,
+                                             nullptr);
+      OglMultiDraw *multiDraw = context->GetMultiDraw();
+      glBindVertexArray(meshManager->GetBatchVAO(multiDraw));
+      multiDraw->Draw(BatchCommands, GL_UNSIGNED_SHORT);
       glBindVertexArray(0);
+
+      // meshes outside the shared layout are drawn from their own buffers,
+      // the draw index is a constant attribute as their vaos don't have it
+      bool separateDraws = false;
+      for (unsigned int x = 0; x < batchCount; x++) {
+        if (!meshManager->IsDrawnSeparately(BatchMeshIds[x]))
+          continue;
+        const VaoMeshManager::MeshBuffers *buffers =
+            meshManager->GetMeshBuffers(BatchMeshIds[x], uploadQueue);
+        if (!buffers)
+          continue;
+        meshManager->SetPositionDequantization(shaderManager, boundProgramId,
+                                               buffers);
+        glVertexAttrib2f(DrawIndexAttributeLocation, static_cast<float>(x),
+                         1.f);
+        meshManager->DrawMesh(*buffers, BatchLods[x]);
+        separateDraws = true;
+      }
+      if (separateDraws)
+        glVertexAttrib2f(DrawIndexAttributeLocation, 0.f, 0.f);
+    } break;
+    case CB_DRAW_MESH: {
+      unsigned int meshAssetId, lod, offset;
+      { READ_UINT(meshAssetId); }
+      { READ_UINT(lod); }
+      { READ_UINT(offset); }
+      glBindBufferRange(GL_UNIFORM_BUFFER, PER_DRAW_BINDING,
+                        uploadRing->GetBufferId(),
+                        drawDataOffset + drawDataBase + offset,
+                        PER_DRAW_DATA_SIZE);
+      if (!emptyBatchDataBound) {
+        context->GetMultiDraw()->BindEmptyBatchData();
+        emptyBatchDataBound = true;
+      }
+      // meshes packed for static batches are drawn from the shared buffers
+      // rather than uploaded a second time
+      MeshRange packedRange;
+      if (meshManager->GetPackedMeshRange(meshAssetId, lod, packedRange)) {
+        meshManager->SetPositionDequantization(shaderManager, boundProgramId,
+                                               nullptr);
+        meshManager->DrawPackedMesh(packedRange);
+        break;
+      }
+      const VaoMeshManager::MeshBuffers *buffers =
+          meshManager->GetMeshBuffers(meshAssetId, uploadQueue);
+      // skipped until the upload queue got to the mesh
+      if (!buffers)
+        break;
+      meshManager->SetPositionDequantization(shaderManager, boundProgramId,
+                                             buffers);
+      meshManager->DrawMesh(*buffers, lod);
     } break;
     default:
       break;
@@ -0,0 +1,104 @@
+#include "Modules/Graphics/OpenGL/OglMultiDraw.h"
+#include "Modules/Graphics/OpenGL/BuiltInUniformNames.h"
+#include "Utility/Graphics.h"
+
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+// the glad loader is generated for GL 3.2, newer entry points are loaded here
+typedef void(APIENTRYP PFNMULTIDRAWELEMENTSINDIRECTPROC)(
+    GLenum mode, GLenum type, const void *indirect, GLsizei drawCount,
+    GLsizei stride);
+typedef void(APIENTRYP PFNVERTEXATTRIBDIVISORPROC)(GLuint index,
+                                                    GLuint divisor);
+static PFNMULTIDRAWELEMENTSINDIRECTPROC MultiDrawElementsIndirect = nullptr;
+static PFNVERTEXATTRIBDIVISORPROC VertexAttribDivisor = nullptr;
+
+OglMultiDraw::~OglMultiDraw() {
+  if (IndirectBuffer)
+    glDeleteBuffers(1, &IndirectBuffer);
+  if (EmptyBatchBuffer)
+    glDeleteBuffers(1, &EmptyBatchBuffer);
+}
+
+void OglMultiDraw::BindEmptyBatchData() {
+  if (EmptyBatchBuffer == 0) {
+    std::vector<unsigned char> zeros(DRAW_BATCH_DATA_SIZE, 0);
+    glGenBuffers(1, &EmptyBatchBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, EmptyBatchBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, DRAW_BATCH_DATA_SIZE, zeros.data(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  }
+  glBindBufferRange(GL_UNIFORM_BUFFER, DRAW_BATCH_BINDING, EmptyBatchBuffer, 0,
+                    DRAW_BATCH_DATA_SIZE);
+}
+
+void OglMultiDraw::Initialize() {
+  Initialized = true;
+  GLint major = 0, minor = 0;
+  glGetIntegerv(GL_MAJOR_VERSION, &major);
+  glGetIntegerv(GL_MINOR_VERSION, &minor);
+  if (major < 4 || (major == 4 && minor < 3))
+    return;
+  MultiDrawElementsIndirect = (PFNMULTIDRAWELEMENTSINDIRECTPROC)
+      glfwGetProcAddress("glMultiDrawElementsIndirect");
+  VertexAttribDivisor =
+      (PFNVERTEXATTRIBDIVISORPROC)glfwGetProcAddress("glVertexAttribDivisor");
+  Supported = MultiDrawElementsIndirect && VertexAttribDivisor;
+}
+
+bool OglMultiDraw::IsSupported() {
+  if (!Initialized)
+    Initialize();
+  return Supported;
+}
+
+void OglMultiDraw::SetAttributeDivisor(int location, unsigned int divisor) {
+  if (IsSupported())
+    VertexAttribDivisor(location, divisor);
+}
+
+void OglMultiDraw::Draw(
+    const std::vector<DrawElementsIndirectCommand> &commands,
+    unsigned int indexType) {
+  if (commands.empty())
+    return;
+  unsigned int indexSize = indexType == GL_UNSIGNED_SHORT
+                               ? sizeof(unsigned short)
+                               : sizeof(unsigned int);
+
+  if (IsSupported()) {
+    unsigned int size = static_cast<unsigned int>(
+        commands.size() * sizeof(DrawElementsIndirectCommand));
+    if (IndirectBuffer == 0)
+      glGenBuffers(1, &IndirectBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IndirectBuffer);
+    // orphaned every batch, the previous commands may still be in flight
+    if (size > IndirectBufferSize)
+      IndirectBufferSize = size;
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, IndirectBufferSize, nullptr,
+                 GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, commands.data());
+    MultiDrawElementsIndirect(GL_TRIANGLES, indexType, nullptr,
+                              static_cast<GLsizei>(commands.size()), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    return;
+  }
+
+  // without the instanced attribute the draw index is a constant attribute
+  for (size_t x = 0; x < commands.size(); x++) {
+    const DrawElementsIndirectCommand &command = commands[x];
+    for (unsigned int y = 0; y < command.InstanceCount; y++) {
+      glVertexAttrib2f(DrawIndexAttributeLocation,
+                       static_cast<float>(command.BaseInstance + y), 1.f);
+      glDrawElementsBaseVertex(
+          GL_TRIANGLES, command.Count, indexType,
+          (void *)(size_t)(command.FirstIndex * indexSize),
+          command.BaseVertex);
+    }
+  }
+  // constant attribute values are context state, unbatched draws expect 0
+  glVertexAttrib2f(DrawIndexAttributeLocation, 0.f, 0.f);
+}
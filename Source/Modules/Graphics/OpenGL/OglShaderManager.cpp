@@ -1,4 +1,5 @@
 #include "Modules/Graphics/OpenGL/OglShaderManager.h"
+#include "Modules/Graphics/OpenGL/BuiltInUniformNames.h"
 #include "Utility/Graphics.h"
 
 #include "Modules/Statics/IGraphics.h"
@@ -10,21 +11,53 @@
 
 #include <glm/gtc/type_ptr.hpp>
 #include "Core.h"
-OglShaderManager::OglShaderManager() {}
 
-void OglShaderManager::GetUniformId(const std::string &uniformName,
-                                    int programId, int &uniformLoc) {
-  uniformLoc = 0;
+#define UNRESOLVED_UNIFORM_LOCATION -2
+
+OglShaderManager::OglShaderManager() {
+  // register built-in uniforms in the order of EBuiltInUniformHandle
+  GetUniformHandle(ModelMatrixName);
+  GetUniformHandle(ModelMatrixInverseName);
+  GetUniformHandle(ViewMatrixName);
+  GetUniformHandle(ProjectionMatrixName);
+  GetUniformHandle(CameraWorldPositionName);
+  GetUniformHandle(PositionScaleName);
+  GetUniformHandle(PositionOffsetName);
+}
+
+int OglShaderManager::GetUniformHandle(const std::string &uniformName) {
+  std::lock_guard<std::mutex> lock(UniformHandleMutex);
   std::unordered_map<std::string, int>::iterator it =
-      UniformLocations[programId].find(uniformName);
-  if (it == UniformLocations[programId].end()) {
+      UniformHandles.find(uniformName);
+  if (it != UniformHandles.end())
+    return it->second;
+  int uniformHandle = static_cast<int>(UniformNames.size());
+  UniformNames.push_back(uniformName);
+  UniformHandles[uniformName] = uniformHandle;
+  return uniformHandle;
+}
+
+OglShaderManager::UniformLocationTable *
+OglShaderManager::GetUniformLocationTable(int programId) {
+  return &UniformLocations[programId];
+}
+
+int OglShaderManager::GetUniformLocation(UniformLocationTable *table,
+                                         int programId, int uniformHandle) {
+  if (uniformHandle < 0)
+    return -1;
+  if (static_cast<size_t>(uniformHandle) >= table->size())
+    table->resize(uniformHandle + 1, UNRESOLVED_UNIFORM_LOCATION);
+
+  int &uniformLoc = (*table)[uniformHandle];
+  if (uniformLoc == UNRESOLVED_UNIFORM_LOCATION) {
     // find uniform location
-    glUseProgram(programId);
+    std::lock_guard<std::mutex> lock(UniformHandleMutex);
+    const std::string &uniformName = UniformNames[uniformHandle];
     uniformLoc = glGetUniformLocation(programId, uniformName.c_str());
-    UniformLocations[programId][uniformName] = uniformLoc;
     S_LOG_FUNC("Getting uniform location for %s", uniformName.c_str());
-  } else
-    uniformLoc = it->second;
+  }
+  return uniformLoc;
 }
 
 int OglShaderManager::GetShaderProgramId(unsigned int shaderId) {
@@ -66,6 +99,14 @@ int OglShaderManager::CreateVertexFragmentShaderProgram(IShader *shader) {
 
   glAttachShader(programId, vertexId);
   glAttachShader(programId, fragmentId);
+  glBindAttribLocation(programId, PositionAttributeLocation,
+                       PositionAttributeName);
+  glBindAttribLocation(programId, NormalAttributeLocation,
+                       NormalAttributeName);
+  glBindAttribLocation(programId, TexCoordAttributeLocation,
+                       TexCoordAttributeName);
+  glBindAttribLocation(programId, DrawIndexAttributeLocation,
+                       DrawIndexAttributeName);
   glLinkProgram(programId);
 
   String errorText;
@@ -73,6 +114,15 @@ int OglShaderManager::CreateVertexFragmentShaderProgram(IShader *shader) {
     std::cout << "Program link error: " << errorText << std::endl;
     throw 1;
   }
+  // GLSL 4.10 has no binding qualifier, the block is bound here
+  unsigned int perDrawBlock =
+      glGetUniformBlockIndex(programId, PerDrawBlockName);
+  if (perDrawBlock != GL_INVALID_INDEX)
+    glUniformBlockBinding(programId, perDrawBlock, PER_DRAW_BINDING);
+  unsigned int drawBatchBlock =
+      glGetUniformBlockIndex(programId, DrawBatchBlockName);
+  if (drawBatchBlock != GL_INVALID_INDEX)
+    glUniformBlockBinding(programId, drawBatchBlock, DRAW_BATCH_BINDING);
   return programId;
 }
 
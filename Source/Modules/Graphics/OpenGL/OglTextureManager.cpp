@@ -1,8 +1,23 @@
 #include "Modules/Graphics/OpenGL/OglTextureManager.h"
 #include "Engine/AssetTypes/Texture2D.h"
+#include "Modules/Graphics/OpenGL/OglUploadQueue.h"
 #include "Modules/Statics/IAssetManager.h"
 
+#include "Modules/Utility/TextureUtils.h"
 #include "Utility/Graphics.h"
+#include <algorithm>
+#include <cstring>
+
+// block formats outside of the 4.1 core profile
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
 
 void OglTextureManager::DeleteUnusedResources() {
   IAssetManager *assetManager = Statics::Get<IAssetManager>();
@@ -27,27 +42,35 @@ void OglTextureManager::DeleteUnusedResources() {
 }
 
 unsigned int
-OglTextureManager::GetTextureIdByAssetId(unsigned int textureAssetId) {
+OglTextureManager::GetTextureIdByAssetId(unsigned int textureAssetId,
+                                         OglUploadQueue *uploadQueue) {
   AssetTextureMapType::iterator it = AssetIdToTextureId.find(textureAssetId);
   if (it != AssetIdToTextureId.end())
     return it->second;
 
-  unsigned int textureId;
-  LoadTextureToGpu(textureAssetId, textureId);
-  return textureId;
+  uploadQueue->Request(OglUploadQueue::ResourceTexture, textureAssetId);
+  if (PlaceholderTexture == 0) {
+    unsigned char white[4] = {255, 255, 255, 255};
+    glGenTextures(1, &PlaceholderTexture);
+    glBindTexture(GL_TEXTURE_2D, PlaceholderTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, white);
+  }
+  return PlaceholderTexture;
 }
 
-void OglTextureManager::LoadTextureToGpu(unsigned int textureAssetId,
-                                         unsigned int &texture) {
+unsigned int OglTextureManager::LoadTextureToGpu(unsigned int textureAssetId) {
   int width, height;
   Texture2D *textureAsset =
       Statics::Get<IAssetManager>()->GetAssetOfType<Texture2D>(textureAssetId);
   textureAsset->GetResolution(width, height);
 
-  // float *data = textureAsset->GetPixels();
   S_LOG_FUNC("Loaded texture #%d", textureAsset->UniqueID());
 
   // get a texture asset
+  GLuint texture;
   glGenTextures(1, &texture);
   glBindTexture(GL_TEXTURE_2D, texture);
 
@@ -58,44 +81,168 @@ void OglTextureManager::LoadTextureToGpu(unsigned int textureAssetId,
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
   Texture2D::TextureFormat format = textureAsset->GetTextureFormat();
-  if (format == Texture2D::TextureFormat::Float_RGBA)
-  {
-    float *data = textureAsset->GetPixels();
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_FLOAT,
-                data);
-  }
-  
-  if (format == Texture2D::TextureFormat::Byte_RGBA)
-  {
-    unsigned char *data32 = textureAsset->GetPixels32();
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                data32);
+  if (format != Texture2D::Float_RGBA && format != Texture2D::Byte_RGBA) {
+    UploadMipChain(textureAsset);
+    AssetIdToTextureId[textureAssetId] = texture;
+    return textureAsset->GetMipDataSize();
   }
 
+  bool floatPixels = format == Texture2D::TextureFormat::Float_RGBA;
+  const void *pixels = floatPixels
+                           ? (const void *)textureAsset->GetPixels()
+                           : (const void *)textureAsset->GetPixels32();
+  unsigned int sizeInBytes =
+      width * height * 4 * (floatPixels ? sizeof(float) : 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA,
+               floatPixels ? GL_FLOAT : GL_UNSIGNED_BYTE,
+               Stage(pixels, sizeInBytes));
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
   glGenerateMipmap(GL_TEXTURE_2D);
 
   AssetIdToTextureId[textureAssetId] = texture;
+  return sizeInBytes;
+}
+
+const void *OglTextureManager::Stage(const void *data,
+                                     unsigned int sizeInBytes) {
+  // the copy out of the pixel buffer is done by the driver, the orphaned
+  // storage lets it continue while the next texture is staged
+  if (StagingBuffer == 0)
+    glGenBuffers(1, &StagingBuffer);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, StagingBuffer);
+  glBufferData(GL_PIXEL_UNPACK_BUFFER, sizeInBytes, nullptr, GL_STREAM_DRAW);
+  void *staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, sizeInBytes,
+                                   GL_MAP_WRITE_BIT |
+                                       GL_MAP_INVALIDATE_BUFFER_BIT);
+  if (!staging) {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return data;
+  }
+  memcpy(staging, data, sizeInBytes);
+  glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+  // offsets into the bound pixel buffer
+  return nullptr;
+}
+
+bool OglTextureManager::HasExtension(const char *name) {
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint x = 0; x < count; x++) {
+    const char *extension = (const char *)glGetStringi(GL_EXTENSIONS, x);
+    if (extension && strcmp(extension, name) == 0)
+      return true;
+  }
+  return false;
+}
+
+bool OglTextureManager::IsCompressedFormatSupported(unsigned int glFormat) {
+  // drivers don't have to list every format in GL_COMPRESSED_TEXTURE_FORMATS
+  if (!CompressedFormatsQueried) {
+    CompressedFormatsQueried = true;
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    S3tcSupported = HasExtension("GL_EXT_texture_compression_s3tc");
+    RgtcSupported =
+        major >= 3 || HasExtension("GL_ARB_texture_compression_rgtc");
+    BptcSupported = major > 4 || (major == 4 && minor >= 2) ||
+                    HasExtension("GL_ARB_texture_compression_bptc");
+  }
+  switch (glFormat) {
+  case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+  case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    return S3tcSupported;
+  case GL_COMPRESSED_RG_RGTC2:
+    return RgtcSupported;
+  case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    return BptcSupported;
+  }
+  return false;
+}
+
+void OglTextureManager::UploadMipChain(Texture2D *textureAsset) {
+  int width, height;
+  textureAsset->GetResolution(width, height);
+  Texture2D::TextureFormat format = textureAsset->GetTextureFormat();
+  unsigned int glFormat = 0;
+  switch (format) {
+  case Texture2D::BC1_RGB:
+    glFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    break;
+  case Texture2D::BC3_RGBA:
+    glFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    break;
+  case Texture2D::BC5_RG:
+    glFormat = GL_COMPRESSED_RG_RGTC2;
+    break;
+  case Texture2D::BC7_RGBA:
+    glFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+    break;
+  default:
+    break;
+  }
+  bool blockFormat = TextureUtils::IsBlockFormat(format);
+  bool decode = blockFormat && !IsCompressedFormatSupported(glFormat);
+
+  unsigned int mipCount = textureAsset->GetMipCount();
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                  GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipCount - 1);
+
+  // decoded levels are uploaded from memory, the others from one staged
+  // copy of the whole chain
+  const unsigned char *data = textureAsset->GetMipData();
+  const unsigned char *source =
+      decode ? data
+             : (const unsigned char *)Stage(data,
+                                            textureAsset->GetMipDataSize());
+  std::vector<unsigned char> decoded;
+  unsigned int offset = 0;
+  for (unsigned int level = 0; level < mipCount; level++) {
+    unsigned int levelWidth = std::max(width >> level, 1);
+    unsigned int levelHeight = std::max(height >> level, 1);
+    unsigned int levelSize =
+        TextureUtils::GetLevelSize(format, levelWidth, levelHeight);
+    const void *levelData = source + offset;
+    if (decode) {
+      TextureUtils::DecodeLevel(format, data + offset, levelWidth,
+                                levelHeight, decoded);
+      glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, levelWidth, levelHeight, 0,
+                   GL_RGBA, GL_UNSIGNED_BYTE, decoded.data());
+    } else if (blockFormat) {
+      glCompressedTexImage2D(GL_TEXTURE_2D, level, glFormat, levelWidth,
+                             levelHeight, 0, levelSize, levelData);
+    } else {
+      glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA16F, levelWidth, levelHeight,
+                   0, GL_RGBA, GL_HALF_FLOAT, levelData);
+    }
+    offset += levelSize;
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
 
-void OglTextureManager::GetTextureSlotForShaderProgramByName(
-    const std::string &name, int programId, int &textureSlot, bool &isNew) {
+void OglTextureManager::GetTextureSlotForShaderProgram(int uniformHandle,
+                                                       int programId,
+                                                       int &textureSlot,
+                                                       bool &isNew) {
   isNew = false;
   // first find program id
   TextureSlotMapType::iterator it = TextureSlots.find(programId);
   if (it == TextureSlots.end()) {
     isNew = true;
     textureSlot = 0;
-    TextureSlots[programId][name] = textureSlot;
+    TextureSlots[programId][uniformHandle] = textureSlot;
     return;
   }
 
-  NameSlotMapType &programTextureSlotMap = it->second;
-  NameSlotMapType::iterator it2 = programTextureSlotMap.find(name);
+  HandleSlotMapType &programTextureSlotMap = it->second;
+  HandleSlotMapType::iterator it2 = programTextureSlotMap.find(uniformHandle);
 
   if (it2 == programTextureSlotMap.end()) {
     isNew = true;
     textureSlot = programTextureSlotMap.size();
-    programTextureSlotMap[name] = textureSlot;
+    programTextureSlotMap[uniformHandle] = textureSlot;
     return;
   }
   textureSlot = it2->second;
@@ -0,0 +1,40 @@
+#include "Modules/Graphics/OpenGL/OglUploadQueue.h"
+#include "Engine/AssetTypes/Mesh.h"
+#include "Engine/AssetTypes/Texture2D.h"
+#include "Modules/Graphics/OpenGL/OglTextureManager.h"
+#include "Modules/Graphics/OpenGL/VaoMeshManager.h"
+#include "Modules/Statics/IAssetManager.h"
+
+void OglUploadQueue::Request(EResourceType type, unsigned int assetId) {
+  if (!PendingKeys.insert(GetKey(type, assetId)).second)
+    return;
+  UploadRequest request = {type, assetId};
+  Pending.push_back(request);
+}
+
+void OglUploadQueue::Process(VaoMeshManager *meshManager,
+                             OglTextureManager *textureManager) {
+  IAssetManager *assetManager = Statics::Get<IAssetManager>();
+  unsigned int uploadedBytes = 0;
+  while (!Pending.empty() && uploadedBytes < UPLOAD_QUEUE_BUDGET) {
+    UploadRequest request = Pending.front();
+    Pending.pop_front();
+    PendingKeys.erase(GetKey(request.Type, request.AssetId));
+
+    // the asset may have been unloaded since it was requested
+    switch (request.Type) {
+    case ResourceMesh:
+      if (assetManager->GetAssetOfType<Mesh>(request.AssetId))
+        uploadedBytes += meshManager->UploadMesh(request.AssetId);
+      break;
+    case ResourceBatchMesh:
+      if (assetManager->GetAssetOfType<Mesh>(request.AssetId))
+        uploadedBytes += meshManager->PackBatchMesh(request.AssetId);
+      break;
+    case ResourceTexture:
+      if (assetManager->GetAssetOfType<Texture2D>(request.AssetId))
+        uploadedBytes += textureManager->LoadTextureToGpu(request.AssetId);
+      break;
+    }
+  }
+}
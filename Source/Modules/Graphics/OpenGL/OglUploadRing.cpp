@@ -0,0 +1,123 @@
+#include "Modules/Graphics/OpenGL/OglUploadRing.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+// the glad loader is generated for GL 3.2, buffer storage is loaded by hand
+typedef void(APIENTRYP PFNBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size,
+                                              const void *data,
+                                              GLbitfield flags);
+static PFNBUFFERSTORAGEPROC BufferStorage = nullptr;
+
+OglUploadRing::~OglUploadRing() { Destroy(); }
+
+unsigned int OglUploadRing::Align(unsigned int offset) const {
+  return (offset + Alignment - 1) / Alignment * Alignment;
+}
+
+void OglUploadRing::Create(unsigned int segmentSize) {
+  if (!Initialized) {
+    Initialized = true;
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    Alignment = std::max(Alignment, static_cast<unsigned int>(alignment));
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    if (major > 4 || (major == 4 && minor >= 4) ||
+        glfwExtensionSupported("GL_ARB_buffer_storage"))
+      BufferStorage =
+          (PFNBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+    Persistent = BufferStorage != nullptr;
+  }
+
+  SegmentSize = Align(segmentSize);
+  Segment = 0;
+  Offset = 0;
+  glGenBuffers(1, &BufferId);
+  glBindBuffer(GL_UNIFORM_BUFFER, BufferId);
+  if (Persistent) {
+    GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLsizeiptr size = SegmentSize * UPLOAD_RING_SEGMENTS;
+    BufferStorage(GL_UNIFORM_BUFFER, size, nullptr, flags);
+    MappedData = static_cast<unsigned char *>(
+        glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags));
+  } else {
+    glBufferData(GL_UNIFORM_BUFFER, SegmentSize, nullptr, GL_STREAM_DRAW);
+  }
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void OglUploadRing::Destroy() {
+  if (BufferId == 0)
+    return;
+  for (unsigned int x = 0; x < UPLOAD_RING_SEGMENTS; x++) {
+    if (!Fences[x])
+      continue;
+    glClientWaitSync(Fences[x], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(Fences[x]);
+    Fences[x] = nullptr;
+  }
+  if (MappedData) {
+    glBindBuffer(GL_UNIFORM_BUFFER, BufferId);
+    glUnmapBuffer(GL_UNIFORM_BUFFER);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    MappedData = nullptr;
+  }
+  glDeleteBuffers(1, &BufferId);
+  BufferId = 0;
+}
+
+void OglUploadRing::NextSegment() {
+  // the gpu may still read the segment, it gets reused after the fence
+  Fences[Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  Segment = (Segment + 1) % UPLOAD_RING_SEGMENTS;
+  Offset = 0;
+  if (Fences[Segment]) {
+    glClientWaitSync(Fences[Segment], GL_SYNC_FLUSH_COMMANDS_BIT,
+                     GL_TIMEOUT_IGNORED);
+    glDeleteSync(Fences[Segment]);
+    Fences[Segment] = nullptr;
+  }
+}
+
+unsigned int OglUploadRing::Upload(const void *data, unsigned int size) {
+  if (size > SegmentSize) {
+    Destroy();
+    Create(std::max(size, std::max(SegmentSize * 2,
+                                   (unsigned int)UPLOAD_RING_DEFAULT_SIZE)));
+  }
+
+  Offset = Align(Offset);
+  if (Offset + size > SegmentSize) {
+    if (Persistent) {
+      NextSegment();
+    } else {
+      // orphaning hands the old storage to the driver instead of stalling
+      glBindBuffer(GL_UNIFORM_BUFFER, BufferId);
+      glBufferData(GL_UNIFORM_BUFFER, SegmentSize, nullptr, GL_STREAM_DRAW);
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+      Offset = 0;
+    }
+  }
+
+  unsigned int offset = Offset;
+  Offset += size;
+  if (Persistent) {
+    offset += Segment * SegmentSize;
+    memcpy(MappedData + offset, data, size);
+    return offset;
+  }
+  glBindBuffer(GL_UNIFORM_BUFFER, BufferId);
+  glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  return offset;
+}
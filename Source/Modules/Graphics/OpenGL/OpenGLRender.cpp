@@ -1,5 +1,9 @@
 #include "Modules/Graphics/OpenGL/OpenGLRender.h"
 #include "Core.h"
+#include "Modules/Graphics/OpenGL/OglBufferManager.h"
+#include "Modules/Graphics/OpenGL/OglMultiDraw.h"
+#include "Modules/Graphics/OpenGL/OglUploadQueue.h"
+#include "Modules/Graphics/OpenGL/OglUploadRing.h"
 #include "Modules/Graphics/OpenGL/OglShaderManager.h"
 #include "Modules/Graphics/OpenGL/OglTextureManager.h"
 #include "Modules/Graphics/OpenGL/VaoMeshManager.h"
@@ -49,12 +53,20 @@ OpenGLRender::OpenGLRender() {
   ShaderManager = new OglShaderManager();
   MeshManager = new VaoMeshManager();
   TextureManager = new OglTextureManager();
+  BufferManager = new OglBufferManager();
+  UploadRing = new OglUploadRing();
+  UploadQueue = new OglUploadQueue();
+  MultiDraw = new OglMultiDraw();
 }
 
 OpenGLRender::~OpenGLRender() {
   delete ShaderManager;
   delete MeshManager;
   delete TextureManager;
+  delete BufferManager;
+  delete UploadRing;
+  delete UploadQueue;
+  delete MultiDraw;
 
   glfwDestroyWindow(Window);
   glfwTerminate();
@@ -120,12 +132,29 @@ OglShaderManager *OpenGLRender::GetShaderManager() { return ShaderManager; }
 
 OglTextureManager *OpenGLRender::GetTextureManager() { return TextureManager; }
 
+OglBufferManager *OpenGLRender::GetBufferManager() { return BufferManager; }
+
+OglUploadRing *OpenGLRender::GetUploadRing() { return UploadRing; }
+
+OglUploadQueue *OpenGLRender::GetUploadQueue() { return UploadQueue; }
+
+OglMultiDraw *OpenGLRender::GetMultiDraw() { return MultiDraw; }
+
 bool OpenGLRender::IsWindowCreated() { return Window != nullptr; }
 
 void OpenGLRender::Update() {
+  Present();
+  PollEvents();
+}
 
-  Statics::Get<IInput>()->Update();
+void OpenGLRender::Present() {
+  // resources requested by this frame are ready for the next ones
+  UploadQueue->Process(MeshManager, TextureManager);
   glfwSwapBuffers(Window);
+}
+
+void OpenGLRender::PollEvents() {
+  Statics::Get<IInput>()->Update();
   glfwPollEvents();
 
   double x, y;
@@ -133,6 +162,10 @@ void OpenGLRender::Update() {
   Statics::Get<IInput>()->SetMousePosition(x, y);
 }
 
+void OpenGLRender::AcquireContext() { glfwMakeContextCurrent(Window); }
+
+void OpenGLRender::ReleaseContext() { glfwMakeContextCurrent(NULL); }
+
 void OpenGLRender::Cleanup() {
   MeshManager->DeleteUnusedResources();
   TextureManager->DeleteUnusedResources();
@@ -1,176 +1,490 @@
 #include "Modules/Graphics/OpenGL/VaoMeshManager.h"
 #include "Engine/AssetTypes/Mesh.h"
 #include "Modules/Graphics/OpenGL/BuiltInUniformNames.h"
+#include "Modules/Graphics/OpenGL/OglMultiDraw.h"
+#include "Modules/Graphics/OpenGL/OglShaderManager.h"
+#include "Modules/Graphics/OpenGL/OglUploadQueue.h"
 #include "Modules/Statics/IAssetManager.h"
 #include "Utility/Graphics.h"
 
+#ifndef GL_INT_2_10_10_10_REV
+#define GL_INT_2_10_10_10_REV 0x8D9F
+#endif
+
 #include "Modules/Graphics/OpenGL/OpenGLRender.h"
+#include <algorithm>
+#include <glm/gtc/packing.hpp>
+#include <glm/packing.hpp>
 #include <iostream>
 
 VaoMeshManager::VaoMeshManager() {}
 
 void VaoMeshManager::DeleteUnusedResources() {
-  typedef std::unordered_map<unsigned int, unsigned int> IntMapType;
-  typedef std::unordered_map<int, IntMapType> VaoMapType;
-
-  VaoMapType::iterator programIdIterator;
-  IntMapType::iterator uintMapIterator;
-
-  IntMapType VaoIdToMeshId;
-  for (programIdIterator = VaoMap.begin(); programIdIterator != VaoMap.end();
-       programIdIterator++) {
-    IntMapType &map = programIdIterator->second;
-    for (uintMapIterator = map.begin(); uintMapIterator != map.end();
-         uintMapIterator++)
-      VaoIdToMeshId[uintMapIterator->second] = uintMapIterator->first;
-  }
-
-  std::vector<unsigned int> meshesToRemove;
   IAssetManager *assetManager = Statics::Get<IAssetManager>();
-  for (uintMapIterator = VaoIdToMeshId.begin();
-       uintMapIterator != VaoIdToMeshId.end(); uintMapIterator++) {
-    unsigned int meshId = uintMapIterator->second;
-    Mesh *mesh = assetManager->GetAssetOfType<Mesh>(meshId);
-    if (mesh)
+  std::unordered_map<unsigned int, MeshBuffers>::iterator it;
+  for (it = Meshes.begin(); it != Meshes.end();) {
+    if (assetManager->GetAssetOfType<Mesh>(it->first)) {
+      it++;
       continue;
-    // mesh was deleted
-    meshesToRemove.push_back(uintMapIterator->second);
-    std::vector<int> vboToDelete;
-    unsigned vaoId = uintMapIterator->first;
-    int attribCount = 0;
-
-    std::unordered_map<unsigned int, unsigned int>::iterator
-        indexCountIterator = IndexCountMap.find(vaoId);
-    if (indexCountIterator != IndexCountMap.end())
-      IndexCountMap.erase(indexCountIterator);
-
-    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &attribCount);
-    glBindVertexArray(vaoId);
-    for (int currentAttrib = 0; currentAttrib < attribCount; currentAttrib++) {
-      int vboId = 0;
-      glGetVertexAttribiv(currentAttrib, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING,
-                          &vboId);
-      if (vboId > 0)
-        vboToDelete.push_back(vboId);
-    }
-    glDeleteVertexArrays(1, &vaoId);
-    for (unsigned int x = 0; x < vboToDelete.size(); x++) {
-      unsigned int vboId = vboToDelete[x];
-      glDeleteBuffers(1, &vboId);
     }
+    // mesh was deleted
+    DeleteMeshBuffers(it->second);
+    it = Meshes.erase(it);
   }
-  // delete records of the mesh asset
-  for (programIdIterator = VaoMap.begin(); programIdIterator != VaoMap.end();
-       programIdIterator++) {
-    IntMapType &map = programIdIterator->second;
-    for (unsigned int x = 0; x < meshesToRemove.size(); x++) {
-      uintMapIterator = map.find(meshesToRemove[x]);
-      if (uintMapIterator != map.end())
-        map.erase(uintMapIterator);
+
+  // the ranges of packed meshes are handed to the next meshes packed, the
+  // buffers themselves keep their size
+  std::unordered_map<unsigned int, PackedMesh>::iterator packedIt;
+  for (packedIt = PackedMeshes.begin(); packedIt != PackedMeshes.end();) {
+    if (assetManager->GetAssetOfType<Mesh>(packedIt->first)) {
+      packedIt++;
+      continue;
     }
+    PackedMesh &packed = packedIt->second;
+    BatchVertices.Free(packed.FirstVertex, packed.VertexCount);
+    BatchIndices.Free(packed.FirstIndex, packed.IndexCount);
+    packedIt = PackedMeshes.erase(packedIt);
   }
+  std::unordered_set<unsigned int>::iterator separateIt;
+  for (separateIt = SeparateMeshes.begin();
+       separateIt != SeparateMeshes.end();)
+    if (Meshes.find(*separateIt) == Meshes.end())
+      separateIt = SeparateMeshes.erase(separateIt);
+    else
+      separateIt++;
 }
 
-struct Vertex_xyz_nxnynz_txtytz {
-  float x, y, z, nx, ny, nz, tx, ty, tz;
-};
-
-void VaoMeshManager::GetVAOForMeshId(int programId, unsigned int meshAssetId,
-                                     unsigned int &vaoId,
-                                     unsigned int &indexCount) {
-  // nested map
-  // program_id -> map -> mesh_asset_id
-  std::unordered_map<unsigned int, unsigned int>::iterator it =
-      VaoMap[programId].find(meshAssetId);
-  if (it == VaoMap[programId].end()) {
-    // get mesh
-    Mesh *mesh =
-        Statics::Get<IAssetManager>()->GetAssetOfType<Mesh>(meshAssetId);
-    if (!mesh)
-      throw 1;
-
-    // load mesh data to gpu
-    glGenVertexArrays(1, &(vaoId));
-    glBindVertexArray(vaoId);
-
-    unsigned int vertexBufferId;
-    glGenBuffers(1, &(vertexBufferId));
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
-
-    unsigned int vertexCount =
-        static_cast<unsigned int>(mesh->Positions.size());
-
-    unsigned int vertexBufferSizeInBytes =
-        sizeof(Vertex_xyz_nxnynz_txtytz) * vertexCount;
-
-    Vertex_xyz_nxnynz_txtytz *vboVertices =
-        new Vertex_xyz_nxnynz_txtytz[vertexCount];
-
-    for (unsigned int x = 0; x < vertexCount; x++) {
-      vboVertices[x].x = mesh->Positions[x].x;
-      vboVertices[x].y = mesh->Positions[x].y;
-      vboVertices[x].z = mesh->Positions[x].z;
-
-      vboVertices[x].nx = mesh->Normals[x].x;
-      vboVertices[x].ny = mesh->Normals[x].y;
-      vboVertices[x].nz = mesh->Normals[x].z;
-
-      vboVertices[x].tx = mesh->TexCoord[x].x;
-      vboVertices[x].ty = mesh->TexCoord[x].y;
-      vboVertices[x].tz = mesh->TexCoord[x].z;
+bool VaoMeshManager::CanPackMesh(Mesh *mesh) const {
+  unsigned char sharedCompression =
+      MESH_COMPRESS_NORMALS | MESH_COMPRESS_TEXCOORDS | MESH_COMPRESS_INDICES;
+  return (mesh->VertexCompression & sharedCompression) == sharedCompression &&
+         mesh->Positions.size() <= 0x10000;
+}
+
+void VaoMeshManager::FillBatchVertices(Mesh *mesh,
+                                       std::vector<BatchVertex> &vertices) {
+  unsigned int vertexCount = static_cast<unsigned int>(mesh->Positions.size());
+  vertices.resize(vertexCount);
+  for (unsigned int x = 0; x < vertexCount; x++) {
+    vertices[x].x = mesh->Positions[x].x;
+    vertices[x].y = mesh->Positions[x].y;
+    vertices[x].z = mesh->Positions[x].z;
+    vertices[x].Normal =
+        glm::packSnorm3x10_1x2(glm::vec4(mesh->Normals[x], 0.f));
+    vertices[x].TexCoord = glm::packHalf2x16(glm::vec2(mesh->TexCoord[x]));
+  }
+}
+
+void VaoMeshManager::SetBatchVertexAttributes() {
+  // the vertex buffer has to be bound to GL_ARRAY_BUFFER
+  glEnableVertexAttribArray(PositionAttributeLocation);
+  glVertexAttribPointer(PositionAttributeLocation, 3, GL_FLOAT, GL_FALSE,
+                        sizeof(BatchVertex), (void *)offsetof(BatchVertex, x));
+  glEnableVertexAttribArray(NormalAttributeLocation);
+  glVertexAttribPointer(NormalAttributeLocation, 4, GL_INT_2_10_10_10_REV,
+                        GL_TRUE, sizeof(BatchVertex),
+                        (void *)offsetof(BatchVertex, Normal));
+  glEnableVertexAttribArray(TexCoordAttributeLocation);
+  glVertexAttribPointer(TexCoordAttributeLocation, 2, GL_HALF_FLOAT, GL_FALSE,
+                        sizeof(BatchVertex),
+                        (void *)offsetof(BatchVertex, TexCoord));
+}
+
+void VaoMeshManager::UploadCompactVertices(Mesh *mesh,
+                                           MeshBuffers &buffers) {
+  unsigned char compression = mesh->VertexCompression;
+  bool quantizePositions = (compression & MESH_QUANTIZE_POSITIONS) != 0;
+  bool compressNormals = (compression & MESH_COMPRESS_NORMALS) != 0;
+  bool compressTexCoords = (compression & MESH_COMPRESS_TEXCOORDS) != 0;
+
+  // 16 bit unorm positions are padded to 8 bytes to keep 4 byte alignment
+  unsigned int positionSize = quantizePositions ? 8 : 12;
+  unsigned int normalSize = compressNormals ? 4 : 12;
+  unsigned int texCoordSize = compressTexCoords ? 4 : 12;
+  unsigned int stride = positionSize + normalSize + texCoordSize;
+
+  glm::vec3 boundsMin = mesh->Bounds.GetMin();
+  glm::vec3 boundsSize = mesh->Bounds.Extents * 2.f;
+  glm::vec3 inverseSize(0.f);
+  for (unsigned char axis = 0; axis < 3; axis++)
+    if (boundsSize[axis] > 0.f)
+      inverseSize[axis] = 1.f / boundsSize[axis];
+  buffers.QuantizedPositions = quantizePositions;
+  buffers.PositionScale = glm::vec4(boundsSize, 1.f);
+  buffers.PositionOffset = glm::vec4(boundsMin, 0.f);
+
+  unsigned int vertexCount = static_cast<unsigned int>(mesh->Positions.size());
+  std::vector<unsigned char> vertices(vertexCount * stride);
+  for (unsigned int x = 0; x < vertexCount; x++) {
+    unsigned char *vertex = &vertices[x * stride];
+    if (quantizePositions) {
+      glm::vec3 normalized = (mesh->Positions[x] - boundsMin) * inverseSize;
+      glm::uint64 packed = glm::packUnorm4x16(glm::vec4(normalized, 0.f));
+      memcpy(vertex, &packed, 8);
+    } else {
+      memcpy(vertex, &mesh->Positions[x], 12);
+    }
+    vertex += positionSize;
+
+    if (compressNormals) {
+      glm::uint32 packed =
+          glm::packSnorm3x10_1x2(glm::vec4(mesh->Normals[x], 0.f));
+      memcpy(vertex, &packed, 4);
+    } else {
+      memcpy(vertex, &mesh->Normals[x], 12);
     }
+    vertex += normalSize;
 
-    S_LOG_FUNC("Loaded mesh #%d", mesh->UniqueID());
+    if (compressTexCoords) {
+      glm::uint packed = glm::packHalf2x16(glm::vec2(mesh->TexCoord[x]));
+      memcpy(vertex, &packed, 4);
+    } else {
+      memcpy(vertex, &mesh->TexCoord[x], 12);
+    }
+  }
 
-    // static draw
-    glBufferData(GL_ARRAY_BUFFER, vertexBufferSizeInBytes, vboVertices,
-                 GL_STATIC_DRAW);
+  glGenBuffers(1, &buffers.VertexBufferId);
+  glBindBuffer(GL_ARRAY_BUFFER, buffers.VertexBufferId);
+  glBufferData(GL_ARRAY_BUFFER, vertices.size(), vertices.data(),
+               GL_STATIC_DRAW);
+  buffers.SizeInBytes += static_cast<unsigned int>(vertices.size());
 
-    unsigned int indexBufferId = 0;
-    unsigned int *indicesPointer = &mesh->Indices[0];
-    indexCount = static_cast<unsigned int>(mesh->Indices.size());
+  unsigned int offset = 0;
+  glEnableVertexAttribArray(PositionAttributeLocation);
+  if (quantizePositions)
+    glVertexAttribPointer(PositionAttributeLocation, 3, GL_UNSIGNED_SHORT,
+                          GL_TRUE, stride, (void *)(size_t)offset);
+  else
+    glVertexAttribPointer(PositionAttributeLocation, 3, GL_FLOAT, GL_FALSE,
+                          stride, (void *)(size_t)offset);
+  offset += positionSize;
 
-    glGenBuffers(1, &(indexBufferId)); // vertex_buffer
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
+  glEnableVertexAttribArray(NormalAttributeLocation);
+  if (compressNormals)
+    glVertexAttribPointer(NormalAttributeLocation, 4, GL_INT_2_10_10_10_REV,
+                          GL_TRUE, stride, (void *)(size_t)offset);
+  else
+    glVertexAttribPointer(NormalAttributeLocation, 3, GL_FLOAT, GL_FALSE,
+                          stride, (void *)(size_t)offset);
+  offset += normalSize;
 
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indexCount,
-                 indicesPointer, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(TexCoordAttributeLocation);
+  if (compressTexCoords)
+    glVertexAttribPointer(TexCoordAttributeLocation, 2, GL_HALF_FLOAT,
+                          GL_FALSE, stride, (void *)(size_t)offset);
+  else
+    glVertexAttribPointer(TexCoordAttributeLocation, 3, GL_FLOAT, GL_FALSE,
+                          stride, (void *)(size_t)offset);
+}
 
-    GLint posLocation = glGetAttribLocation(programId, PositionAttributeName);
-    GLint normalLocation = glGetAttribLocation(programId, NormalAttributeName);
-    GLint texcoordLocation =
-        glGetAttribLocation(programId, TexCoordAttributeName);
+const VaoMeshManager::MeshBuffers *
+VaoMeshManager::GetMeshBuffers(unsigned int meshAssetId,
+                               OglUploadQueue *uploadQueue) {
+  std::unordered_map<unsigned int, MeshBuffers>::iterator it =
+      Meshes.find(meshAssetId);
+  if (it != Meshes.end())
+    return &it->second;
+  uploadQueue->Request(OglUploadQueue::ResourceMesh, meshAssetId);
+  return nullptr;
+}
 
-    glEnableVertexAttribArray(posLocation);
-    glVertexAttribPointer(posLocation, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex_xyz_nxnynz_txtytz),
-                          (void *)offsetof(Vertex_xyz_nxnynz_txtytz, x));
-    glEnableVertexAttribArray(normalLocation);
-    glVertexAttribPointer(normalLocation, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex_xyz_nxnynz_txtytz),
-                          (void *)offsetof(Vertex_xyz_nxnynz_txtytz, nx));
-    glEnableVertexAttribArray(texcoordLocation);
-    glVertexAttribPointer(texcoordLocation, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex_xyz_nxnynz_txtytz),
-                          (void *)offsetof(Vertex_xyz_nxnynz_txtytz, tx));
+unsigned int VaoMeshManager::UploadMesh(unsigned int meshAssetId) {
+  if (Meshes.find(meshAssetId) != Meshes.end() ||
+      PackedMeshes.find(meshAssetId) != PackedMeshes.end())
+    return 0;
 
-    glBindVertexArray(0);
+  // get mesh
+  Mesh *mesh = Statics::Get<IAssetManager>()->GetAssetOfType<Mesh>(meshAssetId);
+  if (!mesh)
+    throw 1;
 
-    glDisableVertexAttribArray(posLocation);
-    glDisableVertexAttribArray(normalLocation);
-    glDisableVertexAttribArray(texcoordLocation);
+  MeshBuffers buffers;
+  // load mesh data to gpu
+  glGenVertexArrays(1, &buffers.VaoId);
+  glBindVertexArray(buffers.VaoId);
+  UploadCompactVertices(mesh, buffers);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  // every lod lives in the same index buffer
+  std::vector<unsigned int> indices;
+  GatherLodIndices(mesh, indices, buffers.Lods);
 
-    VaoMap[programId][meshAssetId] = vaoId;
-    IndexCountMap[vaoId] = indexCount;
+  // 16 bit indices whenever every vertex can be addressed
+  buffers.IndexCount = static_cast<unsigned int>(indices.size());
+  bool shortIndices = (mesh->VertexCompression & MESH_COMPRESS_INDICES) &&
+                      mesh->Positions.size() <= 0x10000;
+  std::vector<unsigned short> shortIndexData;
+  const void *indexData = indices.data();
+  unsigned int indexBytes = buffers.IndexCount * sizeof(unsigned int);
+  buffers.IndexType = GL_UNSIGNED_INT;
+  if (shortIndices) {
+    shortIndexData.assign(indices.begin(), indices.end());
+    indexData = shortIndexData.data();
+    indexBytes = buffers.IndexCount * sizeof(unsigned short);
+    buffers.IndexType = GL_UNSIGNED_SHORT;
+  }
+  glGenBuffers(1, &buffers.IndexBufferId);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.IndexBufferId);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indexData,
+               GL_STATIC_DRAW);
+  buffers.SizeInBytes += indexBytes;
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  MemoryUsage += buffers.SizeInBytes;
+  S_LOG_FUNC("Loaded mesh #%d, %d bytes", mesh->UniqueID(),
+             buffers.SizeInBytes);
+  Meshes[meshAssetId] = buffers;
+  return buffers.SizeInBytes;
+}
 
-    delete[] vboVertices;
+void VaoMeshManager::SetPositionDequantization(
+    OglShaderManager *shaderManager, int programId,
+    const MeshBuffers *buffers) {
+  if (buffers && !buffers->QuantizedPositions)
+    buffers = nullptr;
+  // uniform values stay with the program, only changes are sent
+  std::unordered_map<int, const MeshBuffers *>::iterator it =
+      ProgramDequantization.find(programId);
+  if (it != ProgramDequantization.end() && it->second == buffers)
     return;
+  ProgramDequantization[programId] = buffers;
+  glm::vec4 scale = buffers ? buffers->PositionScale : glm::vec4(0.f);
+  glm::vec4 offset = buffers ? buffers->PositionOffset : glm::vec4(0.f);
+  OglShaderManager::UniformLocationTable *uniformLocations =
+      shaderManager->GetUniformLocationTable(programId);
+  glUniform4fv(shaderManager->GetUniformLocation(uniformLocations, programId,
+                                                 PositionScaleHandle),
+               1, &scale[0]);
+  glUniform4fv(shaderManager->GetUniformLocation(uniformLocations, programId,
+                                                 PositionOffsetHandle),
+               1, &offset[0]);
+}
+
+void VaoMeshManager::DrawMesh(const MeshBuffers &buffers, unsigned int lod) {
+  const MeshRange &range = buffers.GetLod(lod);
+  unsigned int indexSize = buffers.IndexType == GL_UNSIGNED_SHORT
+                               ? sizeof(unsigned short)
+                               : sizeof(unsigned int);
+  glBindVertexArray(buffers.VaoId);
+  glDrawElements(GL_TRIANGLES, range.IndexCount, buffers.IndexType,
+                 (void *)(size_t)(range.FirstIndex * indexSize));
+  glBindVertexArray(0);
+}
+
+unsigned int VaoMeshManager::GrowBuffer(unsigned int target,
+                                        unsigned int bufferId,
+                                        unsigned int usedBytes,
+                                        unsigned int newBytes) {
+  unsigned int newBufferId;
+  glGenBuffers(1, &newBufferId);
+  glBindBuffer(target, newBufferId);
+  glBufferData(target, newBytes, nullptr, GL_STATIC_DRAW);
+  if (bufferId && usedBytes) {
+    glBindBuffer(GL_COPY_READ_BUFFER, bufferId);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, target, 0, 0, usedBytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  }
+  if (bufferId)
+    glDeleteBuffers(1, &bufferId);
+  return newBufferId;
+}
+
+void VaoMeshManager::DeleteMeshBuffers(MeshBuffers &buffers) {
+  // the state of programs using the mesh becomes unknown
+  std::unordered_map<int, const MeshBuffers *>::iterator programIt;
+  for (programIt = ProgramDequantization.begin();
+       programIt != ProgramDequantization.end();)
+    if (programIt->second == &buffers)
+      programIt = ProgramDequantization.erase(programIt);
+    else
+      programIt++;
+  glDeleteVertexArrays(1, &buffers.VaoId);
+  glDeleteBuffers(1, &buffers.VertexBufferId);
+  glDeleteBuffers(1, &buffers.IndexBufferId);
+  MemoryUsage -= buffers.SizeInBytes;
+}
+
+void VaoMeshManager::DeleteBatchVAO() {
+  if (BatchVao)
+    glDeleteVertexArrays(1, &BatchVao);
+  BatchVao = 0;
+  if (PackedMeshVao)
+    glDeleteVertexArrays(1, &PackedMeshVao);
+  PackedMeshVao = 0;
+}
+
+void VaoMeshManager::GatherLodIndices(Mesh *mesh,
+                                      std::vector<unsigned int> &indices,
+                                      std::vector<MeshRange> &lods) {
+  indices = mesh->Indices;
+  indices.insert(indices.end(), mesh->LodIndices.begin(),
+                 mesh->LodIndices.end());
+  lods.resize(mesh->GetLodCount());
+  unsigned int firstIndex = 0;
+  for (unsigned int x = 0; x < lods.size(); x++) {
+    lods[x].FirstIndex = firstIndex;
+    lods[x].IndexCount =
+        x == 0 ? static_cast<unsigned int>(mesh->Indices.size())
+               : mesh->LodIndexCounts[x - 1];
+    lods[x].BaseVertex = 0;
+    firstIndex += lods[x].IndexCount;
+  }
+}
+
+bool VaoMeshManager::GetMeshRange(unsigned int meshAssetId, unsigned int lod,
+                                  MeshRange &range,
+                                  OglUploadQueue *uploadQueue) {
+  if (GetPackedMeshRange(meshAssetId, lod, range))
+    return true;
+  if (!IsDrawnSeparately(meshAssetId))
+    uploadQueue->Request(OglUploadQueue::ResourceBatchMesh, meshAssetId);
+  return false;
+}
+
+bool VaoMeshManager::GetPackedMeshRange(unsigned int meshAssetId,
+                                        unsigned int lod,
+                                        MeshRange &range) const {
+  std::unordered_map<unsigned int, PackedMesh>::const_iterator it =
+      PackedMeshes.find(meshAssetId);
+  if (it == PackedMeshes.end())
+    return false;
+  const std::vector<MeshRange> &lods = it->second.Lods;
+  range = lods[std::min(lod, (unsigned int)lods.size() - 1)];
+  return true;
+}
+
+void VaoMeshManager::DrawPackedMesh(const MeshRange &range) {
+  if (PackedMeshVao == 0) {
+    glGenVertexArrays(1, &PackedMeshVao);
+    glBindVertexArray(PackedMeshVao);
+    glBindBuffer(GL_ARRAY_BUFFER, BatchVertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BatchIndexBuffer);
+    SetBatchVertexAttributes();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+  glBindVertexArray(PackedMeshVao);
+  glDrawElementsBaseVertex(
+      GL_TRIANGLES, range.IndexCount, GL_UNSIGNED_SHORT,
+      (void *)(size_t)(range.FirstIndex * sizeof(unsigned short)),
+      range.BaseVertex);
+  glBindVertexArray(0);
+}
+
+unsigned int VaoMeshManager::PackBatchMesh(unsigned int meshAssetId) {
+  if (PackedMeshes.find(meshAssetId) != PackedMeshes.end() ||
+      IsDrawnSeparately(meshAssetId))
+    return 0;
+
+  Mesh *mesh = Statics::Get<IAssetManager>()->GetAssetOfType<Mesh>(meshAssetId);
+  if (!mesh)
+    throw 1;
+  if (!CanPackMesh(mesh)) {
+    SeparateMeshes.insert(meshAssetId);
+    return UploadMesh(meshAssetId);
+  }
+  std::vector<BatchVertex> vertices;
+  FillBatchVertices(mesh, vertices);
+  PackedMesh packed;
+  std::vector<unsigned int> lodIndices;
+  GatherLodIndices(mesh, lodIndices, packed.Lods);
+  std::vector<unsigned short> indices(lodIndices.begin(), lodIndices.end());
+  packed.VertexCount = static_cast<unsigned int>(vertices.size());
+  packed.IndexCount = static_cast<unsigned int>(indices.size());
+
+  // contents up to the used counts are kept when the buffers grow
+  unsigned int usedVertices = BatchVertices.GetUsedCount();
+  unsigned int usedIndices = BatchIndices.GetUsedCount();
+  packed.FirstVertex = BatchVertices.Allocate(packed.VertexCount);
+  packed.FirstIndex = BatchIndices.Allocate(packed.IndexCount);
+
+  // the element buffer binding is vao state, keep the vaos out of it
+  glBindVertexArray(0);
+  bool grown = false;
+  if (BatchVertices.GetUsedCount() > BatchVertexCapacity) {
+    unsigned int capacity =
+        std::max(BatchVertexCapacity * 2, BatchVertices.GetUsedCount());
+    BatchVertexBuffer = GrowBuffer(GL_ARRAY_BUFFER, BatchVertexBuffer,
+                                   usedVertices * sizeof(BatchVertex),
+                                   capacity * sizeof(BatchVertex));
+    MemoryUsage += (capacity - BatchVertexCapacity) * sizeof(BatchVertex);
+    BatchVertexCapacity = capacity;
+    grown = true;
+  }
+  if (BatchIndices.GetUsedCount() > BatchIndexCapacity) {
+    unsigned int capacity =
+        std::max(BatchIndexCapacity * 2, BatchIndices.GetUsedCount());
+    BatchIndexBuffer = GrowBuffer(GL_ELEMENT_ARRAY_BUFFER, BatchIndexBuffer,
+                                  usedIndices * sizeof(unsigned short),
+                                  capacity * sizeof(unsigned short));
+    MemoryUsage += (capacity - BatchIndexCapacity) * sizeof(unsigned short);
+    BatchIndexCapacity = capacity;
+    grown = true;
+  }
+  // the vao still points at the old buffers
+  if (grown)
+    DeleteBatchVAO();
+
+  glBindBuffer(GL_ARRAY_BUFFER, BatchVertexBuffer);
+  glBufferSubData(GL_ARRAY_BUFFER, packed.FirstVertex * sizeof(BatchVertex),
+                  packed.VertexCount * sizeof(BatchVertex), vertices.data());
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BatchIndexBuffer);
+  glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                  packed.FirstIndex * sizeof(unsigned short),
+                  packed.IndexCount * sizeof(unsigned short), indices.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  for (unsigned int x = 0; x < packed.Lods.size(); x++) {
+    packed.Lods[x].FirstIndex += packed.FirstIndex;
+    packed.Lods[x].BaseVertex = static_cast<int>(packed.FirstVertex);
+  }
+  PackedMeshes[meshAssetId] = packed;
+  // renderers that aren't batched draw from the shared buffers from now on,
+  // the buffers uploaded for them would hold the mesh a second time
+  std::unordered_map<unsigned int, MeshBuffers>::iterator uploaded =
+      Meshes.find(meshAssetId);
+  if (uploaded != Meshes.end()) {
+    DeleteMeshBuffers(uploaded->second);
+    Meshes.erase(uploaded);
+  }
+  S_LOG_FUNC("Packed mesh #%d into the batch buffers", mesh->UniqueID());
+  return packed.VertexCount * sizeof(BatchVertex) +
+         packed.IndexCount * sizeof(unsigned short);
+}
+
+unsigned int VaoMeshManager::GetBatchVAO(OglMultiDraw *multiDraw) {
+  if (BatchVao)
+    return BatchVao;
+
+  glGenVertexArrays(1, &BatchVao);
+  glBindVertexArray(BatchVao);
+  glBindBuffer(GL_ARRAY_BUFFER, BatchVertexBuffer);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BatchIndexBuffer);
+  SetBatchVertexAttributes();
+
+  if (multiDraw->IsSupported()) {
+    if (DrawIndexBuffer == 0) {
+      std::vector<float> drawIndices(MAX_BATCH_DRAWS * 2);
+      for (unsigned int x = 0; x < MAX_BATCH_DRAWS; x++) {
+        drawIndices[x * 2] = static_cast<float>(x);
+        drawIndices[x * 2 + 1] = 1.f;
+      }
+      glGenBuffers(1, &DrawIndexBuffer);
+      glBindBuffer(GL_ARRAY_BUFFER, DrawIndexBuffer);
+      glBufferData(GL_ARRAY_BUFFER, drawIndices.size() * sizeof(float),
+                   drawIndices.data(), GL_STATIC_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, DrawIndexBuffer);
+    glEnableVertexAttribArray(DrawIndexAttributeLocation);
+    glVertexAttribPointer(DrawIndexAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0,
+                          0);
+    multiDraw->SetAttributeDivisor(DrawIndexAttributeLocation, 1);
   }
 
-  vaoId = it->second;
-  indexCount = IndexCountMap[vaoId];
-  return;
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  return BatchVao;
 }
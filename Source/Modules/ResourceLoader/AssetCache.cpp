@@ -0,0 +1,90 @@
+#include "Modules/ResourceLoader/AssetCache.h"
+#include "Modules/ResourceLoader/ResourceLoader.h"
+#include "Utility/Data/DataNode.h"
+#include "Utility/Data/ISerialized.h"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#if defined _WIN32 || defined _WIN64
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace AssetCache {
+bool GetKey(const String &sourceFileName, unsigned long long &key) {
+  const unsigned char *data = nullptr;
+  size_t size = 0;
+  std::shared_ptr<void> owner;
+  if (!ResourceLoader::MapFile(sourceFileName, data, size, owner))
+    return false;
+
+  // fnv-1a over 8 byte words, the tail byte by byte
+  const unsigned long long prime = 0x100000001b3ULL;
+  unsigned long long hash = 0xcbf29ce484222325ULL;
+  size_t x = 0;
+  for (; x + sizeof(unsigned long long) <= size;
+       x += sizeof(unsigned long long)) {
+    unsigned long long word;
+    memcpy(&word, data + x, sizeof(word));
+    hash = (hash ^ word) * prime;
+  }
+  for (; x < size; x++)
+    hash = (hash ^ data[x]) * prime;
+  hash = (hash ^ size) * prime;
+  key = (hash ^ ASSET_IMPORTER_VERSION) * prime;
+  return true;
+}
+
+String GetPath(unsigned long long key) {
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.ssd", key);
+  return String(ASSET_CACHE_DIRECTORY) + name;
+}
+
+IObject *Load(unsigned long long key) {
+  String path = GetPath(key);
+  std::vector<IDataNode *> nodes;
+  if (!ResourceLoader::GetFileSize(path) ||
+      !ResourceLoader::LoadSsd(path, nodes))
+    return nullptr;
+  IObject *asset = nullptr;
+  if (nodes.size() == 1)
+    asset = dynamic_cast<IObject *>(nodes[0]->Deserialize());
+  for (size_t x = 0; x < nodes.size(); x++)
+    delete nodes[x];
+  return asset;
+}
+
+bool Save(unsigned long long key, IObject *asset) {
+#if defined _WIN32 || defined _WIN64
+  _mkdir(ASSET_CACHE_DIRECTORY);
+#else
+  mkdir(ASSET_CACHE_DIRECTORY, 0755);
+#endif
+  std::vector<ISerialized *> attributes;
+  asset->GetAllAttributes(attributes);
+  std::vector<IDataNode *> nodes;
+  // unique ids are given out on load
+  DataNode node(asset->SerializedName(), 0, attributes, nodes);
+  nodes.push_back(&node);
+
+  // written under a name of its own and moved in place, loads never see a
+  // partial file and two threads cooking the same contents don't clash
+  String path = GetPath(key);
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".%zx",
+           std::hash<std::thread::id>()(std::this_thread::get_id()));
+  String temporaryPath = path + suffix;
+  if (!ResourceLoader::SaveSsd(temporaryPath, nodes))
+    return false;
+  if (rename(temporaryPath.GetCharArray(), path.GetCharArray()) != 0) {
+    remove(temporaryPath.GetCharArray());
+    return false;
+  }
+  return true;
+}
+} // namespace AssetCache
@@ -3,6 +3,7 @@
 #include <iostream>
 
 #include "Engine/AssetTypes/Texture2D.h"
+#include "Modules/Utility/TextureUtils.h"
 #include "Utility/Data/SerializedFactory.h"
 
 
@@ -49,10 +50,12 @@ bool ReadBitmapToTexture(const char *fileName, IObject *texture) {
   }
   tex->Name = fileName;
   tex->SetPixels(width, height, pixels32);
+  // the encoded texture is kept in the AssetCache by the loader and by
+  // --cook, so this only runs for bitmaps that weren't cooked yet
+  TextureUtils::Import(tex, Texture2D::Auto);
 
   delete[] pixelsRaw;
   delete[] pixels32;
-  fclose(file);
   return true;
 }
 }; // namespace BitmapReader
@@ -0,0 +1,96 @@
+#include "Modules/ResourceLoader/MappedFile.h"
+
+#if defined _WIN32 || defined _WIN64
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() {}
+
+MappedFile::~MappedFile() { Close(); }
+
+#if defined _WIN32 || defined _WIN64
+bool MappedFile::Open(const String &fileName) {
+  Close();
+  HANDLE file = CreateFileA(fileName.GetCharArray(), GENERIC_READ,
+                            FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!mapping) {
+    CloseHandle(file);
+    return false;
+  }
+
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  FileHandle = file;
+  MappingHandle = mapping;
+  Data = (const unsigned char *)view;
+  Size = (size_t)fileSize.QuadPart;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (Data)
+    UnmapViewOfFile(Data);
+  if (MappingHandle)
+    CloseHandle(MappingHandle);
+  if (FileHandle)
+    CloseHandle(FileHandle);
+  Data = nullptr;
+  Size = 0;
+  MappingHandle = nullptr;
+  FileHandle = nullptr;
+}
+#else
+bool MappedFile::Open(const String &fileName) {
+  Close();
+  int file = open(fileName.GetCharArray(), O_RDONLY);
+  if (file < 0)
+    return false;
+
+  struct stat fileStat;
+  if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0) {
+    close(file);
+    return false;
+  }
+
+  void *view =
+      mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+  // the mapping keeps its own reference to the file
+  close(file);
+  if (view == MAP_FAILED)
+    return false;
+
+  // the file is parsed front to back once
+  madvise(view, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+  Data = (const unsigned char *)view;
+  Size = (size_t)fileStat.st_size;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (Data)
+    munmap((void *)Data, Size);
+  Data = nullptr;
+  Size = 0;
+}
+#endif
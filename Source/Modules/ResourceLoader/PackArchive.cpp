@@ -0,0 +1,235 @@
+#include "Modules/ResourceLoader/PackArchive.h"
+#include "Modules/ResourceLoader/MappedFile.h"
+#include "Utility/Data/Lz4.h"
+#include "Utility/Data/Pack.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+
+PackArchive::PackArchive() {}
+
+bool PackArchive::Open(const String &fileName) {
+  FileName = fileName;
+  File = std::make_shared<MappedFile>();
+  if (!File->Open(fileName)) {
+    LastError = "Couldn't map the archive " + fileName;
+    File.reset();
+    return false;
+  }
+  const unsigned char *data = File->GetData();
+  size_t size = File->GetSize();
+  Header = (const Pack::Header *)data;
+  if (size < sizeof(Pack::Header) || memcmp(Header->Signature, "SPAK", 4) ||
+      Header->Version != Pack::Version) {
+    LastError = "Not a pack archive " + fileName;
+    File.reset();
+    return false;
+  }
+  if (Header->IndexOffset + (unsigned long long)Header->EntryCount *
+                                sizeof(Pack::Entry) >
+          size ||
+      Header->PathsOffset + Header->PathsSize > size ||
+      Header->IndexOffset % sizeof(unsigned long long)) {
+    LastError = "Corrupt archive index " + fileName;
+    File.reset();
+    return false;
+  }
+  Entries = (const Pack::Entry *)(data + Header->IndexOffset);
+  Paths = (const char *)(data + Header->PathsOffset);
+  for (unsigned int x = 0; x < Header->EntryCount; x++) {
+    const Pack::Entry &entry = Entries[x];
+    if (entry.Offset + entry.StoredSize > size ||
+        entry.Path >= Header->PathsSize ||
+        !memchr(Paths + entry.Path, 0, Header->PathsSize - entry.Path)) {
+      LastError = "Corrupt archive entry in " + fileName;
+      File.reset();
+      return false;
+    }
+  }
+  return true;
+}
+
+const Pack::Entry *PackArchive::FindEntry(const String &path) {
+  if (!File)
+    return nullptr;
+  String normalizedPath = NormalizePath(path);
+  unsigned long long hash = HashPath(normalizedPath);
+  const Pack::Entry *end = Entries + Header->EntryCount;
+  const Pack::Entry *entry = std::lower_bound(
+      Entries, end, hash, [](const Pack::Entry &entry, unsigned long long h) {
+        return entry.PathHash < h;
+      });
+  // paths with the same hash are told apart by the stored path
+  for (; entry != end && entry->PathHash == hash; entry++) {
+    if (strcmp(Paths + entry->Path, normalizedPath.GetCharArray()) == 0)
+      return entry;
+  }
+  return nullptr;
+}
+
+bool PackArchive::Contains(const String &path) {
+  return FindEntry(path) != nullptr;
+}
+
+bool PackArchive::GetSize(const String &path, size_t &size) {
+  const Pack::Entry *entry = FindEntry(path);
+  if (!entry)
+    return false;
+  size = (size_t)entry->Size;
+  return true;
+}
+
+bool PackArchive::Read(const String &path, const unsigned char *&data,
+                       size_t &size, std::shared_ptr<void> &owner) {
+  const Pack::Entry *entry = FindEntry(path);
+  if (!entry)
+    return false;
+  const unsigned char *stored = File->GetData() + entry->Offset;
+  size = (size_t)entry->Size;
+  if (!(entry->Flags & Pack::CompressedFlag)) {
+    data = stored;
+    owner = File;
+    return true;
+  }
+
+  std::shared_ptr<std::vector<unsigned char>> decompressed =
+      std::make_shared<std::vector<unsigned char>>(size);
+  if (!Lz4::Decompress(stored, (size_t)entry->StoredSize,
+                       decompressed->data(), size))
+    return false;
+  data = decompressed->data();
+  owner = decompressed;
+  return true;
+}
+
+bool PackArchive::Write(const String &fileName,
+                        const std::vector<String> &files, bool compress,
+                        String &error) {
+  std::ofstream out(fileName.GetCharArray(),
+                    std::ios::binary | std::ios::out | std::ios::trunc);
+  if (!out.is_open()) {
+    error = "Couldn't write the archive " + fileName;
+    return false;
+  }
+
+  std::vector<Pack::Entry> entries;
+  std::vector<char> paths;
+  unsigned long long offset = sizeof(Pack::Header);
+  std::vector<unsigned char> padding(Pack::DataAlignment, 0);
+  Pack::Header header;
+  memset(&header, 0, sizeof(header));
+  out.write((const char *)&header, sizeof(header));
+
+  for (size_t x = 0; x < files.size(); x++) {
+    String path = NormalizePath(files[x]);
+    unsigned long long hash = HashPath(path);
+    bool duplicate = false;
+    for (size_t y = 0; y < entries.size() && !duplicate; y++)
+      duplicate = entries[y].PathHash == hash &&
+                  strcmp(&paths[entries[y].Path], path.GetCharArray()) == 0;
+    if (duplicate)
+      continue;
+
+    MappedFile file;
+    std::vector<unsigned char> emptyFile;
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+    if (file.Open(files[x])) {
+      data = file.GetData();
+      size = file.GetSize();
+    } else if (!std::ifstream(files[x].GetCharArray()).is_open()) {
+      // empty files can't be mapped but are fine to pack
+      error = "Couldn't read " + files[x];
+      return false;
+    }
+
+    Pack::Entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.PathHash = hash;
+    entry.Size = size;
+    entry.Path = (unsigned int)paths.size();
+    paths.insert(paths.end(), path.GetCharArray(),
+                 path.GetCharArray() + path.Length() + 1);
+
+    std::vector<unsigned char> compressed;
+    if (compress && size)
+      Lz4::Compress(data, size, compressed);
+    if (!compressed.empty() && compressed.size() < size) {
+      entry.Flags = Pack::CompressedFlag;
+      data = compressed.data();
+      size = compressed.size();
+    }
+
+    size_t pad = (size_t)((Pack::DataAlignment -
+                           offset % Pack::DataAlignment) %
+                          Pack::DataAlignment);
+    out.write((const char *)padding.data(), pad);
+    offset += pad;
+    entry.Offset = offset;
+    entry.StoredSize = size;
+    out.write((const char *)data, size);
+    offset += size;
+    entries.push_back(entry);
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Pack::Entry &a, const Pack::Entry &b) {
+              return a.PathHash < b.PathHash;
+            });
+  size_t pad = (size_t)((Pack::DataAlignment - offset % Pack::DataAlignment) %
+                        Pack::DataAlignment);
+  out.write((const char *)padding.data(), pad);
+  offset += pad;
+
+  memcpy(header.Signature, "SPAK", 4);
+  header.Version = Pack::Version;
+  header.EntryCount = (unsigned int)entries.size();
+  header.PathsSize = (unsigned int)paths.size();
+  header.IndexOffset = offset;
+  header.PathsOffset = offset + entries.size() * sizeof(Pack::Entry);
+  out.write((const char *)entries.data(), entries.size() * sizeof(Pack::Entry));
+  out.write(paths.data(), paths.size());
+  out.seekp(0);
+  out.write((const char *)&header, sizeof(header));
+  if (!out.good()) {
+    error = "Couldn't write the archive " + fileName;
+    return false;
+  }
+  return true;
+}
+
+String PackArchive::NormalizePath(const String &path) {
+  std::string source = path;
+  std::replace(source.begin(), source.end(), '\\', '/');
+  std::vector<std::string> segments;
+  size_t start = 0;
+  while (start <= source.size()) {
+    size_t end = source.find('/', start);
+    if (end == std::string::npos)
+      end = source.size();
+    std::string segment = source.substr(start, end - start);
+    if (segment == "..") {
+      if (!segments.empty() && segments.back() != "..")
+        segments.pop_back();
+      else
+        segments.push_back(segment);
+    } else if (!segment.empty() && segment != ".") {
+      segments.push_back(segment);
+    }
+    start = end + 1;
+  }
+
+  std::string normalized = !source.empty() && source[0] == '/' ? "/" : "";
+  for (size_t x = 0; x < segments.size(); x++)
+    normalized += (x ? "/" : "") + segments[x];
+  return normalized;
+}
+
+unsigned long long PackArchive::HashPath(const String &normalizedPath) {
+  // fnv-1a
+  unsigned long long hash = 0xcbf29ce484222325ULL;
+  for (const char *c = normalizedPath.GetCharArray(); *c; c++)
+    hash = (hash ^ (unsigned char)*c) * 0x100000001b3ULL;
+  return hash;
+}
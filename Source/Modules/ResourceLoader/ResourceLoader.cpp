@@ -1,9 +1,14 @@
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <stdio.h>
 
+#include "Modules/ResourceLoader/AssetCache.h"
 #include "Modules/ResourceLoader/CResourceReaderFactory.h"
+#include "Modules/ResourceLoader/MappedFile.h"
+#include "Modules/ResourceLoader/PackArchive.h"
 #include "Modules/ResourceLoader/ResourceLoader.h"
+#include "Modules/ResourceLoader/SsdV2.h"
 
 #include "Modules/Scene/SceneMaker.h"
 #include "Utility/Data/ISerialized.h"
@@ -15,7 +20,82 @@
 #include "Modules/ResourceLoader/BitmapReader/BitmapReader.h"
 
 String ResourceLoader::LastError = "";
-String ResourceLoader::GetLastError() { return LastError; }
+// external assets are loaded from several threads at once
+static std::mutex LastErrorMutex;
+
+String ResourceLoader::GetLastError() {
+  std::lock_guard<std::mutex> lock(LastErrorMutex);
+  return LastError;
+}
+
+void ResourceLoader::SetLastError(const String &error) {
+  std::lock_guard<std::mutex> lock(LastErrorMutex);
+  LastError = error;
+}
+
+// newest archive last, lookups walk the list backwards
+static std::vector<std::shared_ptr<PackArchive>> MountedArchives;
+static std::mutex MountedArchivesMutex;
+
+bool ResourceLoader::MountArchive(const String &fileName) {
+  std::shared_ptr<PackArchive> archive = std::make_shared<PackArchive>();
+  if (!archive->Open(fileName)) {
+    SetLastError(archive->GetLastError());
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(MountedArchivesMutex);
+  MountedArchives.push_back(archive);
+  return true;
+}
+
+void ResourceLoader::UnmountArchive(const String &fileName) {
+  std::lock_guard<std::mutex> lock(MountedArchivesMutex);
+  for (size_t x = MountedArchives.size(); x-- > 0;) {
+    if (MountedArchives[x]->GetFileName() == fileName) {
+      MountedArchives.erase(MountedArchives.begin() + x);
+      return;
+    }
+  }
+}
+
+bool ResourceLoader::ReadFromArchive(const String &fileName,
+                                     const unsigned char *&data,
+                                     size_t &size,
+                                     std::shared_ptr<void> &owner) {
+  std::vector<std::shared_ptr<PackArchive>> archives;
+  {
+    std::lock_guard<std::mutex> lock(MountedArchivesMutex);
+    if (MountedArchives.empty())
+      return false;
+    archives = MountedArchives;
+  }
+  for (size_t x = archives.size(); x-- > 0;) {
+    if (!archives[x]->Contains(fileName))
+      continue;
+    if (archives[x]->Read(fileName, data, size, owner))
+      return true;
+    SetLastError("Corrupt archive entry : " + fileName);
+    return false;
+  }
+  return false;
+}
+
+bool ResourceLoader::MapFile(const String &fileName,
+                             const unsigned char *&data, size_t &size,
+                             std::shared_ptr<void> &owner) {
+  String updatedFileName;
+  SetupPath(fileName, updatedFileName);
+  if (ReadFromArchive(updatedFileName, data, size, owner))
+    return true;
+
+  std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+  if (!file->Open(updatedFileName))
+    return false;
+  data = file->GetData();
+  size = file->GetSize();
+  owner = file;
+  return true;
+}
 
 void ResourceLoader::SetupPath(const String &localPath, String &outPath) {
   const String basePath = "";
@@ -26,15 +106,57 @@ bool ResourceLoader::LoadBitmap(const String &fileName,
                                 IObject *&textureAsset) {
   String updatedFileName;
   SetupPath(fileName, updatedFileName);
-  textureAsset = Statics::Get<IAssetManager>()->AddAssetOfType("Texture2D");
-  return BitmapReader::ReadBitmapToTexture(updatedFileName.GetCharArray(),
-                                           textureAsset);
+  IAssetManager *assetManager = Statics::Get<IAssetManager>();
+  // the cooked texture has the pixels converted to rgba already
+  unsigned long long cacheKey = 0;
+  bool cacheable = AssetCache::GetKey(updatedFileName, cacheKey);
+  textureAsset = cacheable ? AssetCache::Load(cacheKey) : nullptr;
+  if (textureAsset) {
+    textureAsset->SetUniqueID(Statics::GetUniqueId());
+    Statics::RegisterSerializedObject(textureAsset);
+    assetManager->AddInstance(textureAsset);
+    return true;
+  }
+
+  textureAsset = assetManager->AddAssetOfType("Texture2D");
+  if (!BitmapReader::ReadBitmapToTexture(updatedFileName.GetCharArray(),
+                                         textureAsset))
+    return false;
+  if (cacheable)
+    AssetCache::Save(cacheKey, textureAsset);
+  return true;
+}
+
+size_t ResourceLoader::GetFileSize(const String &fileName) {
+  String updatedFileName;
+  SetupPath(fileName, updatedFileName);
+  {
+    std::lock_guard<std::mutex> lock(MountedArchivesMutex);
+    size_t size = 0;
+    for (size_t x = MountedArchives.size(); x-- > 0;) {
+      if (MountedArchives[x]->GetSize(updatedFileName, size))
+        return size;
+    }
+  }
+  std::ifstream file(updatedFileName.GetCharArray(),
+                     std::ios::binary | std::ios::ate);
+  if (!file.is_open())
+    return 0;
+  return static_cast<size_t>(file.tellg());
 }
 
 bool ResourceLoader::LoadText(const String &fileName, String &data) {
   String updatedFileName;
   SetupPath(fileName, updatedFileName);
 
+  const unsigned char *archiveData = nullptr;
+  size_t archiveSize = 0;
+  std::shared_ptr<void> owner;
+  if (ReadFromArchive(updatedFileName, archiveData, archiveSize, owner)) {
+    data = String(std::string((const char *)archiveData, archiveSize));
+    return true;
+  }
+
   FILE *file;
 #if defined _WIN32 || defined _WIN64
   errno_t err;
@@ -44,7 +166,7 @@ bool ResourceLoader::LoadText(const String &fileName, String &data) {
   if (!file)
 #endif
   {
-    LastError = "Couldn't open file : " + fileName;
+    SetLastError("Couldn't open file : " + fileName);
     return false;
   }
 
@@ -110,7 +232,7 @@ bool ResourceLoader::LoadSsd(const String &fileName,
     return false;
   
   if (!reader->Open()) {
-    LastError = "Couldn't open file : " + fileName;
+    SetLastError("Couldn't open file : " + fileName);
     delete reader;
     return false;
   }
@@ -121,3 +243,21 @@ bool ResourceLoader::LoadSsd(const String &fileName,
   delete reader;
   return true;
 }
+
+bool ResourceLoader::SaveSsd(const String &fileName,
+                             const std::vector<IDataNode *> &nodes) {
+  String updatedFileName;
+  SetupPath(fileName, updatedFileName);
+
+  std::vector<unsigned char> data;
+  SsdV2::WriteNodes(nodes, data);
+
+  std::ofstream file(updatedFileName.GetCharArray(),
+                     std::ios::binary | std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    SetLastError("Couldn't write file : " + fileName);
+    return false;
+  }
+  file.write((const char *)data.data(), data.size());
+  return file.good();
+}
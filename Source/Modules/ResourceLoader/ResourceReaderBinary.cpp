@@ -1,16 +1,9 @@
 #include "Modules/ResourceLoader/ResourceReaderBinary.h"
-#include "Utility/Data/DataNode.h"
-#include "Utility/Data/DataStruct.h"
+#include "Modules/ResourceLoader/SsdV1.h"
+#include "Modules/ResourceLoader/SsdV2.h"
 #include "Utility/Data/SSD.h"
 
-#include <iostream>
-
-namespace SSD {
-enum ContainerType { NODE = 0, VALUE = 1 };
-enum DataType { NONE = 0, BYTE = 1, UINT = 2, FLOAT = 3 };
-enum LightType { POINT = 0 };
-enum NodeType { LIGHT = 0, TRANSFORM = 1, MATERIAL = 2, MESH = 3 };
-} // namespace SSD
+#include <memory>
 
 ResourceReaderBinary::ResourceReaderBinary(const String &fileName) {
   FileName = fileName;
@@ -26,137 +19,22 @@ bool ResourceReaderBinary::Open() {
   return true;
 }
 
+// attributes keep pointing into the buffer, it's released with the last one
 void ResourceReaderBinary::ReadNodes(std::vector<IDataNode *> &nodes) {
-  SSD::Header header;
-  unsigned short nodeCount = 0;
-  ReadHeader(header);
-  ReadUShort(nodeCount);
-
-  for (unsigned short x = 0; x < nodeCount; x++) {
-    SSD::Node *node = ReadNode();
-    nodes.push_back(new DataNode(node));
-    delete node;
-  }
-}
-
-SSD::Node *ResourceReaderBinary::ReadNode() {
-  unsigned char garbage = 0;
-  ReadByte(garbage);
-  if (garbage != SSD::NodeBegin) {
-    LastError = "Error reading node identifier";
-    return nullptr;
-  }
-  SSD::Node *node = new SSD::Node();
-  ReadUInt32(node->UniqueID);
-  ReadByte(node->NameLength);
-  node->Name = new char[node->NameLength];
-  FileStream.read(node->Name, node->NameLength);
-  ReadByte(node->AttributeCount);
-  ReadByte(node->NodeCount);
-
-  node->Attributes = new SSD::Attribute *[node->AttributeCount];
-  node->Nodes = new SSD::Node *[node->NodeCount];
-
-  for (unsigned char x = 0; x != node->AttributeCount; x++)
-    node->Attributes[x] = ReadAttribute();
-
-  for (unsigned char x = 0; x != node->NodeCount; x++)
-    node->Nodes[x] = ReadNode();
-
-  ReadByte(garbage);
-  if (garbage == SSD::NodeEnd)
-    return node;
-
-  LastError = "Couldn't find node end byte";
-  delete node;
-  return nullptr;
-}
-
-SSD::Attribute *ResourceReaderBinary::ReadAttribute() {
-  unsigned char garbage = 0;
-  ReadByte(garbage);
-  if (garbage != SSD::AttributeBegin) {
-    LastError = "Error reading attr identifier";
-    return nullptr;
-  }
-
-  SSD::Attribute *attr = new SSD::Attribute();
-  ReadByte(attr->NameLength);
-
-  attr->Name = new char[attr->NameLength];
-  FileStream.read(attr->Name, attr->NameLength);
-
-  ReadByte(attr->DataTypeLength);
-  attr->DataType = new char[attr->DataTypeLength];
-  FileStream.read(attr->DataType, attr->DataTypeLength);
-
-  ReadByte(attr->IsSingleElement);
-
-  ReadUInt32(attr->ByteCount);
-  ReadUInt32(attr->ElementCount);
-
-  String dataTypeName = String(attr->DataType);
-
-  if (dataTypeName == "SerializedClass") {
-    // attribute is an array of nodes
-    attr->Nodes = new SSD::Node *[attr->ElementCount];
-    for (size_t x = 0; x < attr->ElementCount; x++) {
-      attr->Nodes[x] = ReadNode();
-    }
-  } else {
-    // nodes
-    if (dataTypeName == "uid")
-      dataTypeName = "unsigned int";
-
-    // TODO get stride
-    unsigned char stride; // = dataTypeName == "unsigned char" || dataTypeName
-                          // == "char" ? 1 : 4;
-    DataStruct::GetStride(dataTypeName, stride);
-
-    // unsigned int byteCount = attr->ElementCount * stride;
-    unsigned int byteCount = attr->ByteCount;
-
-    attr->Values = new unsigned char[byteCount];
-    FileStream.read((char*)(attr->Values), byteCount);
-  }
-
-  ReadByte(garbage);
-  if (garbage == SSD::AttributeEnd)
-    return attr;
-
-  delete attr;
-  return nullptr;
-}
-
-void ResourceReaderBinary::ReadHeader(SSD::Header &header) {
-  if (!FileStream.is_open())
-    return;
-
-  FileStream.read(header.Signature, 3);
-  ReadByte(header.Version);
-}
-void ResourceReaderBinary::ReadUInt32(unsigned int &val) {
-  if (!FileStream.is_open())
-    return;
-  unsigned char *bytes = new unsigned char[4];
-  FileStream.read((char *)bytes, 4);
-  DataStruct::UnpackUInt32(val, bytes);
-  delete[] bytes;
-}
-
-void ResourceReaderBinary::ReadUShort(unsigned short &val) {
-  if (!FileStream.is_open())
-    return;
-  unsigned char *bytes = new unsigned char[2];
-  FileStream.read((char *)bytes, 2);
-  DataStruct::UnpackUShort(val, bytes);
-  delete[] bytes;
-}
-
-void ResourceReaderBinary::ReadByte(unsigned char &val) {
   if (!FileStream.is_open())
     return;
-  FileStream.read((char *)&val, 1);
+  FileStream.seekg(0, std::ios::end);
+  std::shared_ptr<std::vector<unsigned char>> buffer =
+      std::make_shared<std::vector<unsigned char>>((size_t)FileStream.tellg());
+  FileStream.seekg(0, std::ios::beg);
+  FileStream.read((char *)buffer->data(), buffer->size());
+
+  const unsigned char *data = buffer->data();
+  size_t size = buffer->size();
+  if (size > 3 && data[3] == SSD::Version2)
+    SsdV2::ReadNodes(data, size, buffer, nodes, LastError);
+  else
+    SsdV1::ReadNodes(data, size, buffer, nodes, LastError);
 }
 
 void ResourceReaderBinary::Close() {
@@ -1,5 +1,5 @@
 #include "Modules/ResourceLoader/CResourceReaderFactory.h"
-#include "Modules/ResourceLoader/ResourceReaderBinary.h"
+#include "Modules/ResourceLoader/ResourceReaderMapped.h"
 
 IResourceReader *CResourceReaderFactory::CreateReader(const String &fileName) {
   std::vector<String> elems = fileName.Split('.');
@@ -7,7 +7,7 @@ IResourceReader *CResourceReaderFactory::CreateReader(const String &fileName) {
 
   // TODO add ascii and json formats
   if (fileExtensionName == "ssd")
-    return new ResourceReaderBinary(fileName);
+    return new ResourceReaderMapped(fileName);
   else if (fileExtensionName == "ssda")
     return nullptr;
   else if (fileExtensionName == "ssd_json")
@@ -0,0 +1,36 @@
+#include "Modules/ResourceLoader/ResourceReaderMapped.h"
+#include "Modules/ResourceLoader/ResourceLoader.h"
+#include "Modules/ResourceLoader/SsdV1.h"
+#include "Modules/ResourceLoader/SsdV2.h"
+#include "Utility/Data/SSD.h"
+
+ResourceReaderMapped::ResourceReaderMapped(const String &fileName) {
+  FileName = fileName;
+}
+
+bool ResourceReaderMapped::Open() {
+  if (!ResourceLoader::MapFile(FileName, Data, Size, Owner)) {
+    LastError = "Couldn't map the file " + FileName;
+    return false;
+  }
+  return true;
+}
+
+void ResourceReaderMapped::ReadNodes(std::vector<IDataNode *> &nodes) {
+  if (!Owner)
+    return;
+  if (Size > 3 && Data[3] == SSD::Version2)
+    SsdV2::ReadNodes(Data, Size, Owner, nodes, LastError);
+  else
+    SsdV1::ReadNodes(Data, Size, Owner, nodes, LastError);
+}
+
+// attributes hold their own reference, the data lives until the last one
+// is released
+void ResourceReaderMapped::Close() {
+  Owner.reset();
+  Data = nullptr;
+  Size = 0;
+}
+
+ResourceReaderMapped::~ResourceReaderMapped() { Close(); }
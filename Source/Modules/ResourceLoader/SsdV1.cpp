@@ -0,0 +1,192 @@
+#include "Modules/ResourceLoader/SsdV1.h"
+#include "Utility/Data/DataNode.h"
+#include "Utility/Data/DataStruct.h"
+#include "Utility/Data/SSD.h"
+#include "Utility/Data/TypedAttribute.h"
+
+#include <string.h>
+
+namespace {
+class Parser {
+public:
+  Parser(const unsigned char *data, size_t size,
+         const std::shared_ptr<void> &owner, String &error)
+      : Cursor(data), End(data + size), Owner(owner), Error(error) {}
+
+  bool ReadHeader(unsigned short &nodeCount) {
+    const unsigned char *signature = nullptr;
+    unsigned char version = 0;
+    if (!ReadBytes(3, signature) || !ReadByte(version) ||
+        !ReadUShort(nodeCount)) {
+      Error = "Couldn't read the ssd header";
+      return false;
+    }
+    return true;
+  }
+
+  IDataNode *ReadNode() {
+    unsigned char marker = 0;
+    if (!ReadByte(marker) || marker != SSD::NodeBegin) {
+      Error = "Error reading node identifier";
+      return nullptr;
+    }
+
+    unsigned int uniqueId = 0;
+    unsigned char nameLength = 0, attributeCount = 0, nodeCount = 0;
+    String name;
+    if (!ReadUInt32(uniqueId) || !ReadByte(nameLength) ||
+        !ReadString(nameLength, name) || !ReadByte(attributeCount) ||
+        !ReadByte(nodeCount)) {
+      Error = "Unexpected end of file in node";
+      return nullptr;
+    }
+
+    std::vector<ISerialized *> attributes;
+    std::vector<IDataNode *> nodes;
+    bool success = true;
+    for (unsigned char x = 0; success && x != attributeCount; x++) {
+      ISerialized *attribute = ReadAttribute();
+      success = attribute != nullptr;
+      if (success)
+        attributes.push_back(attribute);
+    }
+
+    for (unsigned char x = 0; success && x != nodeCount; x++) {
+      IDataNode *node = ReadNode();
+      success = node != nullptr;
+      if (success)
+        nodes.push_back(node);
+    }
+
+    if (success && (!ReadByte(marker) || marker != SSD::NodeEnd)) {
+      Error = "Couldn't find node end byte";
+      success = false;
+    }
+
+    IDataNode *node = new DataNode(name, uniqueId, attributes, nodes);
+    if (success)
+      return node;
+    delete node;
+    return nullptr;
+  }
+
+private:
+  ISerialized *ReadAttribute() {
+    unsigned char marker = 0;
+    if (!ReadByte(marker) || marker != SSD::AttributeBegin) {
+      Error = "Error reading attr identifier";
+      return nullptr;
+    }
+
+    unsigned char nameLength = 0, typeLength = 0, isSingleElement = 0;
+    unsigned int byteCount = 0, elementCount = 0;
+    String name, typeName;
+    if (!ReadByte(nameLength) || !ReadString(nameLength, name) ||
+        !ReadByte(typeLength) || !ReadString(typeLength, typeName) ||
+        !ReadByte(isSingleElement) || !ReadUInt32(byteCount) ||
+        !ReadUInt32(elementCount)) {
+      Error = "Unexpected end of file in attribute";
+      return nullptr;
+    }
+
+    ISerialized *attribute = nullptr;
+    if (typeName == "SerializedClass") {
+      // attribute is an array of nodes
+      std::vector<IDataNode *> nodes;
+      for (unsigned int x = 0; x < elementCount; x++) {
+        IDataNode *node = ReadNode();
+        if (!node) {
+          for (size_t y = 0; y < nodes.size(); y++)
+            delete nodes[y];
+          return nullptr;
+        }
+        nodes.push_back(node);
+      }
+      attribute = new TypedAttribute<IDataNode *>(name, typeName, nodes);
+    } else {
+      const unsigned char *values = nullptr;
+      if (!ReadBytes(byteCount, values)) {
+        Error = "Unexpected end of file in attribute " + name;
+        return nullptr;
+      }
+      attribute = DataNode::MakeValueAttribute(name, typeName,
+                                               isSingleElement != 0, values,
+                                               byteCount, elementCount, Owner);
+      if (!attribute) {
+        Error = "Unsupported attribute " + name;
+        return nullptr;
+      }
+    }
+
+    if (!ReadByte(marker) || marker != SSD::AttributeEnd) {
+      Error = "Couldn't find attr end byte";
+      delete attribute;
+      return nullptr;
+    }
+    return attribute;
+  }
+
+  bool ReadBytes(size_t count, const unsigned char *&bytes) {
+    if ((size_t)(End - Cursor) < count)
+      return false;
+    bytes = Cursor;
+    Cursor += count;
+    return true;
+  }
+
+  bool ReadString(unsigned char length, String &val) {
+    const unsigned char *bytes = nullptr;
+    if (!ReadBytes(length, bytes))
+      return false;
+    const char *chars = (const char *)bytes;
+    val = String(std::string(chars, strnlen(chars, length)));
+    return true;
+  }
+
+  bool ReadByte(unsigned char &val) {
+    if (Cursor == End)
+      return false;
+    val = *Cursor++;
+    return true;
+  }
+
+  bool ReadUShort(unsigned short &val) {
+    const unsigned char *bytes = nullptr;
+    if (!ReadBytes(2, bytes))
+      return false;
+    DataStruct::UnpackUShort(val, (unsigned char *)bytes);
+    return true;
+  }
+
+  bool ReadUInt32(unsigned int &val) {
+    const unsigned char *bytes = nullptr;
+    if (!ReadBytes(4, bytes))
+      return false;
+    DataStruct::UnpackUInt32(val, (unsigned char *)bytes);
+    return true;
+  }
+
+  const unsigned char *Cursor;
+  const unsigned char *End;
+  const std::shared_ptr<void> &Owner;
+  String &Error;
+};
+} // namespace
+
+namespace SsdV1 {
+bool ReadNodes(const unsigned char *data, size_t size,
+               const std::shared_ptr<void> &owner,
+               std::vector<IDataNode *> &nodes, String &error) {
+  Parser parser(data, size, owner, error);
+  unsigned short nodeCount = 0;
+  if (!parser.ReadHeader(nodeCount))
+    return false;
+  for (unsigned short x = 0; x < nodeCount; x++) {
+    IDataNode *node = parser.ReadNode();
+    if (!node)
+      return false;
+    nodes.push_back(node);
+  }
+  return true;
+}
+} // namespace SsdV1
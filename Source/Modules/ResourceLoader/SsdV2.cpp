@@ -0,0 +1,379 @@
+#include "Modules/ResourceLoader/SsdV2.h"
+#include "Utility/Data/DataNode.h"
+#include "Utility/Data/SSD.h"
+#include "Utility/Data/TypedAttribute.h"
+
+#include <map>
+#include <string.h>
+
+namespace {
+class Parser {
+public:
+  Parser(const unsigned char *data, size_t size,
+         const std::shared_ptr<void> &owner, String &error)
+      : Data(data), Size(size), Owner(owner), Error(error) {}
+
+  bool ReadHeader() {
+    if (Size < sizeof(SSD::HeaderV2) || memcmp(Data, "SSD", 3) != 0 ||
+        Data[3] != SSD::Version2)
+      return Fail("Not a version 2 ssd file");
+    memcpy(&Header, Data, sizeof(Header));
+
+    size_t stringData = (size_t)Header.StringTableOffset +
+                        (size_t)Header.StringCount * sizeof(unsigned int);
+    if (stringData > Header.PayloadOffset ||
+        (size_t)Header.PayloadOffset + Header.PayloadSize > Size)
+      return Fail("Corrupt ssd header");
+
+    Strings.resize(Header.StringCount);
+    for (unsigned int x = 0; x < Header.StringCount; x++) {
+      unsigned int offset;
+      memcpy(&offset, Data + Header.StringTableOffset + x * sizeof(offset),
+             sizeof(offset));
+      if (stringData + offset >= Header.PayloadOffset)
+        return Fail("Corrupt ssd string table");
+      const char *chars = (const char *)Data + stringData + offset;
+      Strings[x] = std::string(
+          chars, strnlen(chars, Header.PayloadOffset - stringData - offset));
+    }
+    return true;
+  }
+
+  unsigned int GetNodeCount() { return Header.NodeCount; }
+
+  bool GetNodeEntry(unsigned int index, SSD::NodeEntryV2 &entry) {
+    if (index >= Header.NodeCount)
+      return Fail("Node index out of range");
+    size_t offset =
+        (size_t)Header.NodeTableOffset + index * sizeof(SSD::NodeEntryV2);
+    if (offset + sizeof(entry) > Size)
+      return Fail("Corrupt ssd node table");
+    memcpy(&entry, Data + offset, sizeof(entry));
+    if ((size_t)entry.Offset + entry.Size > Size)
+      return Fail("Corrupt ssd node table");
+    return true;
+  }
+
+  IDataNode *ReadNode(size_t &cursor, size_t end) {
+    SSD::NodeV2 record;
+    String name;
+    if (!Read(cursor, end, &record, sizeof(record)) ||
+        !GetString(record.Name, name))
+      return nullptr;
+
+    std::vector<ISerialized *> attributes;
+    std::vector<IDataNode *> nodes;
+    bool success = true;
+    for (unsigned int x = 0; success && x < record.AttributeCount; x++) {
+      ISerialized *attribute = ReadAttribute(cursor, end);
+      success = attribute != nullptr;
+      if (success)
+        attributes.push_back(attribute);
+    }
+    for (unsigned int x = 0; success && x < record.NodeCount; x++) {
+      IDataNode *node = ReadNode(cursor, end);
+      success = node != nullptr;
+      if (success)
+        nodes.push_back(node);
+    }
+
+    IDataNode *node = new DataNode(name, record.UniqueID, attributes, nodes);
+    if (success)
+      return node;
+    delete node;
+    return nullptr;
+  }
+
+private:
+  ISerialized *ReadAttribute(size_t &cursor, size_t end) {
+    SSD::AttributeV2 record;
+    String name, typeName;
+    if (!Read(cursor, end, &record, sizeof(record)) ||
+        !GetString(record.Name, name) || !GetString(record.DataType, typeName))
+      return nullptr;
+
+    if (typeName == "SerializedClass") {
+      size_t nodesEnd = cursor + record.ByteCount;
+      if (nodesEnd > end) {
+        Fail("Corrupt ssd attribute " + name);
+        return nullptr;
+      }
+      std::vector<IDataNode *> nodes;
+      for (unsigned int x = 0; x < record.ElementCount; x++) {
+        IDataNode *node = ReadNode(cursor, nodesEnd);
+        if (!node) {
+          for (size_t y = 0; y < nodes.size(); y++)
+            delete nodes[y];
+          return nullptr;
+        }
+        nodes.push_back(node);
+      }
+      cursor = nodesEnd;
+      return new TypedAttribute<IDataNode *>(name, typeName, nodes);
+    }
+
+    if ((size_t)record.Offset + record.ByteCount > Header.PayloadSize) {
+      Fail("Corrupt ssd attribute " + name);
+      return nullptr;
+    }
+    ISerialized *attribute = DataNode::MakeValueAttribute(
+        name, typeName, (record.Flags & SSD::SingleElementFlag) != 0,
+        Data + Header.PayloadOffset + record.Offset, record.ByteCount,
+        record.ElementCount, Owner, false);
+    if (!attribute)
+      Fail("Unsupported attribute " + name);
+    return attribute;
+  }
+
+  bool Read(size_t &cursor, size_t end, void *out, size_t size) {
+    if (cursor + size > end)
+      return Fail("Unexpected end of ssd node");
+    memcpy(out, Data + cursor, size);
+    cursor += size;
+    return true;
+  }
+
+  bool GetString(unsigned int index, String &val) {
+    if (index >= Strings.size())
+      return Fail("Corrupt ssd string index");
+    val = Strings[index];
+    return true;
+  }
+
+  bool Fail(const String &error) {
+    Error = error;
+    return false;
+  }
+
+  const unsigned char *Data;
+  size_t Size;
+  const std::shared_ptr<void> &Owner;
+  String &Error;
+  SSD::HeaderV2 Header;
+  std::vector<String> Strings;
+};
+
+class Writer {
+public:
+  void WriteNodes(const std::vector<IDataNode *> &nodes,
+                  std::vector<unsigned char> &data) {
+    std::vector<SSD::NodeEntryV2> entries(nodes.size());
+    for (size_t x = 0; x < nodes.size(); x++) {
+      entries[x].Offset = (unsigned int)Records.size();
+      WriteNode(nodes[x]);
+      entries[x].Size = (unsigned int)Records.size() - entries[x].Offset;
+    }
+
+    std::vector<unsigned char> stringTable;
+    std::vector<unsigned char> stringData;
+    for (size_t x = 0; x < Strings.size(); x++) {
+      unsigned int offset = (unsigned int)stringData.size();
+      Append(stringTable, &offset, sizeof(offset));
+      Append(stringData, Strings[x].c_str(), Strings[x].size() + 1);
+    }
+
+    SSD::HeaderV2 header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Signature, "SSD", 3);
+    header.Version = SSD::Version2;
+    header.StringCount = (unsigned int)Strings.size();
+    header.StringTableOffset = sizeof(header);
+    header.NodeCount = (unsigned int)nodes.size();
+    header.NodeTableOffset =
+        Align(header.StringTableOffset + stringTable.size() + stringData.size(),
+              sizeof(unsigned int));
+    size_t recordsOffset =
+        header.NodeTableOffset + entries.size() * sizeof(SSD::NodeEntryV2);
+    header.PayloadOffset =
+        Align(recordsOffset + Records.size(), SSD::PayloadAlignment);
+    header.PayloadSize = (unsigned int)Payload.size();
+
+    for (size_t x = 0; x < entries.size(); x++)
+      entries[x].Offset += (unsigned int)recordsOffset;
+
+    data.clear();
+    data.reserve(header.PayloadOffset + Payload.size());
+    Append(data, &header, sizeof(header));
+    Append(data, stringTable.data(), stringTable.size());
+    Append(data, stringData.data(), stringData.size());
+    data.resize(header.NodeTableOffset, 0);
+    Append(data, entries.data(), entries.size() * sizeof(SSD::NodeEntryV2));
+    Append(data, Records.data(), Records.size());
+    data.resize(header.PayloadOffset, 0);
+    Append(data, Payload.data(), Payload.size());
+  }
+
+private:
+  void WriteNode(IDataNode *node) {
+    SSD::NodeV2 record;
+    record.UniqueID = node->GetUniqueID();
+    record.Name = AddString(node->Name());
+    record.AttributeCount = 0;
+    std::vector<IDataNode *> nodes = node->GetNodes();
+    record.NodeCount = (unsigned int)nodes.size();
+    size_t recordOffset = Records.size();
+    Append(Records, &record, sizeof(record));
+
+    std::vector<ISerialized *> attributes = node->GetAttributes();
+    for (size_t x = 0; x < attributes.size(); x++)
+      record.AttributeCount += WriteAttribute(attributes[x]) ? 1 : 0;
+    memcpy(&Records[recordOffset], &record, sizeof(record));
+
+    for (size_t x = 0; x < nodes.size(); x++)
+      WriteNode(nodes[x]);
+  }
+
+  bool WriteAttribute(ISerialized *attribute) {
+    SSD::AttributeV2 record;
+    memset(&record, 0, sizeof(record));
+    record.Name = AddString(attribute->SerializedName());
+    String typeName = attribute->TypeName();
+    record.DataType = AddString(typeName);
+
+    if (typeName == "SerializedClass") {
+      TypedAttribute<IDataNode *> *classAttribute =
+          dynamic_cast<TypedAttribute<IDataNode *> *>(attribute);
+      if (!classAttribute)
+        return false;
+      std::vector<IDataNode *> nodes = classAttribute->Get();
+      record.ElementCount = (unsigned int)nodes.size();
+      size_t recordOffset = Records.size();
+      Append(Records, &record, sizeof(record));
+      for (size_t x = 0; x < nodes.size(); x++)
+        WriteNode(nodes[x]);
+      record.ByteCount =
+          (unsigned int)(Records.size() - recordOffset - sizeof(record));
+      memcpy(&Records[recordOffset], &record, sizeof(record));
+      return true;
+    }
+
+    std::vector<unsigned char> bytes;
+    if (!(GetValues<float>(attribute, record, bytes) ||
+          GetValues<unsigned int>(attribute, record, bytes) ||
+          GetValues<int>(attribute, record, bytes) ||
+          GetValues<unsigned short>(attribute, record, bytes) ||
+          GetValues<short>(attribute, record, bytes) ||
+          GetValues<unsigned char>(attribute, record, bytes) ||
+          GetStrings(attribute, record, bytes)))
+      return false;
+
+    Payload.resize(Align(Payload.size(), SSD::PayloadAlignment), 0);
+    record.Offset = (unsigned int)Payload.size();
+    record.ByteCount = (unsigned int)bytes.size();
+    Append(Payload, bytes.data(), bytes.size());
+    Append(Records, &record, sizeof(record));
+    return true;
+  }
+
+  template <class T>
+  bool GetValues(ISerialized *attribute, SSD::AttributeV2 &record,
+                 std::vector<unsigned char> &bytes) {
+    TypedAttributeValue<T> *value =
+        dynamic_cast<TypedAttributeValue<T> *>(attribute);
+    if (value) {
+      T data = value->Get();
+      record.Flags = SSD::SingleElementFlag;
+      record.ElementCount = 1;
+      Append(bytes, &data, sizeof(T));
+      return true;
+    }
+    TypedAttribute<T> *values = dynamic_cast<TypedAttribute<T> *>(attribute);
+    if (!values)
+      return false;
+    record.ElementCount = (unsigned int)values->Size();
+    bytes.resize(values->Size() * sizeof(T));
+    if (!bytes.empty())
+      values->CopyTo((T *)&bytes[0]);
+    return true;
+  }
+
+  bool GetStrings(ISerialized *attribute, SSD::AttributeV2 &record,
+                  std::vector<unsigned char> &bytes) {
+    // runtime attributes name the type String, files store strings as char
+    if (dynamic_cast<TypedAttributeValue<String> *>(attribute) ||
+        dynamic_cast<TypedAttribute<String> *>(attribute))
+      record.DataType = AddString("char");
+    TypedAttributeValue<String> *value =
+        dynamic_cast<TypedAttributeValue<String> *>(attribute);
+    if (value) {
+      String data = value->Get();
+      record.Flags = SSD::SingleElementFlag;
+      record.ElementCount = 1;
+      Append(bytes, data.GetCharArray(), strlen(data.GetCharArray()) + 1);
+      return true;
+    }
+    TypedAttribute<String> *values =
+        dynamic_cast<TypedAttribute<String> *>(attribute);
+    if (!values)
+      return false;
+    std::vector<String> data = values->Get();
+    record.ElementCount = (unsigned int)data.size();
+    for (size_t x = 0; x < data.size(); x++)
+      Append(bytes, data[x].GetCharArray(), strlen(data[x].GetCharArray()) + 1);
+    return true;
+  }
+
+  unsigned int AddString(const String &value) {
+    std::string key = value;
+    std::map<std::string, unsigned int>::iterator it = StringIds.find(key);
+    if (it != StringIds.end())
+      return it->second;
+    unsigned int id = (unsigned int)Strings.size();
+    StringIds[key] = id;
+    Strings.push_back(key);
+    return id;
+  }
+
+  static size_t Align(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  static void Append(std::vector<unsigned char> &data, const void *bytes,
+                     size_t size) {
+    data.insert(data.end(), (const unsigned char *)bytes,
+                (const unsigned char *)bytes + size);
+  }
+
+  std::map<std::string, unsigned int> StringIds;
+  std::vector<std::string> Strings;
+  std::vector<unsigned char> Records;
+  std::vector<unsigned char> Payload;
+};
+} // namespace
+
+namespace SsdV2 {
+bool ReadNodes(const unsigned char *data, size_t size,
+               const std::shared_ptr<void> &owner,
+               std::vector<IDataNode *> &nodes, String &error) {
+  Parser parser(data, size, owner, error);
+  if (!parser.ReadHeader())
+    return false;
+  SSD::NodeEntryV2 entry;
+  for (unsigned int x = 0; x < parser.GetNodeCount(); x++) {
+    if (!parser.GetNodeEntry(x, entry))
+      return false;
+    size_t cursor = entry.Offset;
+    IDataNode *node = parser.ReadNode(cursor, entry.Offset + entry.Size);
+    if (!node)
+      return false;
+    nodes.push_back(node);
+  }
+  return true;
+}
+
+IDataNode *ReadNode(const unsigned char *data, size_t size, unsigned int index,
+                    const std::shared_ptr<void> &owner, String &error) {
+  Parser parser(data, size, owner, error);
+  SSD::NodeEntryV2 entry;
+  if (!parser.ReadHeader() || !parser.GetNodeEntry(index, entry))
+    return nullptr;
+  size_t cursor = entry.Offset;
+  return parser.ReadNode(cursor, entry.Offset + entry.Size);
+}
+
+void WriteNodes(const std::vector<IDataNode *> &nodes,
+                std::vector<unsigned char> &data) {
+  Writer writer;
+  writer.WriteNodes(nodes, data);
+}
+} // namespace SsdV2
@@ -29,6 +29,8 @@ IObject *AssetManager::GetAssetOfType(const String &typeName,
 }
 
 void AssetManager::UnloadSceneAssets() {
+  // frames in flight might still reference the assets
+  Statics::Get<IGraphics>()->Flush();
   std::vector<IObject *> assetsToDelete;
   StringMap::iterator it;
   // find scene assets
@@ -50,10 +52,120 @@ void AssetManager::UnloadSceneAssets() {
     IObject *asset = assetsToDelete[x];
     IdMap &map = Assets.find(asset->SerializedName())->second;
     map.erase(asset->UniqueID());
+    ForgetReferences(asset->UniqueID());
     Statics::Destroy(asset);
   }
   // Clean loaded assets from gpu
-  Statics::Get<IGraphics>()->GetContext()->Cleanup();
+  Statics::Get<IGraphics>()->ReleaseUnusedResources();
+}
+
+void AssetManager::UnloadAssets(const std::vector<unsigned int> &assetIds) {
+  if (assetIds.empty())
+    return;
+  // frames in flight might still reference the assets
+  Statics::Get<IGraphics>()->Flush();
+  for (size_t x = 0; x < assetIds.size(); x++) {
+    unsigned int assetId = assetIds[x];
+    IObject *asset = GetAsset(assetId);
+    if (!asset)
+      continue;
+    Assets[asset->SerializedName()].erase(assetId);
+    ForgetReferences(assetId);
+    ExternalPathMap::iterator pathIterator = ExternalPathToAssetId.begin();
+    while (pathIterator != ExternalPathToAssetId.end()) {
+      if (pathIterator->second == assetId)
+        pathIterator = ExternalPathToAssetId.erase(pathIterator);
+      else
+        pathIterator++;
+    }
+    Statics::Destroy(asset);
+  }
+  // Clean loaded assets from gpu
+  Statics::Get<IGraphics>()->ReleaseUnusedResources();
+}
+
+void AssetManager::AddReference(unsigned int assetId) {
+  AssetReferences &references = References[assetId];
+  // back out of the cache
+  if (references.Count++ == 0)
+    Unreferenced.remove(assetId);
+}
+
+void AssetManager::ReleaseReference(unsigned int assetId) {
+  std::unordered_map<unsigned int, AssetReferences>::iterator it =
+      References.find(assetId);
+  if (it == References.end() || it->second.Count == 0)
+    return;
+  AssetReferences &references = it->second;
+  if (--references.Count > 0)
+    return;
+  references.ReleasedFrame = Frame;
+  Asset *asset = dynamic_cast<Asset *>(GetAsset(assetId));
+  references.MemoryUsage = asset ? asset->GetMemoryUsage() : 0;
+  references.GpuMemoryUsage = asset ? asset->GetGpuMemoryUsage() : 0;
+  Unreferenced.push_back(assetId);
+}
+
+unsigned int AssetManager::GetReferenceCount(unsigned int assetId) {
+  std::unordered_map<unsigned int, AssetReferences>::iterator it =
+      References.find(assetId);
+  return it == References.end() ? 0 : it->second.Count;
+}
+
+void AssetManager::SetCacheBudget(size_t cpuBytes, size_t gpuBytes) {
+  CacheCpuBudget = cpuBytes;
+  CacheGpuBudget = gpuBytes;
+}
+
+void AssetManager::Update() {
+  Frame++;
+  // assets released recently are still in use as far as the cache goes
+  size_t cachedMemory = 0;
+  size_t cachedGpuMemory = 0;
+  std::list<unsigned int>::iterator it;
+  for (it = Unreferenced.begin(); it != Unreferenced.end(); it++) {
+    AssetReferences &references = References[*it];
+    if (Frame - references.ReleasedFrame < ASSET_CACHE_UNUSED_FRAMES)
+      break;
+    cachedMemory += references.MemoryUsage;
+    cachedGpuMemory += references.GpuMemoryUsage;
+  }
+
+  std::vector<unsigned int> assetsToEvict;
+  for (it = Unreferenced.begin(); it != Unreferenced.end(); it++) {
+    if (cachedMemory <= CacheCpuBudget && cachedGpuMemory <= CacheGpuBudget)
+      break;
+    AssetReferences &references = References[*it];
+    if (Frame - references.ReleasedFrame < ASSET_CACHE_UNUSED_FRAMES)
+      break;
+    cachedMemory -= references.MemoryUsage;
+    cachedGpuMemory -= references.GpuMemoryUsage;
+    assetsToEvict.push_back(*it);
+  }
+  if (assetsToEvict.empty())
+    return;
+  S_LOG_FUNC("Evicting %lu cached assets", assetsToEvict.size());
+  UnloadAssets(assetsToEvict);
+}
+
+void AssetManager::ForgetReferences(unsigned int assetId) {
+  std::unordered_map<unsigned int, AssetReferences>::iterator it =
+      References.find(assetId);
+  if (it == References.end())
+    return;
+  if (it->second.Count == 0)
+    Unreferenced.remove(assetId);
+  References.erase(it);
+}
+
+IObject *AssetManager::GetAsset(unsigned int assetId) {
+  StringMap::iterator it;
+  for (it = Assets.begin(); it != Assets.end(); it++) {
+    IdMap::iterator idIterator = it->second.find(assetId);
+    if (idIterator != it->second.end())
+      return idIterator->second;
+  }
+  return nullptr;
 }
 
 IObject *AssetManager::GetAssetByFileName(const String &fileName) {
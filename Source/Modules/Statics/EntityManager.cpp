@@ -28,14 +28,9 @@ EntityManager::CreateEntity(std::vector<String> componentsToAttach) {
 void EntityManager::Destroy(unsigned int id) {
   std::vector<unsigned int>::iterator it =
       std::find(Ids.begin(), Ids.end(), id);
-
-  int deleteIndex = -1;
-  for (int x = 0; x < Ids.size(); x++) {
-    if (Ids[x] == id) {
-      deleteIndex = x;
-      break;
-    }
-  }
+  // scenes unloading one by one may refer to already destroyed entities
+  if (it == Ids.end())
+    return;
   DestroyAtIndex(std::distance(Ids.begin(), it));
 }
 
@@ -82,3 +77,8 @@ void EntityManager::SetPersistentEntity(unsigned int entityId, bool state) {
       PersistentEntityIds.erase(it);
   }
 }
+
+bool EntityManager::IsPersistentEntity(unsigned int entityId) {
+  return std::find(PersistentEntityIds.begin(), PersistentEntityIds.end(),
+                   entityId) != PersistentEntityIds.end();
+}
@@ -7,14 +7,45 @@
 REGISTER_SERIALIZED_CLASS(Graphics)
 
 bool Graphics::Render() {
-  // create window if not created
+  if (!RenderThread.joinable()) {
+    // create window if not created
+    ExecuteFrame(RecordingFrame);
+    // Finalize rendering
+    RenderContext->Update();
+    return !RenderContext->WindowShouldClose();
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(FrameMutex);
+    SubmittedFrames.push_back(RecordingFrame);
+    RecordingFrame = (RecordingFrame + 1) % Frames.size();
+    FrameCondition.notify_all();
+    // the next frame can be recorded once the render thread is done with it,
+    // this bounds the latency to the amount of frame sets
+    FrameCondition.wait(
+        lock, [this]() { return !IsFrameSubmitted(RecordingFrame); });
+  }
+
+  RenderContext->PollEvents();
+  if (!RenderContext->WindowShouldClose())
+    return true;
+  StopRenderThread();
+  return false;
+}
+
+void Graphics::ExecuteFrame(unsigned int frameIndex) {
+  FrameCommandBuffers &frame = Frames[frameIndex];
   for (unsigned char x = 0; x < CommandBufferType::COUNT; x++) {
-    CommandBuffers[x]->Execute();
-    CommandBuffers[x]->ResetCommandBuffer();
+    frame.Buffers[x]->Execute();
+    frame.Buffers[x]->ResetCommandBuffer();
   }
-  // Finalize rendering
-  RenderContext->Update();
-  return !RenderContext->WindowShouldClose();
+}
+
+bool Graphics::IsFrameSubmitted(unsigned int frameIndex) {
+  for (size_t x = 0; x < SubmittedFrames.size(); x++)
+    if (SubmittedFrames[x] == frameIndex)
+      return true;
+  return false;
 }
 
 void Graphics::SetupWindow() {
@@ -23,6 +54,98 @@ void Graphics::SetupWindow() {
   RenderContext->Create(renderSettings->ScreenWidth,
                         renderSettings->ScreenHeight,
                         renderSettings->WindowTitle);
+
+  unsigned int frameLatency = renderSettings->FrameLatency;
+  if (frameLatency > MAX_FRAME_LATENCY)
+    frameLatency = MAX_FRAME_LATENCY;
+  if (frameLatency == 0)
+    return;
+  // one frame is recorded while the others wait for the render thread
+  while (Frames.size() < frameLatency + 1)
+    AddFrame();
+  StartRenderThread();
+}
+
+void Graphics::StartRenderThread() {
+  RenderContext->ReleaseContext();
+  RenderThreadStopping = false;
+  RenderThread = std::thread(&Graphics::RenderThreadLoop, this);
+}
+
+void Graphics::StopRenderThread() {
+  if (!RenderThread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(FrameMutex);
+    RenderThreadStopping = true;
+  }
+  FrameCondition.notify_all();
+  RenderThread.join();
+  RenderContext->AcquireContext();
+}
+
+void Graphics::RenderThreadLoop() {
+  RenderContext->AcquireContext();
+  while (true) {
+    std::function<void()> task;
+    unsigned int frameIndex = 0;
+    {
+      std::unique_lock<std::mutex> lock(FrameMutex);
+      FrameCondition.wait(lock, [this]() {
+        return RenderThreadStopping || RenderThreadTask ||
+               !SubmittedFrames.empty();
+      });
+      if (RenderThreadTask)
+        task = RenderThreadTask;
+      else if (!SubmittedFrames.empty())
+        frameIndex = SubmittedFrames.front();
+      else
+        break;
+    }
+
+    if (task) {
+      task();
+      std::lock_guard<std::mutex> lock(FrameMutex);
+      RenderThreadTask = nullptr;
+      FrameCondition.notify_all();
+      continue;
+    }
+
+    ExecuteFrame(frameIndex);
+    RenderContext->Present();
+    {
+      // the frame stays submitted until it's executed so the simulation
+      // doesn't record into buffers which are being read
+      std::lock_guard<std::mutex> lock(FrameMutex);
+      SubmittedFrames.pop_front();
+      FrameCondition.notify_all();
+    }
+  }
+  RenderContext->ReleaseContext();
+}
+
+void Graphics::RunOnRenderThread(const std::function<void()> &task) {
+  if (!RenderThread.joinable()) {
+    task();
+    return;
+  }
+  std::unique_lock<std::mutex> lock(FrameMutex);
+  RenderThreadTask = task;
+  FrameCondition.notify_all();
+  FrameCondition.wait(lock, [this]() { return !RenderThreadTask; });
+}
+
+void Graphics::Flush() {
+  if (!RenderThread.joinable())
+    return;
+  std::unique_lock<std::mutex> lock(FrameMutex);
+  FrameCondition.wait(lock, [this]() { return SubmittedFrames.empty(); });
+}
+
+void Graphics::ReleaseUnusedResources() {
+  Flush();
+  IRenderContext *context = RenderContext;
+  RunOnRenderThread([context]() { context->Cleanup(); });
 }
 
 Graphics::Graphics() {
@@ -35,13 +158,26 @@ Graphics::Graphics() {
 
   // TODO make a factory class for making render context
   RenderContext = new OpenGLRender();
+  AddFrame();
+}
+
+void Graphics::AddFrame() {
+  FrameCommandBuffers frame;
   for (unsigned int x = 0; x < CommandBufferType::COUNT; x++)
-    CommandBuffers[x] = new OglCommandBuffer();
+    frame.Buffers[x] = new OglCommandBuffer();
+  Frames.push_back(frame);
 }
 
 IRenderContext *Graphics::GetContext() { return RenderContext; }
 ICommandBuffer *Graphics::GetCommandBuffer(IGraphics::CommandBufferType type) {
-  return CommandBuffers[type];
+  return Frames[RecordingFrame].Buffers[type];
+}
+ICommandBuffer *Graphics::GetSecondaryCommandBuffer(unsigned int index) {
+  while (SecondaryCommandBuffers.size() <= index)
+    SecondaryCommandBuffers.push_back(new OglCommandBuffer());
+  return SecondaryCommandBuffers[index];
 }
 void Graphics::SetDefaultShader(IShader *shader) { defaultShader = shader; }
 IShader *Graphics::DefaultShader() { return defaultShader; }
+IGraphics::FrameStats &Graphics::GetFrameStats() { return Stats; }
+unsigned int Graphics::CreateBufferId() { return ++LastBufferId; }
@@ -0,0 +1,114 @@
+#include "Modules/Statics/JobSystem.h"
+#include <atomic>
+
+REGISTER_SERIALIZED_CLASS(JobSystem)
+
+JobSystem::JobSystem() {
+  unsigned int hardwareThreads = std::thread::hardware_concurrency();
+  // the thread calling ParallelFor takes part in the work as well
+  unsigned int workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+  for (unsigned int x = 0; x < workerCount; x++)
+    Workers.push_back(std::thread(&JobSystem::WorkerLoop, this));
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(TaskMutex);
+    ShuttingDown = true;
+  }
+  TaskCondition.notify_all();
+  for (size_t x = 0; x < Workers.size(); x++)
+    Workers[x].join();
+}
+
+unsigned int JobSystem::GetThreadCount() {
+  return static_cast<unsigned int>(Workers.size()) + 1;
+}
+
+unsigned int JobSystem::GetRangeCount(unsigned int count,
+                                      unsigned int minRangeSize) {
+  if (count == 0)
+    return 0;
+  if (minRangeSize == 0)
+    minRangeSize = 1;
+  unsigned int rangeCount = (count + minRangeSize - 1) / minRangeSize;
+  unsigned int threadCount = GetThreadCount();
+  return rangeCount < threadCount ? rangeCount : threadCount;
+}
+
+void JobSystem::ParallelFor(unsigned int count, unsigned int minRangeSize,
+                            const RangeJob &job) {
+  unsigned int rangeCount = GetRangeCount(count, minRangeSize);
+  if (rangeCount == 0)
+    return;
+  if (rangeCount == 1) {
+    job(0, count, 0);
+    return;
+  }
+
+  unsigned int rangeSize = count / rangeCount;
+  unsigned int remainder = count % rangeCount;
+  std::atomic<unsigned int> rangesLeft(rangeCount - 1);
+  std::mutex doneMutex;
+  std::condition_variable doneCondition;
+
+  // queue all ranges but the first one, which runs on the calling thread
+  unsigned int begin = rangeSize + (remainder > 0 ? 1 : 0);
+  {
+    std::lock_guard<std::mutex> lock(TaskMutex);
+    for (unsigned int x = 1; x < rangeCount; x++) {
+      unsigned int end = begin + rangeSize + (x < remainder ? 1 : 0);
+      Tasks.push_back([&job, &rangesLeft, &doneMutex, &doneCondition, begin,
+                       end, x]() {
+        job(begin, end, x);
+        std::lock_guard<std::mutex> doneLock(doneMutex);
+        if (--rangesLeft == 0)
+          doneCondition.notify_one();
+      });
+      begin = end;
+    }
+  }
+  TaskCondition.notify_all();
+
+  job(0, rangeSize + (remainder > 0 ? 1 : 0), 0);
+
+  // help with the queue instead of idling, this also keeps nested calls
+  // from dead locking when all workers are busy
+  while (rangesLeft > 0) {
+    if (RunPendingTask())
+      continue;
+    std::unique_lock<std::mutex> doneLock(doneMutex);
+    doneCondition.wait(doneLock, [&rangesLeft]() { return rangesLeft == 0; });
+  }
+  // the last worker might still hold the lock on the stack allocated mutex
+  std::lock_guard<std::mutex> doneLock(doneMutex);
+}
+
+bool JobSystem::RunPendingTask() {
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(TaskMutex);
+    if (Tasks.empty())
+      return false;
+    task = Tasks.front();
+    Tasks.pop_front();
+  }
+  task();
+  return true;
+}
+
+void JobSystem::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(TaskMutex);
+      TaskCondition.wait(lock,
+                         [this]() { return ShuttingDown || !Tasks.empty(); });
+      if (ShuttingDown && Tasks.empty())
+        return;
+      task = Tasks.front();
+      Tasks.pop_front();
+    }
+    task();
+  }
+}
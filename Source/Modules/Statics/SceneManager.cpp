@@ -1,8 +1,9 @@
 #include "Modules/Statics/SceneManager.h"
-#include <cassert>
 
 #include "Engine/AssetTypes/Asset.h"
 #include "Engine/AssetTypes/ExternalAsset.h"
+#include "Engine/Entity.h"
+#include "Modules/ResourceLoader/AssetCache.h"
 #include "Modules/ResourceLoader/ResourceLoader.h"
 #include "Modules/Statics/IAssetManager.h"
 #include "Modules/Statics/IEntityManager.h"
@@ -12,9 +13,15 @@
 
 #include "Modules/Statics/IComponentManager.h"
 #include "Modules/Statics/IEventSystem.h"
+#include "Modules/Statics/IGraphics.h"
 
 #include "Core.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
 #include <vector>
 REGISTER_SERIALIZED_CLASS(SceneManager)
 SceneManager::SceneManager(){};
@@ -25,22 +32,118 @@ void SceneManager::SetCurrentScene(const String &fileName) {
 
 String SceneManager::GetCurrentSceneFileName() { return CurrentSceneFileName; }
 
-bool SceneManager::UnloadCurrentScene() {
-  if (CurrentSceneFileName == "")
-    return true;
+void SceneManager::UnloadAllScenes() {
+  if (LoadedScenes.empty())
+    return;
 
-  std::vector<unsigned int>::iterator entityIdIterator;
   IEntityManager *entityManager = Statics::Get<IEntityManager>();
-
   entityManager->DestroyAllEntities();
 
   IAssetManager *assetManager = Statics::Get<IAssetManager>();
   assetManager->UnloadSceneAssets();
 
+  for (size_t x = 0; x < LoadedScenes.size(); x++)
+    ReleaseExternalAssets(LoadedScenes[x].ExternalAssetIds);
+
+  LoadedScenes.clear();
   SetCurrentScene("");
+}
+
+bool SceneManager::UnloadScene(const String &fileName) {
+  LoadedScene *scene = FindLoadedScene(fileName);
+  if (!scene)
+    return false;
+  S_LOG_FUNC("Unloading %s", fileName.GetCharArray());
+
+  // frames in flight might still reference the components
+  Statics::Get<IGraphics>()->Flush();
+  IEntityManager *entityManager = Statics::Get<IEntityManager>();
+  for (size_t x = 0; x < scene->EntityIds.size(); x++) {
+    if (!entityManager->IsPersistentEntity(scene->EntityIds[x]))
+      entityManager->Destroy(scene->EntityIds[x]);
+  }
+
+  // embedded assets are read again with the scene file, caching them
+  // wouldn't save anything
+  Statics::Get<IAssetManager>()->UnloadAssets(scene->AssetIds);
+  ReleaseExternalAssets(scene->ExternalAssetIds);
+
+  LoadedScenes.erase(LoadedScenes.begin() + (scene - &LoadedScenes[0]));
+  if (CurrentSceneFileName == fileName)
+    SetCurrentScene(LoadedScenes.empty() ? "" : LoadedScenes[0].FileName);
+  Statics::Get<IEventSystem>()->DispatchEvent(EventType::OnSceneUnload);
   return true;
 }
 
+bool SceneManager::IsSceneLoaded(const String &fileName) {
+  return FindLoadedScene(fileName) != nullptr;
+}
+
+SceneManager::LoadedScene *
+SceneManager::FindLoadedScene(const String &fileName) {
+  for (size_t x = 0; x < LoadedScenes.size(); x++) {
+    if (LoadedScenes[x].FileName == fileName)
+      return &LoadedScenes[x];
+  }
+  return nullptr;
+}
+
+std::shared_ptr<SceneManager::SceneLoad>
+SceneManager::FindPendingLoad(const String &fileName) {
+  for (size_t x = 0; x < PendingLoads.size(); x++) {
+    if (PendingLoads[x]->FileName == fileName)
+      return PendingLoads[x];
+  }
+  return nullptr;
+}
+
+void SceneManager::UseExternalAsset(SceneLoad &load, unsigned int assetId,
+                                    size_t fileSize) {
+  std::vector<unsigned int> &assetIds = load.ExternalAssetIds;
+  if (std::find(assetIds.begin(), assetIds.end(), assetId) != assetIds.end())
+    return;
+  assetIds.push_back(assetId);
+  ExternalAssetUse &use = ExternalAssetUsers[assetId];
+  if (use.Users++ > 0)
+    return;
+  use.FileSize = fileSize;
+  use.Handle = AssetHandle(assetId);
+}
+
+void SceneManager::ReleaseExternalAssets(
+    const std::vector<unsigned int> &assetIds) {
+  for (size_t x = 0; x < assetIds.size(); x++) {
+    std::unordered_map<unsigned int, ExternalAssetUse>::iterator it =
+        ExternalAssetUsers.find(assetIds[x]);
+    if (it == ExternalAssetUsers.end() || --it->second.Users > 0)
+      continue;
+    // unused external assets go to the asset cache, a scene loaded again
+    // soon finds them there
+    ExternalAssetUsers.erase(it);
+  }
+}
+
+size_t SceneManager::GetSceneMemoryUsage(const LoadedScene &scene) {
+  size_t usage = scene.FileSize;
+  for (size_t x = 0; x < scene.ExternalAssetIds.size(); x++) {
+    std::unordered_map<unsigned int, ExternalAssetUse>::iterator it =
+        ExternalAssetUsers.find(scene.ExternalAssetIds[x]);
+    if (it != ExternalAssetUsers.end())
+      usage += it->second.FileSize;
+  }
+  return usage;
+}
+
+size_t SceneManager::GetMemoryUsage() {
+  size_t usage = 0;
+  for (size_t x = 0; x < LoadedScenes.size(); x++)
+    usage += LoadedScenes[x].FileSize;
+  std::unordered_map<unsigned int, ExternalAssetUse>::iterator it;
+  for (it = ExternalAssetUsers.begin(); it != ExternalAssetUsers.end(); it++)
+    usage += it->second.FileSize;
+  return usage;
+}
+
 String SceneManager::GetExternalAssetPathRelativeToTheSceneFile(
     const String &assetFileName) {
   return GetExternalAssetPathRelativeToTheSceneFile(assetFileName,
@@ -58,28 +161,122 @@ String SceneManager::GetExternalAssetPathRelativeToTheSceneFile(
   return sceneRootDir + assetFileName;
 }
 
-bool SceneManager::LoadScene(const String &fileName) {
-  if (CurrentSceneFileName == fileName) // this scene is already loaded
-    return true;
-  S_LOG_FUNC("Loading %s", fileName.GetCharArray());
-  // handle scene loading
-  assert(UnloadCurrentScene()); // this should do fine
+SceneManager::~SceneManager() {
+  // loads that didn't finish join their workers and free what they read
+  PendingLoads.clear();
+}
 
-  // unload previous scene
-  std::vector<IDataNode *> nodes;
-  if (!ResourceLoader::LoadSsd(fileName, nodes))
-    return false;
-  // traverse through each node, create unique ids
-  UniqueIdSetter *uidSetter = new UniqueIdSetter(nodes);
-  // UniqueIdSetter::SetIds(nodes);
+bool SceneManager::LoadScene(const String &fileName, LoadMode mode) {
+  std::shared_ptr<ISceneLoadOperation> operation =
+      LoadSceneAsync(fileName, mode);
+  // earlier asynchronous loads finish first so scenes swap in request order
+  while (!PendingLoads.empty()) {
+    std::shared_ptr<SceneLoad> load = PendingLoads.front();
+    while (!load->IsDone())
+      StepSceneLoad(*load, true);
+    PendingLoads.pop_front();
+  }
+  return !operation->Failed();
+}
 
-  S_LOG_FUNC("Got %lu nodes", nodes.size());
+std::shared_ptr<ISceneLoadOperation>
+SceneManager::LoadSceneAsync(const String &fileName, LoadMode mode) {
+  std::shared_ptr<SceneLoad> pendingLoad = FindPendingLoad(fileName);
+  if (pendingLoad && pendingLoad->Mode == mode)
+    return pendingLoad;
+
+  std::shared_ptr<SceneLoad> load =
+      std::make_shared<SceneLoad>(fileName, mode);
+  // this scene is already loaded
+  bool loaded = mode == LoadMode::Additive
+                    ? IsSceneLoaded(fileName)
+                    : LoadedScenes.size() == 1 &&
+                          LoadedScenes[0].FileName == fileName;
+  if (PendingLoads.empty() && loaded)
+    load->Stage = Done;
+  else
+    PendingLoads.push_back(load);
+  return load;
+}
+
+void SceneManager::Update() {
+  if (PendingLoads.empty())
+    return;
+  std::shared_ptr<SceneLoad> load = PendingLoads.front();
+  StepSceneLoad(*load, false);
+  if (load->IsDone())
+    PendingLoads.pop_front();
+}
+
+void SceneManager::StepSceneLoad(SceneLoad &load, bool blocking) {
+  switch (load.Stage) {
+  case Parsing:
+    if (RunStage(load, &SceneManager::ParseScene, blocking))
+      load.Stage = load.StageSucceeded ? Resolving : SceneLoadStage::Failed;
+    break;
+  case Resolving:
+    ResolveExternalAssets(load);
+    load.Stage = Deserializing;
+    break;
+  case Deserializing:
+    if (RunStage(load, &SceneManager::DeserializeScene, blocking))
+      load.Stage = Instantiating;
+    break;
+  case Instantiating:
+    if (InstantiateExternalAssets(load, blocking))
+      load.Stage = Swapping;
+    break;
+  case Swapping:
+    SwapScene(load);
+    load.Stage = Done;
+    break;
+  default:
+    break;
+  }
+}
 
+bool SceneManager::RunStage(SceneLoad &load,
+                            void (SceneManager::*stage)(SceneLoad &),
+                            bool blocking) {
+  if (load.Worker.joinable()) {
+    if (!blocking && !load.WorkerDone)
+      return false;
+    load.Worker.join();
+    return true;
+  }
+  if (blocking) {
+    (this->*stage)(load);
+    return true;
+  }
+  load.WorkerDone = false;
+  SceneLoad *loadPointer = &load;
+  load.Worker = std::thread([this, loadPointer, stage]() {
+    (this->*stage)(*loadPointer);
+    loadPointer->WorkerDone = true;
+  });
+  return false;
+}
+
+void SceneManager::ParseScene(SceneLoad &load) {
+  S_LOG_FUNC("Loading %s", load.FileName.GetCharArray());
+  if (!ResourceLoader::LoadSsd(load.FileName, load.Nodes)) {
+    S_LOG_FUNC("Couldn't load %s", load.FileName.GetCharArray());
+    load.StageSucceeded = false;
+    return;
+  }
+  load.FileSize = ResourceLoader::GetFileSize(load.FileName);
+  S_LOG_FUNC("Got %lu nodes", load.Nodes.size());
+}
+
+void SceneManager::ResolveExternalAssets(SceneLoad &load) {
+  // ids are handed out here rather than on the worker, so they don't depend
+  // on how the load interleaves with the main thread
+  load.UidSetter = new UniqueIdSetter(load.Nodes);
   IAssetManager *assetManager = Statics::Get<IAssetManager>();
   // old id new id pairs
   std::unordered_map<unsigned int, unsigned int> uniqueIdsToReplace;
-  for (unsigned int z = 0; z < nodes.size(); z++) {
-    IDataNode *node = nodes[z];
+  for (unsigned int z = 0; z < load.Nodes.size(); z++) {
+    IDataNode *node = load.Nodes[z];
     // handle external asset here
     if ((node->Name() == "ExternalAsset") == false)
       continue;
@@ -91,105 +288,309 @@ bool SceneManager::LoadScene(const String &fileName) {
         continue;
       TypedAttributeValue<String> *stringAttribute =
           dynamic_cast<TypedAttributeValue<String> *>(attr);
-      String assetFileName = stringAttribute->Get();
-      unsigned int assetId = assetManager->IsExternalAssetLoaded(
-          GetExternalAssetPathRelativeToTheSceneFile(assetFileName, fileName));
-      if (assetId == 0)
+      ExternalAssetLoad externalAsset;
+      externalAsset.FileName = GetExternalAssetPathRelativeToTheSceneFile(
+          stringAttribute->Get(), load.FileName);
+      externalAsset.UniqueId = node->GetUniqueID();
+
+      unsigned int assetId =
+          assetManager->IsExternalAssetLoaded(externalAsset.FileName);
+      if (assetId != 0) {
+        Statics::ReturnUniqueId(node->GetUniqueID());
+        uniqueIdsToReplace[node->GetUniqueID()] = assetId;
+        UseExternalAsset(load, assetId,
+                         ResourceLoader::GetFileSize(externalAsset.FileName));
         continue;
-      Statics::ReturnUniqueId(node->GetUniqueID());
-      uniqueIdsToReplace[node->GetUniqueID()] = assetId;
+      }
+      bool queued = false;
+      for (size_t y = 0; y < load.ExternalAssets.size() && !queued; y++)
+        queued = load.ExternalAssets[y].FileName == externalAsset.FileName;
+      if (!queued)
+        load.ExternalAssets.push_back(externalAsset);
     }
   }
 
   if (uniqueIdsToReplace.size())
-    UniqueIdSetter::ReplaceIds(nodes, uniqueIdsToReplace);
+    UniqueIdSetter::ReplaceIds(load.Nodes, uniqueIdsToReplace);
+}
 
-  std::vector<ISerialized *> deserializedNodes;
-  for (size_t x = 0; x < nodes.size(); x++) {
-    ISerialized *deserializedDataNode = nodes[x]->Deserialize();
-    if (deserializedDataNode)
-      deserializedNodes.push_back(deserializedDataNode);
+void SceneManager::DeserializeScene(SceneLoad &load) {
+  // external asset nodes are only placeholders for the files read below
+  for (size_t x = 0; x < load.Nodes.size(); x++) {
+    if (load.Nodes[x]->Name() == "ExternalAsset")
+      continue;
+    IObject *serializedObject =
+        dynamic_cast<IObject *>(load.Nodes[x]->Deserialize());
+    if (!serializedObject)
+      continue;
+    Asset *asset = dynamic_cast<Asset *>(serializedObject);
+    if (asset)
+      asset->Prepare();
+    load.SceneObjects.push_back(serializedObject);
+  }
 
-    // add instance
-    IObject *serializedObject = dynamic_cast<IObject *>(deserializedDataNode);
+  std::vector<ExternalAssetLoad> &externalAssets = load.ExternalAssets;
+  unsigned int count = static_cast<unsigned int>(externalAssets.size());
+  // the loader has threads of its own, jobs holding the pool for the whole
+  // load would delay the frame's jobs or get run by a waiting frame thread.
+  // Each thread pulls the next file so a single large mesh doesn't hold up
+  // the others
+  std::atomic<unsigned int> nextAsset(0);
+  std::function<void()> readAssets = [&]() {
+    for (unsigned int x = nextAsset++; x < count; x = nextAsset++) {
+      externalAssets[x].Object =
+          ReadExternalAsset(externalAssets[x], load.UidSetter);
+      externalAssets[x].FileSize =
+          ResourceLoader::GetFileSize(externalAssets[x].FileName);
+      load.ExternalAssetsRead++;
+    }
+  };
+  unsigned int threadCount = std::thread::hardware_concurrency();
+  threadCount = std::min(std::min(threadCount, count),
+                         (unsigned int)SCENE_LOADER_MAX_THREADS);
+  // the calling thread reads as well
+  std::vector<std::thread> threads;
+  for (unsigned int x = 1; x < threadCount; x++)
+    threads.push_back(std::thread(readAssets));
+  readAssets();
+  for (size_t x = 0; x < threads.size(); x++)
+    threads[x].join();
+}
 
-    Statics::AddSerializedObject(serializedObject);
+bool SceneManager::InstantiateExternalAssets(SceneLoad &load, bool blocking) {
+  // external assets outlive scene unloads, so they can be registered while
+  // the current scene is still live
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  IAssetManager *assetManager = Statics::Get<IAssetManager>();
+  // the render thread looks assets up while executing the previous frame
+  if (load.ExternalAssetsRegistered < load.ExternalAssets.size())
+    Statics::Get<IGraphics>()->Flush();
+  while (load.ExternalAssetsRegistered < load.ExternalAssets.size()) {
+    ExternalAssetLoad &externalAsset =
+        load.ExternalAssets[load.ExternalAssetsRegistered++];
+    if (!externalAsset.Object) {
+      S_LOG_FUNC("Couldn't load %s", externalAsset.FileName.GetCharArray());
+      continue;
+    }
+    Statics::AddSerializedObject(externalAsset.Object);
+    Asset *loadedAsset = dynamic_cast<Asset *>(externalAsset.Object);
+    loadedAsset->SetOrigin(Asset::OriginType::External);
+    loadedAsset->SetFileName(externalAsset.FileName);
+    assetManager->SaveExternalAssetPath(externalAsset.FileName,
+                                        externalAsset.UniqueId);
+    UseExternalAsset(load, externalAsset.UniqueId, externalAsset.FileSize);
+    // registered objects belong to the asset manager now
+    externalAsset.Object = nullptr;
+    S_LOG_FUNC("Loaded %s", externalAsset.FileName.GetCharArray());
+
+    double elapsed = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (!blocking && elapsed > SCENE_INSTANTIATE_BUDGET_MS)
+      return false;
   }
+  return true;
+}
 
-  std::vector<ISerialized *> entities;
-
-  for (unsigned int x = 0; x < deserializedNodes.size(); x++) {
-    Asset *asset = dynamic_cast<Asset *>(deserializedNodes[x]);
+void SceneManager::SwapScene(SceneLoad &load) {
+  // the render thread resolves assets while executing, keep it idle while
+  // the asset maps change
+  Statics::Get<IGraphics>()->Flush();
+  // the new scene already counts as a user of its external assets, the
+  // shared ones survive the unload
+  if (load.Mode == LoadMode::Single)
+    UnloadAllScenes();
+  else
+    UnloadScene(load.FileName);
+
+  LoadedScene scene;
+  scene.FileName = load.FileName;
+  scene.FileSize = load.FileSize;
+  scene.ExternalAssetIds = load.ExternalAssetIds;
+
+  std::vector<IObject *> &sceneObjects = load.SceneObjects;
+  for (size_t x = 0; x < sceneObjects.size(); x++)
+    Statics::AddSerializedObject(sceneObjects[x]);
+
+  for (size_t x = 0; x < sceneObjects.size(); x++) {
+    Asset *asset = dynamic_cast<Asset *>(sceneObjects[x]);
     if (asset) {
       asset->SetOrigin(Asset::OriginType::Scene);
-      asset->SetFileName(fileName);
+      asset->SetFileName(load.FileName);
+      scene.AssetIds.push_back(sceneObjects[x]->UniqueID());
     }
 
-    if (deserializedNodes[x]->SerializedName() == "Entity") {
-      entities.push_back(deserializedNodes[x]);
+    if (sceneObjects[x]->SerializedName() == "Entity") {
       // won't return the unique id
-      delete deserializedNodes[x];
+      delete sceneObjects[x];
     }
 
-    else if (deserializedNodes[x]->SerializedName() == "EntityIdCollection") {
-      EntityComponentIdSetter::UpdateIds(deserializedNodes[x]);
+    else if (sceneObjects[x]->SerializedName() == "EntityIdCollection") {
+      EntityIdCollection *collection =
+          dynamic_cast<EntityIdCollection *>(sceneObjects[x]);
+      scene.EntityIds.insert(scene.EntityIds.end(), collection->Ids.begin(),
+                             collection->Ids.end());
+      EntityComponentIdSetter::UpdateIds(sceneObjects[x]);
       // will return the unique id
-      Statics::Destroy(dynamic_cast<IObject *>(deserializedNodes[x]));
-    }
-
-    // handle external node
-    else if (deserializedNodes[x]->SerializedName() == "ExternalAsset") {
-      LoadExternalAssetFromScene(deserializedNodes[x], fileName, uidSetter);
+      Statics::Destroy(sceneObjects[x]);
     }
   }
+  sceneObjects.clear();
 
   // helper types which are supposed to be deleted once the scene is loaded
+  IAssetManager *assetManager = Statics::Get<IAssetManager>();
   assetManager->RemoveAssetType("Entity");
   assetManager->RemoveAssetType("EntityIdCollection");
-  assetManager->RemoveAssetType("ExternalAsset");
 
-  for (size_t x = 0; x < nodes.size(); x++)
-    delete nodes[x];
+  LoadedScenes.push_back(scene);
+  for (size_t x = 0; x < StreamingCells.size(); x++) {
+    if (StreamingCells[x].FileName == load.FileName)
+      StreamingCells[x].EstimatedSize = GetSceneMemoryUsage(scene);
+  }
 
   Statics::Get<IEventSystem>()->DispatchEvent(EventType::OnSceneLoad);
-  SetCurrentScene(fileName);
+  if (load.Mode == LoadMode::Single || CurrentSceneFileName == "")
+    SetCurrentScene(load.FileName);
+}
 
-  return true;
+void SceneManager::AddStreamingCell(const String &fileName,
+                                    const glm::vec3 &center, float radius) {
+  StreamingCell cell;
+  cell.FileName = fileName;
+  cell.Center = center;
+  cell.Radius = radius;
+  cell.EstimatedSize = ResourceLoader::GetFileSize(fileName);
+  StreamingCells.push_back(cell);
 }
 
-void SceneManager::LoadExternalAssetFromScene(ISerialized *obj,
-                                              const String &sceneFileName,
-                                              UniqueIdSetter *uidSetter) {
-  ExternalAsset *externalAsset = dynamic_cast<ExternalAsset *>(obj);
+void SceneManager::RemoveStreamingCell(const String &fileName) {
+  for (size_t x = 0; x < StreamingCells.size(); x++) {
+    if (StreamingCells[x].FileName == fileName) {
+      StreamingCells.erase(StreamingCells.begin() + x);
+      return;
+    }
+  }
+}
+
+void SceneManager::SetStreamingMemoryBudget(size_t bytes) {
+  StreamingMemoryBudget = bytes;
+}
+
+void SceneManager::UpdateStreaming(const glm::vec3 &viewerPosition) {
+  // cells sorted by distance to the viewer
+  std::vector<std::pair<float, size_t>> cells;
+  for (size_t x = 0; x < StreamingCells.size(); x++) {
+    float distance = glm::length(StreamingCells[x].Center - viewerPosition);
+    cells.push_back(std::make_pair(distance, x));
+  }
+  std::sort(cells.begin(), cells.end());
 
-  const String fileName = GetExternalAssetPathRelativeToTheSceneFile(
-      externalAsset->FileName, sceneFileName);
+  bool loading = false;
+  for (size_t x = 0; x < cells.size(); x++) {
+    StreamingCell &cell = StreamingCells[cells[x].second];
+    if (FindPendingLoad(cell.FileName)) {
+      loading = true;
+      continue;
+    }
+    if (cells[x].first > cell.Radius * SCENE_STREAMING_UNLOAD_FACTOR)
+      UnloadScene(cell.FileName);
+  }
 
-  unsigned int uniqueId = externalAsset->UniqueID();
-  delete externalAsset;
+  size_t budget = StreamingMemoryBudget;
+  // over budget, the farthest cells go first
+  for (size_t x = cells.size(); x > 0 && budget; x--) {
+    if (GetMemoryUsage() <= budget)
+      break;
+    UnloadScene(StreamingCells[cells[x - 1].second].FileName);
+  }
 
-  S_LOG_FUNC("Started loading %s", fileName.GetCharArray());
-  if (Statics::Get<IAssetManager>()->IsExternalAssetLoaded(fileName))
+  // a cell at a time, nearest first
+  if (loading)
+    return;
+  for (size_t x = 0; x < cells.size(); x++) {
+    StreamingCell &cell = StreamingCells[cells[x].second];
+    if (cells[x].first > cell.Radius || IsSceneLoaded(cell.FileName))
+      continue;
+    // make room by unloading cells farther away than this one
+    for (size_t y = cells.size() - 1; y > x && budget; y--) {
+      if (GetMemoryUsage() + cell.EstimatedSize <= budget)
+        break;
+      UnloadScene(StreamingCells[cells[y].second].FileName);
+    }
+    if (budget && GetMemoryUsage() + cell.EstimatedSize > budget)
+      return;
+    LoadSceneAsync(cell.FileName, LoadMode::Additive);
     return;
-  Asset *loadedAsset;
-  {
+  }
+}
+
+SceneManager::SceneLoad::~SceneLoad() {
+  if (Worker.joinable())
+    Worker.join();
+  for (size_t x = 0; x < Nodes.size(); x++)
+    delete Nodes[x];
+  delete UidSetter;
+  // objects of a load that never got swapped in
+  for (size_t x = 0; x < SceneObjects.size(); x++)
+    delete SceneObjects[x];
+  for (size_t x = 0; x < ExternalAssets.size(); x++)
+    delete ExternalAssets[x].Object;
+}
+
+float SceneManager::SceneLoad::GetProgress() {
+  unsigned int externalCount =
+      static_cast<unsigned int>(ExternalAssets.size());
+  float read = externalCount ? (float)ExternalAssetsRead / externalCount : 1.f;
+  float registered =
+      externalCount ? (float)ExternalAssetsRegistered / externalCount : 1.f;
+  switch (Stage) {
+  case Parsing:
+    return 0.f;
+  case Resolving:
+    return 0.2f;
+  case Deserializing:
+    return 0.2f + 0.6f * read;
+  case Instantiating:
+    return 0.8f + 0.15f * registered;
+  case Swapping:
+    return 0.95f;
+  default:
+    return 1.f;
+  }
+}
+
+// runs on a worker, touches nothing but the loaded file and its object
+IObject *SceneManager::ReadExternalAsset(const ExternalAssetLoad &load,
+                                         UniqueIdSetter *uidSetter) {
+  // a cooked copy of the asset skips the import done by OnLoad
+  unsigned long long cacheKey = 0;
+  bool cacheable = AssetCache::GetKey(load.FileName, cacheKey);
+  IObject *serializedClass = cacheable ? AssetCache::Load(cacheKey) : nullptr;
+  bool cooked = serializedClass != nullptr;
+  if (!cooked) {
     std::vector<IDataNode *> nodes;
-    assert(ResourceLoader::LoadSsd(fileName, nodes));
-    assert(nodes.size() == 1);
+    bool loaded = ResourceLoader::LoadSsd(load.FileName, nodes);
+    if (!loaded || nodes.size() != 1) {
+      for (size_t x = 0; x < nodes.size(); x++)
+        delete nodes[x];
+      return nullptr;
+    }
     // the loaded may contain references to the other assets of the scene
     uidSetter->UpdateAttributeUid(nodes[0]);
-    IObject *serializedClass = dynamic_cast<IObject *>(nodes[0]->Deserialize());
-    serializedClass->SetUniqueID(uniqueId);
-    Statics::AddSerializedObject(serializedClass);
-    loadedAsset = dynamic_cast<Asset *>(serializedClass);
-    assert(loadedAsset != NULL);
-    loadedAsset->SetOrigin(Asset::OriginType::External);
-    loadedAsset->SetFileName(fileName);
-    Statics::Get<IAssetManager>()->SaveExternalAssetPath(
-        fileName, serializedClass->UniqueID());
-    // clean up
+    serializedClass = dynamic_cast<IObject *>(nodes[0]->Deserialize());
     delete nodes[0];
   }
-  // assert(ResourceLoader::LoadAsset(fileName, loadedAsset, uniqueId));
-  S_LOG_FUNC("Loaded %s", fileName.GetCharArray());
+  Asset *asset = dynamic_cast<Asset *>(serializedClass);
+  if (!asset) {
+    delete serializedClass;
+    return nullptr;
+  }
+  serializedClass->SetUniqueID(load.UniqueId);
+  // importing and optimizing is the expensive part, do it here rather than
+  // on registration
+  asset->Prepare();
+  if (!cooked && cacheable && asset->IsCookable())
+    AssetCache::Save(cacheKey, serializedClass);
+  return serializedClass;
 }
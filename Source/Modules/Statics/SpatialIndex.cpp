@@ -0,0 +1,444 @@
+#include "Modules/Statics/SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+REGISTER_SERIALIZED_CLASS(SpatialIndex)
+
+// how much leaf boxes get enlarged
+#define SPATIAL_INDEX_MARGIN .1f
+
+namespace {
+float SurfaceArea(const glm::vec3 &min, const glm::vec3 &max) {
+  glm::vec3 size = max - min;
+  return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool Contains(const glm::vec3 &outerMin, const glm::vec3 &outerMax,
+              const glm::vec3 &innerMin, const glm::vec3 &innerMax) {
+  return glm::all(glm::lessThanEqual(outerMin, innerMin)) &&
+         glm::all(glm::greaterThanEqual(outerMax, innerMax));
+}
+
+bool Overlaps(const glm::vec3 &minA, const glm::vec3 &maxA,
+              const glm::vec3 &minB, const glm::vec3 &maxB) {
+  return glm::all(glm::lessThanEqual(minA, maxB)) &&
+         glm::all(glm::greaterThanEqual(maxA, minB));
+}
+
+enum FrustumTest { Outside, Intersecting, Inside };
+
+FrustumTest TestFrustum(const CullingUtils::Frustum &frustum,
+                        const glm::vec3 &min, const glm::vec3 &max) {
+  glm::vec3 center = (min + max) * .5f;
+  glm::vec3 extents = (max - min) * .5f;
+  FrustumTest result = Inside;
+  for (int p = 0; p < 6; p++) {
+    const glm::vec4 &plane = frustum.Planes[p];
+    float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+    float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+    if (distance + radius < 0.f)
+      return Outside;
+    if (distance - radius < 0.f)
+      result = Intersecting;
+  }
+  return result;
+}
+
+// slab test, returns the entry distance
+bool RayBox(const glm::vec3 &origin, const glm::vec3 &inverseDirection,
+            const glm::vec3 &min, const glm::vec3 &max, float maxDistance,
+            float &distance) {
+  glm::vec3 t0 = (min - origin) * inverseDirection;
+  glm::vec3 t1 = (max - origin) * inverseDirection;
+  glm::vec3 tMin = glm::min(t0, t1);
+  glm::vec3 tMax = glm::max(t0, t1);
+  float entry = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.f));
+  float exit =
+      std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDistance));
+  distance = entry;
+  return entry <= exit;
+}
+} // namespace
+
+SpatialIndex::SpatialIndex() { Clear(); }
+
+void SpatialIndex::Clear() {
+  Nodes.clear();
+  Root = SPATIAL_PROXY_NONE;
+  UnboundedProxies.clear();
+  FreeList = SPATIAL_PROXY_NONE;
+  for (int x = 0; x < 8; x++)
+    ProxyCounts[x] = 0;
+}
+
+unsigned int SpatialIndex::GetProxyCount(unsigned char typeMask) {
+  unsigned int count = 0;
+  for (int x = 0; x < 8; x++)
+    if (typeMask & (1 << x))
+      count += ProxyCounts[x];
+  return count;
+}
+
+int SpatialIndex::AllocateNode() {
+  if (FreeList == SPATIAL_PROXY_NONE) {
+    Nodes.push_back(TreeNode());
+    return static_cast<int>(Nodes.size()) - 1;
+  }
+  int nodeId = FreeList;
+  FreeList = Nodes[nodeId].Parent;
+  Nodes[nodeId] = TreeNode();
+  return nodeId;
+}
+
+void SpatialIndex::FreeNode(int nodeId) {
+  Nodes[nodeId].Parent = FreeList;
+  Nodes[nodeId].Height = -1;
+  FreeList = nodeId;
+}
+
+void SpatialIndex::CountProxy(unsigned char typeMask, int count) {
+  for (int x = 0; x < 8; x++)
+    if (typeMask & (1 << x))
+      ProxyCounts[x] += count;
+}
+
+int SpatialIndex::CreateProxy(const BoundingBox &box, unsigned int entityId,
+                              unsigned char typeMask) {
+  int proxyId = AllocateNode();
+  TreeNode &node = Nodes[proxyId];
+  node.BoundsMin = box.GetMin();
+  node.BoundsMax = box.GetMax();
+  node.Min = node.BoundsMin - glm::vec3(SPATIAL_INDEX_MARGIN);
+  node.Max = node.BoundsMax + glm::vec3(SPATIAL_INDEX_MARGIN);
+  node.EntityId = entityId;
+  node.TypeMask = typeMask;
+  node.Height = 0;
+  InsertLeaf(proxyId);
+  CountProxy(typeMask, 1);
+  return proxyId;
+}
+
+int SpatialIndex::CreateUnboundedProxy(unsigned int entityId,
+                                       unsigned char typeMask) {
+  int proxyId = AllocateNode();
+  TreeNode &node = Nodes[proxyId];
+  node.EntityId = entityId;
+  node.TypeMask = typeMask;
+  node.Height = 0;
+  node.Unbounded = true;
+  UnboundedProxies.push_back(proxyId);
+  CountProxy(typeMask, 1);
+  return proxyId;
+}
+
+void SpatialIndex::DestroyProxy(int proxyId) {
+  if (proxyId < 0 || proxyId >= static_cast<int>(Nodes.size()) ||
+      Nodes[proxyId].Height != 0)
+    return;
+  unsigned char typeMask = Nodes[proxyId].TypeMask;
+  if (Nodes[proxyId].Unbounded)
+    UnboundedProxies.erase(std::find(UnboundedProxies.begin(),
+                                     UnboundedProxies.end(), proxyId));
+  else
+    RemoveLeaf(proxyId);
+  FreeNode(proxyId);
+  CountProxy(typeMask, -1);
+}
+
+bool SpatialIndex::MoveProxy(int proxyId, const BoundingBox &box) {
+  TreeNode &node = Nodes[proxyId];
+  if (node.Unbounded)
+    return false;
+  node.BoundsMin = box.GetMin();
+  node.BoundsMax = box.GetMax();
+  if (Contains(node.Min, node.Max, node.BoundsMin, node.BoundsMax))
+    return false;
+
+  // removing the leaf doesn't reallocate the nodes
+  RemoveLeaf(proxyId);
+  node.Min = node.BoundsMin - glm::vec3(SPATIAL_INDEX_MARGIN);
+  node.Max = node.BoundsMax + glm::vec3(SPATIAL_INDEX_MARGIN);
+  InsertLeaf(proxyId);
+  return true;
+}
+
+void SpatialIndex::InsertLeaf(int leafId) {
+  if (Root == SPATIAL_PROXY_NONE) {
+    Root = leafId;
+    Nodes[Root].Parent = SPATIAL_PROXY_NONE;
+    return;
+  }
+
+  // find the best sibling by the surface area heuristic
+  glm::vec3 leafMin = Nodes[leafId].Min;
+  glm::vec3 leafMax = Nodes[leafId].Max;
+  int index = Root;
+  while (!Nodes[index].IsLeaf()) {
+    const TreeNode &node = Nodes[index];
+    float area = SurfaceArea(node.Min, node.Max);
+    float combinedArea = SurfaceArea(glm::min(node.Min, leafMin),
+                                     glm::max(node.Max, leafMax));
+    // cost of creating a new parent for this node and the leaf
+    float cost = 2.f * combinedArea;
+    // minimum cost of pushing the leaf further down the tree
+    float inheritanceCost = 2.f * (combinedArea - area);
+
+    float childCosts[2];
+    int children[2] = {node.Child1, node.Child2};
+    for (int c = 0; c < 2; c++) {
+      const TreeNode &child = Nodes[children[c]];
+      float enlargedArea = SurfaceArea(glm::min(child.Min, leafMin),
+                                       glm::max(child.Max, leafMax));
+      childCosts[c] = enlargedArea + inheritanceCost;
+      if (!child.IsLeaf())
+        childCosts[c] -= SurfaceArea(child.Min, child.Max);
+    }
+
+    if (cost < childCosts[0] && cost < childCosts[1])
+      break;
+    index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+  }
+
+  int sibling = index;
+  int oldParent = Nodes[sibling].Parent;
+  int newParent = AllocateNode();
+  Nodes[newParent].Parent = oldParent;
+  Nodes[newParent].Child1 = sibling;
+  Nodes[newParent].Child2 = leafId;
+  Nodes[sibling].Parent = newParent;
+  Nodes[leafId].Parent = newParent;
+
+  if (oldParent == SPATIAL_PROXY_NONE)
+    Root = newParent;
+  else if (Nodes[oldParent].Child1 == sibling)
+    Nodes[oldParent].Child1 = newParent;
+  else
+    Nodes[oldParent].Child2 = newParent;
+
+  Refit(newParent);
+}
+
+void SpatialIndex::RemoveLeaf(int leafId) {
+  if (leafId == Root) {
+    Root = SPATIAL_PROXY_NONE;
+    return;
+  }
+
+  int parent = Nodes[leafId].Parent;
+  int grandParent = Nodes[parent].Parent;
+  int sibling = Nodes[parent].Child1 == leafId ? Nodes[parent].Child2
+                                               : Nodes[parent].Child1;
+
+  if (grandParent == SPATIAL_PROXY_NONE) {
+    Root = sibling;
+    Nodes[sibling].Parent = SPATIAL_PROXY_NONE;
+    FreeNode(parent);
+    return;
+  }
+
+  // the sibling takes the place of the parent
+  if (Nodes[grandParent].Child1 == parent)
+    Nodes[grandParent].Child1 = sibling;
+  else
+    Nodes[grandParent].Child2 = sibling;
+  Nodes[sibling].Parent = grandParent;
+  FreeNode(parent);
+  Refit(grandParent);
+}
+
+void SpatialIndex::Refit(int nodeId) {
+  while (nodeId != SPATIAL_PROXY_NONE) {
+    nodeId = Balance(nodeId);
+    TreeNode &node = Nodes[nodeId];
+    const TreeNode &child1 = Nodes[node.Child1];
+    const TreeNode &child2 = Nodes[node.Child2];
+    node.Min = glm::min(child1.Min, child2.Min);
+    node.Max = glm::max(child1.Max, child2.Max);
+    node.Height = 1 + std::max(child1.Height, child2.Height);
+    node.TypeMask = child1.TypeMask | child2.TypeMask;
+    nodeId = node.Parent;
+  }
+}
+
+// rotates the higher grand child up if the node is unbalanced,
+// returns the node now at the position of the passed one
+int SpatialIndex::Balance(int nodeA) {
+  TreeNode &a = Nodes[nodeA];
+  if (a.IsLeaf() || a.Height < 2)
+    return nodeA;
+
+  int nodeB = a.Child1;
+  int nodeC = a.Child2;
+  int balance = Nodes[nodeC].Height - Nodes[nodeB].Height;
+  if (balance >= -1 && balance <= 1)
+    return nodeA;
+
+  // rotate the taller child up
+  int nodeUp = balance > 1 ? nodeC : nodeB;
+  int nodeStay = balance > 1 ? nodeB : nodeC;
+  TreeNode &up = Nodes[nodeUp];
+  int nodeF = up.Child1;
+  int nodeG = up.Child2;
+
+  up.Child1 = nodeA;
+  up.Parent = a.Parent;
+  a.Parent = nodeUp;
+
+  if (up.Parent == SPATIAL_PROXY_NONE)
+    Root = nodeUp;
+  else if (Nodes[up.Parent].Child1 == nodeA)
+    Nodes[up.Parent].Child1 = nodeUp;
+  else
+    Nodes[up.Parent].Child2 = nodeUp;
+
+  // the taller grand child stays with the rotated node
+  int tallChild = Nodes[nodeF].Height > Nodes[nodeG].Height ? nodeF : nodeG;
+  int shortChild = tallChild == nodeF ? nodeG : nodeF;
+  up.Child2 = tallChild;
+  if (balance > 1)
+    a.Child2 = shortChild;
+  else
+    a.Child1 = shortChild;
+  Nodes[shortChild].Parent = nodeA;
+
+  const TreeNode &stay = Nodes[nodeStay];
+  const TreeNode &shortNode = Nodes[shortChild];
+  a.Min = glm::min(stay.Min, shortNode.Min);
+  a.Max = glm::max(stay.Max, shortNode.Max);
+  a.Height = 1 + std::max(stay.Height, shortNode.Height);
+  a.TypeMask = stay.TypeMask | shortNode.TypeMask;
+  return nodeUp;
+}
+
+void SpatialIndex::AppendLeaves(int nodeId, unsigned char typeMask,
+                                std::vector<unsigned int> &entityIds) {
+  size_t stackBase = Stack.size();
+  Stack.push_back(nodeId);
+  while (Stack.size() > stackBase) {
+    int index = Stack.back();
+    Stack.pop_back();
+    const TreeNode &node = Nodes[index];
+    if ((node.TypeMask & typeMask) == 0)
+      continue;
+    if (node.IsLeaf()) {
+      entityIds.push_back(node.EntityId);
+      continue;
+    }
+    Stack.push_back(node.Child1);
+    Stack.push_back(node.Child2);
+  }
+}
+
+void SpatialIndex::AppendUnboundedProxies(
+    unsigned char typeMask, std::vector<unsigned int> &entityIds) {
+  for (size_t x = 0; x < UnboundedProxies.size(); x++) {
+    const TreeNode &node = Nodes[UnboundedProxies[x]];
+    if (node.TypeMask & typeMask)
+      entityIds.push_back(node.EntityId);
+  }
+}
+
+void SpatialIndex::QueryFrustum(const CullingUtils::Frustum &frustum,
+                                unsigned char typeMask,
+                                std::vector<unsigned int> &entityIds) {
+  AppendUnboundedProxies(typeMask, entityIds);
+  if (Root == SPATIAL_PROXY_NONE)
+    return;
+
+  // internal nodes reject whole subtrees, leaves of intersecting nodes are
+  // tested in a batch afterwards
+  CandidateLeaves.clear();
+  CandidateBoxes.Clear();
+  Stack.clear();
+  Stack.push_back(Root);
+  while (!Stack.empty()) {
+    int index = Stack.back();
+    Stack.pop_back();
+    const TreeNode &node = Nodes[index];
+    if ((node.TypeMask & typeMask) == 0)
+      continue;
+
+    if (node.IsLeaf()) {
+      CandidateLeaves.push_back(index);
+      CandidateBoxes.Add(BoundingBox::FromMinMax(node.Min, node.Max));
+      continue;
+    }
+
+    FrustumTest test = TestFrustum(frustum, node.Min, node.Max);
+    if (test == Outside)
+      continue;
+    if (test == Inside) {
+      AppendLeaves(index, typeMask, entityIds);
+      continue;
+    }
+    Stack.push_back(node.Child1);
+    Stack.push_back(node.Child2);
+  }
+
+  CullingUtils::CullBoxes(frustum, CandidateBoxes, CandidateVisibility);
+  for (size_t x = 0; x < CandidateLeaves.size(); x++)
+    if (CandidateVisibility[x])
+      entityIds.push_back(Nodes[CandidateLeaves[x]].EntityId);
+}
+
+void SpatialIndex::QueryBox(const BoundingBox &box, unsigned char typeMask,
+                            std::vector<unsigned int> &entityIds) {
+  AppendUnboundedProxies(typeMask, entityIds);
+  if (Root == SPATIAL_PROXY_NONE)
+    return;
+  glm::vec3 min = box.GetMin();
+  glm::vec3 max = box.GetMax();
+  Stack.clear();
+  Stack.push_back(Root);
+  while (!Stack.empty()) {
+    int index = Stack.back();
+    Stack.pop_back();
+    const TreeNode &node = Nodes[index];
+    if ((node.TypeMask & typeMask) == 0 ||
+        !Overlaps(node.Min, node.Max, min, max))
+      continue;
+    if (node.IsLeaf()) {
+      entityIds.push_back(node.EntityId);
+      continue;
+    }
+    Stack.push_back(node.Child1);
+    Stack.push_back(node.Child2);
+  }
+}
+
+bool SpatialIndex::RayCast(const glm::vec3 &origin, const glm::vec3 &direction,
+                           float maxDistance, unsigned char typeMask,
+                           unsigned int &entityId, float &distance) {
+  if (Root == SPATIAL_PROXY_NONE)
+    return false;
+  // division by zero gives infinities which the slab test handles
+  glm::vec3 inverseDirection = 1.f / direction;
+  float closest = maxDistance;
+  bool hit = false;
+
+  Stack.clear();
+  Stack.push_back(Root);
+  while (!Stack.empty()) {
+    int index = Stack.back();
+    Stack.pop_back();
+    const TreeNode &node = Nodes[index];
+    float entry;
+    if ((node.TypeMask & typeMask) == 0 ||
+        !RayBox(origin, inverseDirection, node.Min, node.Max, closest, entry))
+      continue;
+    if (node.IsLeaf()) {
+      // the fattened box only narrows down the candidates
+      if (!RayBox(origin, inverseDirection, node.BoundsMin, node.BoundsMax,
+                  closest, entry))
+        continue;
+      closest = entry;
+      entityId = node.EntityId;
+      hit = true;
+      continue;
+    }
+    Stack.push_back(node.Child1);
+    Stack.push_back(node.Child2);
+  }
+  distance = closest;
+  return hit;
+}
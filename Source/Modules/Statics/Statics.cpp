@@ -1,15 +1,23 @@
 #include "Modules/Statics/Statics.h"
 #include "Utility/Data/ISerialized.h"
 
+#include "Engine/AssetTypes/Asset.h"
 #include "Engine/IComponent.h"
 #include "Modules/Statics/IAssetManager.h"
 #include "Modules/Statics/IComponentManager.h"
 
+#include <mutex>
+
 Statics *Statics::Instance = nullptr;
 
 Statics::Statics() {}
 
+// scenes are parsed on worker threads, ids are handed out from several
+// threads at once
+static std::mutex IdMutex;
+
 unsigned int Statics::GetUniqueId() {
+  std::lock_guard<std::mutex> lock(IdMutex);
   Statics *instance = GetInstance();
   if ((instance->IdPool).size() == 0) {
     return instance->NextId++;
@@ -20,12 +28,16 @@ unsigned int Statics::GetUniqueId() {
 }
 
 void Statics::ReturnUniqueId(unsigned int uid) {
+  std::lock_guard<std::mutex> lock(IdMutex);
   GetInstance()->IdPool.push_back(uid);
 }
 
 void Statics::Destroy(IObject *object) {
   Statics *instance = GetInstance();
-  (instance->IdPool).push_back(object->UniqueID());
+  {
+    std::lock_guard<std::mutex> lock(IdMutex);
+    (instance->IdPool).push_back(object->UniqueID());
+  }
   delete object;
 }
 
@@ -33,10 +45,14 @@ void Statics::AddSerializedObject(IObject *object) {
   Statics *instance = GetInstance();
   // add to the global map
   IComponent *component = dynamic_cast<IComponent *>(object);
-  if (component)
+  if (component) {
     instance->Get<IComponentManager>()->AddGenericComponent(component);
-  else
+  } else {
+    Asset *asset = dynamic_cast<Asset *>(object);
+    if (asset)
+      asset->Prepare();
     instance->Get<IAssetManager>()->AddInstance(object);
+  }
   RegisterSerializedObject(object);
 }
 
@@ -0,0 +1,131 @@
+#include "Modules/Utility/CullingUtils.h"
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86_FP)
+#include <xmmintrin.h>
+#define S_CULLING_SSE
+#endif
+
+namespace CullingUtils {
+void BoxSoA::Clear() {
+  CenterX.clear();
+  CenterY.clear();
+  CenterZ.clear();
+  ExtentX.clear();
+  ExtentY.clear();
+  ExtentZ.clear();
+}
+
+void BoxSoA::Add(const BoundingBox &box) {
+  CenterX.push_back(box.Center.x);
+  CenterY.push_back(box.Center.y);
+  CenterZ.push_back(box.Center.z);
+  ExtentX.push_back(box.Extents.x);
+  ExtentY.push_back(box.Extents.y);
+  ExtentZ.push_back(box.Extents.z);
+}
+
+unsigned int BoxSoA::Count() const {
+  return static_cast<unsigned int>(CenterX.size());
+}
+
+Frustum ExtractFrustum(const glm::mat4 &viewProjection) {
+  // Gribb-Hartmann, glm matrices are column major
+  glm::vec4 rows[4];
+  for (int x = 0; x < 4; x++)
+    rows[x] = glm::vec4(viewProjection[0][x], viewProjection[1][x],
+                        viewProjection[2][x], viewProjection[3][x]);
+
+  Frustum frustum;
+  frustum.Planes[0] = rows[3] + rows[0]; // left
+  frustum.Planes[1] = rows[3] - rows[0]; // right
+  frustum.Planes[2] = rows[3] + rows[1]; // bottom
+  frustum.Planes[3] = rows[3] - rows[1]; // top
+  frustum.Planes[4] = rows[3] + rows[2]; // near
+  frustum.Planes[5] = rows[3] - rows[2]; // far
+
+  for (int x = 0; x < 6; x++) {
+    float length = glm::length(glm::vec3(frustum.Planes[x]));
+    if (length > 0.f)
+      frustum.Planes[x] /= length;
+  }
+  return frustum;
+}
+
+static bool IsBoxVisible(const Frustum &frustum, const BoxSoA &boxes,
+                         unsigned int index) {
+  for (int p = 0; p < 6; p++) {
+    const glm::vec4 &plane = frustum.Planes[p];
+    float distance = plane.x * boxes.CenterX[index] +
+                     plane.y * boxes.CenterY[index] +
+                     plane.z * boxes.CenterZ[index] + plane.w;
+    float radius = fabsf(plane.x) * boxes.ExtentX[index] +
+                   fabsf(plane.y) * boxes.ExtentY[index] +
+                   fabsf(plane.z) * boxes.ExtentZ[index];
+    if (distance + radius < 0.f)
+      return false;
+  }
+  return true;
+}
+
+unsigned int CullBoxes(const Frustum &frustum, const BoxSoA &boxes,
+                       std::vector<unsigned char> &visible) {
+  unsigned int count = boxes.Count();
+  visible.resize(count);
+  unsigned int visibleCount = 0;
+  unsigned int x = 0;
+
+#ifdef S_CULLING_SSE
+  __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+  __m128 absPlaneX[6], absPlaneY[6], absPlaneZ[6];
+  for (int p = 0; p < 6; p++) {
+    const glm::vec4 &plane = frustum.Planes[p];
+    planeX[p] = _mm_set1_ps(plane.x);
+    planeY[p] = _mm_set1_ps(plane.y);
+    planeZ[p] = _mm_set1_ps(plane.z);
+    planeW[p] = _mm_set1_ps(plane.w);
+    absPlaneX[p] = _mm_set1_ps(fabsf(plane.x));
+    absPlaneY[p] = _mm_set1_ps(fabsf(plane.y));
+    absPlaneZ[p] = _mm_set1_ps(fabsf(plane.z));
+  }
+  const __m128 zero = _mm_setzero_ps();
+
+  // four boxes against each plane per iteration
+  for (; x + 4 <= count; x += 4) {
+    __m128 centerX = _mm_loadu_ps(&boxes.CenterX[x]);
+    __m128 centerY = _mm_loadu_ps(&boxes.CenterY[x]);
+    __m128 centerZ = _mm_loadu_ps(&boxes.CenterZ[x]);
+    __m128 extentX = _mm_loadu_ps(&boxes.ExtentX[x]);
+    __m128 extentY = _mm_loadu_ps(&boxes.ExtentY[x]);
+    __m128 extentZ = _mm_loadu_ps(&boxes.ExtentZ[x]);
+    __m128 outside = zero;
+
+    for (int p = 0; p < 6; p++) {
+      __m128 distance = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(planeX[p], centerX),
+                     _mm_mul_ps(planeY[p], centerY)),
+          _mm_add_ps(_mm_mul_ps(planeZ[p], centerZ), planeW[p]));
+      __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absPlaneX[p], extentX),
+                                            _mm_mul_ps(absPlaneY[p], extentY)),
+                                 _mm_mul_ps(absPlaneZ[p], extentZ));
+      outside =
+          _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+    }
+
+    int outsideMask = _mm_movemask_ps(outside);
+    for (unsigned int y = 0; y < 4; y++) {
+      unsigned char isVisible = (outsideMask & (1 << y)) ? 0 : 1;
+      visible[x + y] = isVisible;
+      visibleCount += isVisible;
+    }
+  }
+#endif
+
+  // scalar path for the remainder or when SSE isn't available
+  for (; x < count; x++) {
+    visible[x] = IsBoxVisible(frustum, boxes, x) ? 1 : 0;
+    visibleCount += visible[x];
+  }
+  return visibleCount;
+}
+} // namespace CullingUtils
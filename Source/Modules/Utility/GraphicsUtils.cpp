@@ -9,8 +9,7 @@
 #include "Modules/Statics/IGraphics.h"
 
 namespace GraphicsUtils {
-void SetUniformsFromMaterial(ICommandBuffer *buffer, unsigned int materialId,
-                             unsigned int &shaderId) {
+Material *GetMaterial(unsigned int materialId) {
   std::unordered_map<std::string,
                      std::unordered_map<unsigned int, IObject *>>::
       iterator MaterialIterator;
@@ -22,30 +21,38 @@ void SetUniformsFromMaterial(ICommandBuffer *buffer, unsigned int materialId,
     materialId = MaterialIterator->second.begin()->first;
 
   material = dynamic_cast<Material *>(MaterialIterator->second.at(materialId));
+  return material;
+}
 
+void SetUniformsFromMaterial(ICommandBuffer *buffer, unsigned int materialId,
+                             unsigned int &shaderId) {
+  SetUniformsFromMaterial(buffer, GetMaterial(materialId), shaderId);
+}
+
+void SetUniformsFromMaterial(ICommandBuffer *buffer, Material *material,
+                             unsigned int &shaderId) {
   shaderId = material->ShaderId;
 
   // set material uniforms
-  {
-    std::vector<std::string> names;
-    std::vector<float> floatValues;
-    material->GetFloatUniforms(names, floatValues);
-    for (size_t x = 0; x < names.size(); x++)
-      buffer->SetFloat(names[x], shaderId, floatValues[x]);
+  material->BindUniformHandles(buffer);
+  for (size_t x = 0; x < material->FloatUniformHandles.size(); x++)
+    buffer->SetFloat(material->FloatUniformHandles[x], shaderId,
+                     material->FloatUniformValues[x]);
 
-    std::vector<glm::vec4> vectorValues;
-    material->GetVectorUniforms(names, vectorValues);
-    for (size_t x = 0; x < names.size(); x++)
-      buffer->SetVector(names[x], shaderId, vectorValues[x]);
-    // TODO add matrices
+  for (size_t x = 0; x < material->VectorUniformHandles.size(); x++) {
+    const float *vectorValue = &material->VectorUniformValues[x * 4];
+    buffer->SetVector(material->VectorUniformHandles[x], shaderId,
+                      glm::vec4(vectorValue[0], vectorValue[1], vectorValue[2],
+                                vectorValue[3]));
+  }
+  // TODO add matrices
 
-    std::vector<unsigned int> textureIds;
-    material->GetTextureUniforms(names, textureIds);
-    for (size_t x = 0; x < names.size(); x++) {
-      if (textureIds[x] == 0)
-        continue;
-      buffer->SetTexture(names[x], shaderId, textureIds[x]);
-    }
+  for (size_t x = 0; x < material->TextureUniformHandles.size(); x++) {
+    unsigned int textureId = material->TextureUniformValues[x];
+    if (textureId == 0)
+      continue;
+    buffer->SetTexture(material->TextureUniformHandles[x], shaderId,
+                       textureId);
   }
 }
 
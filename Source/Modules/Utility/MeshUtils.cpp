@@ -0,0 +1,486 @@
+#include "Modules/Utility/MeshUtils.h"
+#include "Engine/AssetTypes/Mesh.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace MeshUtils {
+namespace {
+// attributes of a vertex compared bitwise
+struct VertexKey {
+  float Values[9];
+  bool operator==(const VertexKey &other) const {
+    return memcmp(Values, other.Values, sizeof(Values)) == 0;
+  }
+};
+
+struct VertexKeyHash {
+  size_t operator()(const VertexKey &key) const {
+    // fnv-1a over the bytes
+    const unsigned char *bytes =
+        reinterpret_cast<const unsigned char *>(key.Values);
+    size_t hash = 2166136261u;
+    for (size_t x = 0; x < sizeof(key.Values); x++)
+      hash = (hash ^ bytes[x]) * 16777619u;
+    return hash;
+  }
+};
+
+bool HasMatchingStreams(Mesh *mesh) {
+  size_t count = mesh->Positions.size();
+  return mesh->Normals.size() == count && mesh->TexCoord.size() == count;
+}
+
+// moves the vertex attributes to their new index, newIndex of -1 drops it
+void RemapVertices(Mesh *mesh, const std::vector<int> &newIndex,
+                   unsigned int newCount) {
+  std::vector<glm::vec3> positions(newCount), normals(newCount),
+      texCoords(newCount);
+  for (size_t x = 0; x < newIndex.size(); x++) {
+    if (newIndex[x] < 0)
+      continue;
+    positions[newIndex[x]] = mesh->Positions[x];
+    normals[newIndex[x]] = mesh->Normals[x];
+    texCoords[newIndex[x]] = mesh->TexCoord[x];
+  }
+  mesh->Positions.swap(positions);
+  mesh->Normals.swap(normals);
+  mesh->TexCoord.swap(texCoords);
+  for (size_t x = 0; x < mesh->Indices.size(); x++)
+    mesh->Indices[x] = newIndex[mesh->Indices[x]];
+}
+
+// triangles around each vertex as ranges of a flat list
+void BuildAdjacency(const std::vector<unsigned int> &indices,
+                    unsigned int vertexCount,
+                    std::vector<unsigned int> &offsets,
+                    std::vector<unsigned int> &triangles) {
+  offsets.assign(vertexCount + 1, 0);
+  for (size_t x = 0; x < indices.size(); x++)
+    offsets[indices[x] + 1]++;
+  for (unsigned int x = 0; x < vertexCount; x++)
+    offsets[x + 1] += offsets[x];
+  triangles.resize(offsets[vertexCount]);
+  std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+  for (size_t x = 0; x < indices.size(); x++)
+    triangles[fill[indices[x]]++] = static_cast<unsigned int>(x / 3);
+}
+
+// symmetric 4x4 matrix summing the squared distances to planes
+struct Quadric {
+  double A00 = 0, A01 = 0, A02 = 0, A03 = 0, A11 = 0, A12 = 0, A13 = 0,
+         A22 = 0, A23 = 0, A33 = 0;
+
+  void AddPlane(const glm::dvec3 &normal, double distance) {
+    A00 += normal.x * normal.x;
+    A01 += normal.x * normal.y;
+    A02 += normal.x * normal.z;
+    A03 += normal.x * distance;
+    A11 += normal.y * normal.y;
+    A12 += normal.y * normal.z;
+    A13 += normal.y * distance;
+    A22 += normal.z * normal.z;
+    A23 += normal.z * distance;
+    A33 += distance * distance;
+  }
+
+  void Add(const Quadric &other) {
+    A00 += other.A00;
+    A01 += other.A01;
+    A02 += other.A02;
+    A03 += other.A03;
+    A11 += other.A11;
+    A12 += other.A12;
+    A13 += other.A13;
+    A22 += other.A22;
+    A23 += other.A23;
+    A33 += other.A33;
+  }
+
+  double Evaluate(const glm::vec3 &point) const {
+    double x = point.x, y = point.y, z = point.z;
+    return A00 * x * x + 2 * A01 * x * y + 2 * A02 * x * z + 2 * A03 * x +
+           A11 * y * y + 2 * A12 * y * z + 2 * A13 * y + A22 * z * z +
+           2 * A23 * z + A33;
+  }
+};
+
+struct Collapse {
+  unsigned int From;
+  unsigned int To;
+  double Cost;
+};
+
+// edge collapse passes before the simplifier gives up on the target
+#define MAX_SIMPLIFY_PASSES 32
+
+// Tipsify helper, the next vertex to fan around once the candidates are
+// exhausted
+int SkipDeadEnd(const std::vector<unsigned int> &liveTriangles,
+                std::vector<unsigned int> &deadEndStack,
+                unsigned int &cursor, unsigned int vertexCount) {
+  while (!deadEndStack.empty()) {
+    unsigned int vertex = deadEndStack.back();
+    deadEndStack.pop_back();
+    if (liveTriangles[vertex] > 0)
+      return vertex;
+  }
+  while (cursor < vertexCount) {
+    if (liveTriangles[cursor] > 0)
+      return cursor;
+    cursor++;
+  }
+  return -1;
+}
+} // namespace
+
+unsigned int WeldVertices(Mesh *mesh) {
+  unsigned int vertexCount = static_cast<unsigned int>(mesh->Positions.size());
+  if (!HasMatchingStreams(mesh))
+    return vertexCount;
+
+  std::unordered_map<VertexKey, int, VertexKeyHash> uniqueVertices;
+  uniqueVertices.reserve(vertexCount);
+  std::vector<int> newIndex(vertexCount);
+  unsigned int uniqueCount = 0;
+  for (unsigned int x = 0; x < vertexCount; x++) {
+    VertexKey key;
+    memcpy(&key.Values[0], &mesh->Positions[x], sizeof(glm::vec3));
+    memcpy(&key.Values[3], &mesh->Normals[x], sizeof(glm::vec3));
+    memcpy(&key.Values[6], &mesh->TexCoord[x], sizeof(glm::vec3));
+    std::unordered_map<VertexKey, int, VertexKeyHash>::iterator it =
+        uniqueVertices.find(key);
+    if (it != uniqueVertices.end()) {
+      newIndex[x] = it->second;
+      continue;
+    }
+    newIndex[x] = uniqueCount;
+    uniqueVertices[key] = uniqueCount++;
+  }
+  if (uniqueCount != vertexCount)
+    RemapVertices(mesh, newIndex, uniqueCount);
+  return uniqueCount;
+}
+
+void OptimizeVertexCache(std::vector<unsigned int> &indices,
+                         unsigned int vertexCount, unsigned int cacheSize) {
+  unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+  if (triangleCount == 0)
+    return;
+
+  std::vector<unsigned int> adjacencyOffsets, adjacency;
+  BuildAdjacency(indices, vertexCount, adjacencyOffsets, adjacency);
+  std::vector<unsigned int> liveTriangles(vertexCount);
+  for (unsigned int x = 0; x < vertexCount; x++)
+    liveTriangles[x] = adjacencyOffsets[x + 1] - adjacencyOffsets[x];
+
+  std::vector<unsigned int> cacheTime(vertexCount, 0);
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<unsigned int> deadEndStack;
+  std::vector<unsigned int> candidates;
+  std::vector<unsigned int> output;
+  output.reserve(triangleCount * 3);
+
+  int fanVertex = 0;
+  unsigned int time = cacheSize + 1;
+  unsigned int cursor = 1;
+  while (fanVertex >= 0) {
+    candidates.clear();
+    for (unsigned int x = adjacencyOffsets[fanVertex];
+         x < adjacencyOffsets[fanVertex + 1]; x++) {
+      unsigned int triangle = adjacency[x];
+      if (emitted[triangle])
+        continue;
+      for (unsigned int corner = 0; corner < 3; corner++) {
+        unsigned int vertex = indices[triangle * 3 + corner];
+        output.push_back(vertex);
+        deadEndStack.push_back(vertex);
+        candidates.push_back(vertex);
+        liveTriangles[vertex]--;
+        if (time - cacheTime[vertex] > cacheSize)
+          cacheTime[vertex] = time++;
+      }
+      emitted[triangle] = true;
+    }
+
+    // prefer candidates still in the cache with few live triangles left
+    int best = -1;
+    int bestPriority = -1;
+    for (size_t x = 0; x < candidates.size(); x++) {
+      unsigned int vertex = candidates[x];
+      if (liveTriangles[vertex] == 0)
+        continue;
+      int priority = 0;
+      if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+        priority = time - cacheTime[vertex];
+      if (priority > bestPriority) {
+        bestPriority = priority;
+        best = vertex;
+      }
+    }
+    if (best < 0)
+      best = SkipDeadEnd(liveTriangles, deadEndStack, cursor, vertexCount);
+    fanVertex = best;
+  }
+  indices.swap(output);
+}
+
+void OptimizeVertexFetch(Mesh *mesh) {
+  if (!HasMatchingStreams(mesh))
+    return;
+  unsigned int vertexCount = static_cast<unsigned int>(mesh->Positions.size());
+  std::vector<int> newIndex(vertexCount, -1);
+  unsigned int nextIndex = 0;
+  for (size_t x = 0; x < mesh->Indices.size(); x++) {
+    unsigned int vertex = mesh->Indices[x];
+    if (newIndex[vertex] < 0)
+      newIndex[vertex] = nextIndex++;
+  }
+  // vertices no triangle references are dropped
+  RemapVertices(mesh, newIndex, nextIndex);
+}
+
+float CalculateAcmr(const std::vector<unsigned int> &indices,
+                    unsigned int cacheSize) {
+  unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+  if (triangleCount == 0)
+    return 0.f;
+  std::vector<unsigned int> cache;
+  unsigned int misses = 0;
+  for (size_t x = 0; x < triangleCount * 3; x++) {
+    bool hit = false;
+    for (size_t y = 0; y < cache.size(); y++)
+      if (cache[y] == indices[x]) {
+        hit = true;
+        break;
+      }
+    if (hit)
+      continue;
+    misses++;
+    cache.insert(cache.begin(), indices[x]);
+    if (cache.size() > cacheSize)
+      cache.pop_back();
+  }
+  return misses / static_cast<float>(triangleCount);
+}
+
+float CalculateAtvr(const std::vector<unsigned int> &indices,
+                    unsigned int vertexCount, unsigned int cacheSize) {
+  if (vertexCount == 0)
+    return 0.f;
+  unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+  return CalculateAcmr(indices, cacheSize) * triangleCount / vertexCount;
+}
+
+void Optimize(Mesh *mesh, OptimizationReport &report) {
+  report.VerticesBefore = static_cast<unsigned int>(mesh->Positions.size());
+  report.AcmrBefore = CalculateAcmr(mesh->Indices);
+  report.AtvrBefore = CalculateAtvr(mesh->Indices, report.VerticesBefore);
+
+  // lods index the old vertex order
+  mesh->LodIndices.clear();
+  mesh->LodIndexCounts.clear();
+  mesh->LodErrors.clear();
+
+  WeldVertices(mesh);
+  OptimizeVertexCache(mesh->Indices,
+                      static_cast<unsigned int>(mesh->Positions.size()));
+  OptimizeVertexFetch(mesh);
+
+  report.VerticesAfter = static_cast<unsigned int>(mesh->Positions.size());
+  report.AcmrAfter = CalculateAcmr(mesh->Indices);
+  report.AtvrAfter = CalculateAtvr(mesh->Indices, report.VerticesAfter);
+}
+
+float Simplify(const std::vector<glm::vec3> &positions,
+               const std::vector<unsigned int> &indices,
+               unsigned int targetIndexCount,
+               std::vector<unsigned int> &result) {
+  unsigned int vertexCount = static_cast<unsigned int>(positions.size());
+  result = indices;
+
+  // vertices sharing a position are one corner of the surface, the first of
+  // them represents the group
+  std::vector<unsigned int> group(vertexCount);
+  std::vector<unsigned int> groupSize(vertexCount, 0);
+  std::unordered_map<VertexKey, unsigned int, VertexKeyHash> groupIds;
+  groupIds.reserve(vertexCount);
+  for (unsigned int x = 0; x < vertexCount; x++) {
+    VertexKey key = {};
+    memcpy(&key.Values[0], &positions[x], sizeof(glm::vec3));
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash>::iterator it =
+        groupIds.find(key);
+    group[x] = it == groupIds.end() ? (groupIds[key] = x) : it->second;
+    groupSize[group[x]]++;
+  }
+
+  // attribute seams and open borders are locked, moving them would tear
+  // the mesh or change its outline
+  std::vector<bool> locked(vertexCount, false);
+  for (unsigned int x = 0; x < vertexCount; x++)
+    locked[x] = groupSize[group[x]] > 1;
+  std::unordered_map<unsigned long long, unsigned int> edgeUses;
+  for (size_t x = 0; x + 2 < indices.size(); x += 3)
+    for (unsigned int corner = 0; corner < 3; corner++) {
+      unsigned long long a = group[indices[x + corner]];
+      unsigned long long b = group[indices[x + (corner + 1) % 3]];
+      edgeUses[a < b ? (a << 32 | b) : (b << 32 | a)]++;
+    }
+  for (size_t x = 0; x + 2 < indices.size(); x += 3)
+    for (unsigned int corner = 0; corner < 3; corner++) {
+      unsigned int a = indices[x + corner];
+      unsigned int b = indices[x + (corner + 1) % 3];
+      unsigned long long ga = group[a], gb = group[b];
+      if (edgeUses[ga < gb ? (ga << 32 | gb) : (gb << 32 | ga)] == 1)
+        locked[a] = locked[b] = true;
+    }
+
+  std::vector<Quadric> quadrics(vertexCount);
+  for (size_t x = 0; x + 2 < indices.size(); x += 3) {
+    glm::dvec3 p0 = positions[indices[x]];
+    glm::dvec3 p1 = positions[indices[x + 1]];
+    glm::dvec3 p2 = positions[indices[x + 2]];
+    glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+    double length = glm::length(normal);
+    if (length == 0.0)
+      continue;
+    normal /= length;
+    for (unsigned int corner = 0; corner < 3; corner++)
+      quadrics[group[indices[x + corner]]].AddPlane(normal,
+                                                    -glm::dot(normal, p0));
+  }
+
+  double maxCost = 0.0;
+  std::vector<unsigned int> adjacencyOffsets, adjacency;
+  std::vector<Collapse> collapses;
+  std::vector<bool> touched(vertexCount);
+  std::vector<unsigned int> remap(vertexCount);
+  std::vector<unsigned int> next;
+  for (unsigned int pass = 0;
+       pass < MAX_SIMPLIFY_PASSES && result.size() > targetIndexCount;
+       pass++) {
+    BuildAdjacency(result, vertexCount, adjacencyOffsets, adjacency);
+
+    collapses.clear();
+    for (size_t x = 0; x < result.size(); x += 3)
+      for (unsigned int corner = 0; corner < 3; corner++) {
+        unsigned int a = result[x + corner];
+        unsigned int b = result[x + (corner + 1) % 3];
+        for (unsigned int direction = 0; direction < 2; direction++) {
+          unsigned int from = direction ? b : a;
+          unsigned int to = direction ? a : b;
+          if (locked[from])
+            continue;
+          Quadric quadric = quadrics[group[from]];
+          quadric.Add(quadrics[group[to]]);
+          Collapse collapse = {from, to, quadric.Evaluate(positions[to])};
+          collapses.push_back(collapse);
+        }
+      }
+    std::sort(collapses.begin(), collapses.end(),
+              [](const Collapse &a, const Collapse &b) {
+                return a.Cost < b.Cost;
+              });
+
+    // a vertex takes part in one collapse per pass so the flip checks see
+    // the final positions of the neighbourhood
+    for (unsigned int x = 0; x < vertexCount; x++)
+      remap[x] = x;
+    std::fill(touched.begin(), touched.end(), false);
+    unsigned int triangleCount = static_cast<unsigned int>(result.size() / 3);
+    unsigned int removedTriangles = 0;
+    unsigned int collapseCount = 0;
+    for (size_t c = 0; c < collapses.size(); c++) {
+      if ((triangleCount - removedTriangles) * 3 <= targetIndexCount)
+        break;
+      unsigned int from = collapses[c].From;
+      unsigned int to = collapses[c].To;
+      if (touched[from] || touched[to])
+        continue;
+
+      bool flipped = false;
+      unsigned int sharedTriangles = 0;
+      for (unsigned int t = adjacencyOffsets[from];
+           t < adjacencyOffsets[from + 1] && !flipped; t++) {
+        const unsigned int *triangle = &result[adjacency[t] * 3];
+        if (group[triangle[0]] == group[to] ||
+            group[triangle[1]] == group[to] ||
+            group[triangle[2]] == group[to]) {
+          sharedTriangles++;
+          continue;
+        }
+        glm::vec3 corners[3], moved[3];
+        for (unsigned int corner = 0; corner < 3; corner++) {
+          corners[corner] = positions[triangle[corner]];
+          moved[corner] =
+              triangle[corner] == from ? positions[to] : corners[corner];
+        }
+        glm::vec3 before =
+            glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        glm::vec3 after =
+            glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+        flipped = glm::dot(before, after) <= 0.f;
+      }
+      if (flipped)
+        continue;
+
+      remap[from] = to;
+      for (unsigned int t = adjacencyOffsets[from];
+           t < adjacencyOffsets[from + 1]; t++)
+        for (unsigned int corner = 0; corner < 3; corner++)
+          touched[result[adjacency[t] * 3 + corner]] = true;
+      touched[to] = true;
+      quadrics[group[to]].Add(quadrics[group[from]]);
+      maxCost = std::max(maxCost, collapses[c].Cost);
+      removedTriangles += sharedTriangles;
+      collapseCount++;
+    }
+    if (collapseCount == 0)
+      break;
+
+    // triangles reduced to a line disappear
+    next.clear();
+    for (size_t x = 0; x < result.size(); x += 3) {
+      unsigned int a = remap[result[x]];
+      unsigned int b = remap[result[x + 1]];
+      unsigned int c = remap[result[x + 2]];
+      if (group[a] == group[b] || group[b] == group[c] || group[a] == group[c])
+        continue;
+      next.push_back(a);
+      next.push_back(b);
+      next.push_back(c);
+    }
+    result.swap(next);
+  }
+  return static_cast<float>(sqrt(std::max(maxCost, 0.0)));
+}
+
+void GenerateLods(Mesh *mesh) {
+  mesh->LodIndices.clear();
+  mesh->LodIndexCounts.clear();
+  mesh->LodErrors.clear();
+  unsigned int triangleCount =
+      static_cast<unsigned int>(mesh->Indices.size() / 3);
+  if (triangleCount < MIN_LOD_TRIANGLES)
+    return;
+
+  unsigned int vertexCount = static_cast<unsigned int>(mesh->Positions.size());
+  size_t previousCount = mesh->Indices.size();
+  std::vector<unsigned int> lod;
+  for (unsigned int level = 1; level < MAX_MESH_LODS; level++) {
+    // every level is simplified from the full mesh so the error is measured
+    // against the original surface
+    unsigned int target = (triangleCount >> level) * 3;
+    float error = Simplify(mesh->Positions, mesh->Indices, target, lod);
+    // stop once locked vertices keep the simplifier from making progress
+    if (lod.empty() || lod.size() * 5 > previousCount * 4)
+      break;
+    OptimizeVertexCache(lod, vertexCount);
+    mesh->LodIndices.insert(mesh->LodIndices.end(), lod.begin(), lod.end());
+    mesh->LodIndexCounts.push_back(static_cast<unsigned int>(lod.size()));
+    mesh->LodErrors.push_back(error);
+    previousCount = lod.size();
+  }
+}
+} // namespace MeshUtils
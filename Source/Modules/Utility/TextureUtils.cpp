@@ -0,0 +1,490 @@
+#include "Modules/Utility/TextureUtils.h"
+#include "Core.h"
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+
+namespace TextureUtils {
+namespace {
+// interpolation weights of 4 bit BC7 indices, out of 64
+const int Bc7Weights[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                            34, 38, 43, 47, 51, 55, 60, 64};
+
+// blocks are little endian bit streams
+struct BitWriter {
+  unsigned char *Data;
+  unsigned int Position;
+  void Write(unsigned int value, unsigned int bits) {
+    for (unsigned int x = 0; x < bits; x++, Position++)
+      if (value >> x & 1)
+        Data[Position >> 3] |= 1 << (Position & 7);
+  }
+};
+
+struct BitReader {
+  const unsigned char *Data;
+  unsigned int Position;
+  unsigned int Read(unsigned int bits) {
+    unsigned int value = 0;
+    for (unsigned int x = 0; x < bits; x++, Position++)
+      value |= (Data[Position >> 3] >> (Position & 7) & 1) << x;
+    return value;
+  }
+};
+
+// corners of the bounding box along the dominant direction of the texels
+void FindEndpoints(const unsigned char *texels, unsigned int channels,
+                   int *low, int *high) {
+  float mean[4] = {0, 0, 0, 0};
+  for (unsigned int c = 0; c < channels; c++) {
+    low[c] = 255;
+    high[c] = 0;
+  }
+  for (unsigned int x = 0; x < 16; x++)
+    for (unsigned int c = 0; c < channels; c++) {
+      int value = texels[x * 4 + c];
+      mean[c] += value / 16.f;
+      low[c] = std::min(low[c], value);
+      high[c] = std::max(high[c], value);
+    }
+
+  // channels falling while the widest one rises take the other diagonal
+  unsigned int reference = 0;
+  for (unsigned int c = 1; c < channels; c++)
+    if (high[c] - low[c] > high[reference] - low[reference])
+      reference = c;
+  for (unsigned int c = 0; c < channels; c++) {
+    if (c == reference)
+      continue;
+    float covariance = 0.f;
+    for (unsigned int x = 0; x < 16; x++)
+      covariance += (texels[x * 4 + reference] - mean[reference]) *
+                    (texels[x * 4 + c] - mean[c]);
+    if (covariance < 0.f)
+      std::swap(low[c], high[c]);
+  }
+
+  // the extremes are usually outliers, pulling the endpoints in a little
+  // lowers the average error
+  for (unsigned int c = 0; c < channels; c++) {
+    int inset = (high[c] - low[c]) / 16;
+    low[c] += inset;
+    high[c] -= inset;
+  }
+}
+
+unsigned short To565(const int *color) {
+  return static_cast<unsigned short>(((color[0] * 31 + 127) / 255) << 11 |
+                                     ((color[1] * 63 + 127) / 255) << 5 |
+                                     ((color[2] * 31 + 127) / 255));
+}
+
+void From565(unsigned short value, int *color) {
+  int r = value >> 11 & 31, g = value >> 5 & 63, b = value & 31;
+  color[0] = r << 3 | r >> 2;
+  color[1] = g << 2 | g >> 4;
+  color[2] = b << 3 | b >> 2;
+}
+
+// BC1 colour block in the four colour mode
+void EncodeColorBlock(const unsigned char *texels, unsigned char *block) {
+  int low[4], high[4];
+  FindEndpoints(texels, 3, low, high);
+  unsigned short color0 = To565(high);
+  unsigned short color1 = To565(low);
+  if (color0 < color1)
+    std::swap(color0, color1);
+
+  unsigned int indices = 0;
+  if (color0 != color1) {
+    int palette[4][3];
+    From565(color0, palette[0]);
+    From565(color1, palette[1]);
+    for (unsigned int c = 0; c < 3; c++) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+    for (unsigned int x = 0; x < 16; x++) {
+      unsigned int best = 0;
+      int bestError = 0x7fffffff;
+      for (unsigned int p = 0; p < 4; p++) {
+        int error = 0;
+        for (unsigned int c = 0; c < 3; c++) {
+          int delta = texels[x * 4 + c] - palette[p][c];
+          error += delta * delta;
+        }
+        if (error < bestError) {
+          bestError = error;
+          best = p;
+        }
+      }
+      indices |= best << (x * 2);
+    }
+  }
+  block[0] = color0 & 0xff;
+  block[1] = color0 >> 8;
+  block[2] = color1 & 0xff;
+  block[3] = color1 >> 8;
+  for (unsigned int x = 0; x < 4; x++)
+    block[4 + x] = indices >> (x * 8) & 0xff;
+}
+
+void DecodeColorBlock(const unsigned char *block, unsigned char *texels) {
+  unsigned short color0 = block[0] | block[1] << 8;
+  unsigned short color1 = block[2] | block[3] << 8;
+  int palette[4][4];
+  From565(color0, palette[0]);
+  From565(color1, palette[1]);
+  palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+  for (unsigned int c = 0; c < 3; c++)
+    if (color0 > color1) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    } else {
+      palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+      palette[3][c] = 0;
+    }
+  unsigned int indices =
+      block[4] | block[5] << 8 | block[6] << 16 | (unsigned int)block[7] << 24;
+  for (unsigned int x = 0; x < 16; x++)
+    for (unsigned int c = 0; c < 3; c++)
+      texels[x * 4 + c] = palette[indices >> (x * 2) & 3][c];
+}
+
+// BC4 block of a single channel in the eight value mode
+void EncodeChannel(const unsigned char *texels, unsigned int channel,
+                   unsigned char *block) {
+  int low = 255, high = 0;
+  for (unsigned int x = 0; x < 16; x++) {
+    low = std::min(low, (int)texels[x * 4 + channel]);
+    high = std::max(high, (int)texels[x * 4 + channel]);
+  }
+  block[0] = high;
+  block[1] = low;
+  unsigned long long indices = 0;
+  if (high > low) {
+    int palette[8] = {high, low};
+    for (unsigned int p = 2; p < 8; p++)
+      palette[p] = ((8 - p) * high + (p - 1) * low) / 7;
+    for (unsigned int x = 0; x < 16; x++) {
+      unsigned long long best = 0;
+      int bestError = 256;
+      for (unsigned int p = 0; p < 8; p++) {
+        int error = std::abs(texels[x * 4 + channel] - palette[p]);
+        if (error < bestError) {
+          bestError = error;
+          best = p;
+        }
+      }
+      indices |= best << (x * 3);
+    }
+  }
+  for (unsigned int x = 0; x < 6; x++)
+    block[2 + x] = indices >> (x * 8) & 0xff;
+}
+
+void DecodeChannel(const unsigned char *block, unsigned int channel,
+                   unsigned char *texels) {
+  int palette[8] = {block[0], block[1]};
+  if (palette[0] > palette[1]) {
+    for (unsigned int p = 2; p < 8; p++)
+      palette[p] = ((8 - p) * palette[0] + (p - 1) * palette[1]) / 7;
+  } else {
+    for (unsigned int p = 2; p < 6; p++)
+      palette[p] = ((6 - p) * palette[0] + (p - 1) * palette[1]) / 5;
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+  unsigned long long indices = 0;
+  for (unsigned int x = 0; x < 6; x++)
+    indices |= (unsigned long long)block[2 + x] << (x * 8);
+  for (unsigned int x = 0; x < 16; x++)
+    texels[x * 4 + channel] = palette[indices >> (x * 3) & 7];
+}
+
+// 7 bit endpoint plus the shared lowest bit, whichever fits better
+void QuantizeEndpoint(const int *value, int *quantized, int &pBit) {
+  int bestError = 0x7fffffff;
+  for (int p = 0; p < 2; p++) {
+    int candidate[4];
+    int error = 0;
+    for (unsigned int c = 0; c < 4; c++) {
+      candidate[c] = std::min(std::max((value[c] - p + 1) / 2, 0), 127);
+      int delta = (candidate[c] << 1 | p) - value[c];
+      error += delta * delta;
+    }
+    if (error < bestError) {
+      bestError = error;
+      pBit = p;
+      memcpy(quantized, candidate, sizeof(candidate));
+    }
+  }
+}
+
+void DecodeBC7(const unsigned char *block, unsigned char *texels) {
+  BitReader reader = {block, 0};
+  unsigned int mode = 0;
+  while (mode < 8 && reader.Read(1) == 0)
+    mode++;
+  if (mode != 6) {
+    for (unsigned int x = 0; x < 16; x++) {
+      texels[x * 4 + 0] = texels[x * 4 + 1] = texels[x * 4 + 2] = 0;
+      texels[x * 4 + 3] = 255;
+    }
+    return;
+  }
+  int endpoints[2][4];
+  for (unsigned int c = 0; c < 4; c++) {
+    endpoints[0][c] = reader.Read(7) << 1;
+    endpoints[1][c] = reader.Read(7) << 1;
+  }
+  int p0 = reader.Read(1), p1 = reader.Read(1);
+  for (unsigned int c = 0; c < 4; c++) {
+    endpoints[0][c] |= p0;
+    endpoints[1][c] |= p1;
+  }
+  for (unsigned int x = 0; x < 16; x++) {
+    int weight = Bc7Weights[reader.Read(x == 0 ? 3 : 4)];
+    for (unsigned int c = 0; c < 4; c++)
+      texels[x * 4 + c] = ((64 - weight) * endpoints[0][c] +
+                           weight * endpoints[1][c] + 32) >>
+                          6;
+  }
+}
+
+// 4x4 texels at the block position, edges repeat the last row or column
+void FetchBlock(const std::vector<glm::vec4> &level, unsigned int width,
+                unsigned int height, unsigned int blockX, unsigned int blockY,
+                unsigned char *texels) {
+  for (unsigned int y = 0; y < 4; y++)
+    for (unsigned int x = 0; x < 4; x++) {
+      unsigned int sourceX = std::min(blockX * 4 + x, width - 1);
+      unsigned int sourceY = std::min(blockY * 4 + y, height - 1);
+      glm::vec4 value =
+          glm::clamp(level[sourceY * width + sourceX], 0.f, 1.f);
+      for (unsigned int c = 0; c < 4; c++)
+        texels[(y * 4 + x) * 4 + c] =
+            static_cast<unsigned char>(value[c] * 255.f + .5f);
+    }
+}
+
+void AppendLevel(Texture2D::TextureFormat format,
+                 const std::vector<glm::vec4> &level, unsigned int width,
+                 unsigned int height, std::vector<unsigned char> &data) {
+  size_t offset = data.size();
+  data.resize(offset + GetLevelSize(format, width, height));
+  unsigned char *output = &data[offset];
+  if (format == Texture2D::Half_RGBA) {
+    for (size_t x = 0; x < level.size(); x++, output += 8) {
+      glm::uint64 packed = glm::packHalf4x16(level[x]);
+      memcpy(output, &packed, 8);
+    }
+    return;
+  }
+
+  unsigned int blockSize = format == Texture2D::BC1_RGB ? 8 : 16;
+  unsigned char texels[64];
+  for (unsigned int blockY = 0; blockY < (height + 3) / 4; blockY++)
+    for (unsigned int blockX = 0; blockX < (width + 3) / 4; blockX++) {
+      FetchBlock(level, width, height, blockX, blockY, texels);
+      if (format == Texture2D::BC1_RGB)
+        EncodeBC1(texels, output);
+      else if (format == Texture2D::BC3_RGBA)
+        EncodeBC3(texels, output);
+      else if (format == Texture2D::BC5_RG)
+        EncodeBC5(texels, output);
+      else
+        EncodeBC7(texels, output);
+      output += blockSize;
+    }
+}
+} // namespace
+
+unsigned int GetMipCount(unsigned int width, unsigned int height) {
+  unsigned int count = 1;
+  for (unsigned int size = std::max(width, height); size > 1; size >>= 1)
+    count++;
+  return count;
+}
+
+unsigned int GetLevelSize(Texture2D::TextureFormat format, unsigned int width,
+                          unsigned int height) {
+  unsigned int blocks = ((width + 3) / 4) * ((height + 3) / 4);
+  switch (format) {
+  case Texture2D::Float_RGBA:
+    return width * height * 16;
+  case Texture2D::Byte_RGBA:
+    return width * height * 4;
+  case Texture2D::Half_RGBA:
+    return width * height * 8;
+  case Texture2D::BC1_RGB:
+    return blocks * 8;
+  default:
+    return blocks * 16;
+  }
+}
+
+bool IsBlockFormat(Texture2D::TextureFormat format) {
+  return format == Texture2D::BC1_RGB || format == Texture2D::BC3_RGBA ||
+         format == Texture2D::BC5_RG || format == Texture2D::BC7_RGBA;
+}
+
+void Import(Texture2D *texture, Texture2D::TextureFormat targetFormat) {
+  int width, height;
+  texture->GetResolution(width, height);
+  Texture2D::TextureFormat sourceFormat = texture->GetTextureFormat();
+  if (width <= 0 || height <= 0 || targetFormat == sourceFormat)
+    return;
+  bool floatPixels = sourceFormat == Texture2D::Float_RGBA;
+  const float *pixels = texture->GetPixels();
+  const unsigned char *pixels32 = texture->GetPixels32();
+  if (floatPixels ? !pixels : !pixels32)
+    return;
+
+  // levels are filtered in floats whatever the source format is
+  std::vector<glm::vec4> level(width * height);
+  bool opaque = true;
+  for (size_t x = 0; x < level.size(); x++)
+    for (unsigned int c = 0; c < 4; c++)
+      level[x][c] =
+          floatPixels ? pixels[x * 4 + c] : pixels32[x * 4 + c] / 255.f;
+  for (size_t x = 0; x < level.size() && opaque; x++)
+    opaque = level[x].a >= 1.f;
+
+  if (targetFormat == Texture2D::Auto)
+    targetFormat = floatPixels ? Texture2D::Half_RGBA
+                               : opaque ? Texture2D::BC1_RGB
+                                        : Texture2D::BC3_RGBA;
+  if (targetFormat == Texture2D::Float_RGBA ||
+      targetFormat == Texture2D::Byte_RGBA)
+    return;
+
+  unsigned int mipCount = GetMipCount(width, height);
+  std::vector<unsigned char> data;
+  std::vector<glm::vec4> next;
+  unsigned int levelWidth = width, levelHeight = height;
+  for (unsigned int mip = 0; mip < mipCount; mip++) {
+    AppendLevel(targetFormat, level, levelWidth, levelHeight, data);
+    if (mip + 1 == mipCount)
+      break;
+    // 2x2 box filter, odd sizes repeat the last row or column
+    unsigned int nextWidth = std::max(levelWidth / 2, 1u);
+    unsigned int nextHeight = std::max(levelHeight / 2, 1u);
+    next.resize(nextWidth * nextHeight);
+    for (unsigned int y = 0; y < nextHeight; y++)
+      for (unsigned int x = 0; x < nextWidth; x++) {
+        unsigned int x0 = std::min(x * 2, levelWidth - 1);
+        unsigned int x1 = std::min(x * 2 + 1, levelWidth - 1);
+        unsigned int y0 = std::min(y * 2, levelHeight - 1);
+        unsigned int y1 = std::min(y * 2 + 1, levelHeight - 1);
+        next[y * nextWidth + x] =
+            (level[y0 * levelWidth + x0] + level[y0 * levelWidth + x1] +
+             level[y1 * levelWidth + x0] + level[y1 * levelWidth + x1]) *
+            .25f;
+      }
+    level.swap(next);
+    levelWidth = nextWidth;
+    levelHeight = nextHeight;
+  }
+
+  unsigned int sourceBytes = GetLevelSize(sourceFormat, width, height);
+  S_LOG_FUNC("Texture #%d: %ux%u, %u levels, %u -> %lu bytes",
+             texture->UniqueID(), width, height, mipCount, sourceBytes,
+             (unsigned long)data.size());
+  texture->SetMipData(targetFormat, mipCount, data);
+}
+
+void EncodeBC1(const unsigned char *texels, unsigned char *block) {
+  EncodeColorBlock(texels, block);
+}
+
+void EncodeBC3(const unsigned char *texels, unsigned char *block) {
+  EncodeChannel(texels, 3, block);
+  EncodeColorBlock(texels, block + 8);
+}
+
+void EncodeBC5(const unsigned char *texels, unsigned char *block) {
+  EncodeChannel(texels, 0, block);
+  EncodeChannel(texels, 1, block + 8);
+}
+
+void EncodeBC7(const unsigned char *texels, unsigned char *block) {
+  int low[4], high[4];
+  FindEndpoints(texels, 4, low, high);
+  int quantized[2][4], pBits[2];
+  QuantizeEndpoint(low, quantized[0], pBits[0]);
+  QuantizeEndpoint(high, quantized[1], pBits[1]);
+
+  unsigned int indices[16];
+  for (unsigned int x = 0; x < 16; x++) {
+    int bestError = 0x7fffffff;
+    for (unsigned int i = 0; i < 16; i++) {
+      int error = 0;
+      for (unsigned int c = 0; c < 4; c++) {
+        int endpoint0 = quantized[0][c] << 1 | pBits[0];
+        int endpoint1 = quantized[1][c] << 1 | pBits[1];
+        int value = ((64 - Bc7Weights[i]) * endpoint0 +
+                     Bc7Weights[i] * endpoint1 + 32) >>
+                    6;
+        int delta = value - texels[x * 4 + c];
+        error += delta * delta;
+      }
+      if (error < bestError) {
+        bestError = error;
+        indices[x] = i;
+      }
+    }
+  }
+  // the first index drops its top bit, swapping the endpoints clears it
+  if (indices[0] >= 8) {
+    for (unsigned int c = 0; c < 4; c++)
+      std::swap(quantized[0][c], quantized[1][c]);
+    std::swap(pBits[0], pBits[1]);
+    for (unsigned int x = 0; x < 16; x++)
+      indices[x] = 15 - indices[x];
+  }
+
+  memset(block, 0, 16);
+  BitWriter writer = {block, 0};
+  writer.Write(1 << 6, 7);
+  for (unsigned int c = 0; c < 4; c++) {
+    writer.Write(quantized[0][c], 7);
+    writer.Write(quantized[1][c], 7);
+  }
+  writer.Write(pBits[0], 1);
+  writer.Write(pBits[1], 1);
+  for (unsigned int x = 0; x < 16; x++)
+    writer.Write(indices[x], x == 0 ? 3 : 4);
+}
+
+void DecodeLevel(Texture2D::TextureFormat format, const unsigned char *data,
+                 unsigned int width, unsigned int height,
+                 std::vector<unsigned char> &pixels) {
+  pixels.resize(width * height * 4);
+  unsigned int blockSize = format == Texture2D::BC1_RGB ? 8 : 16;
+  unsigned char texels[64];
+  for (unsigned int blockY = 0; blockY < (height + 3) / 4; blockY++)
+    for (unsigned int blockX = 0; blockX < (width + 3) / 4;
+         blockX++, data += blockSize) {
+      for (unsigned int x = 0; x < 16; x++) {
+        texels[x * 4 + 0] = texels[x * 4 + 1] = texels[x * 4 + 2] = 0;
+        texels[x * 4 + 3] = 255;
+      }
+      if (format == Texture2D::BC1_RGB) {
+        DecodeColorBlock(data, texels);
+      } else if (format == Texture2D::BC3_RGBA) {
+        DecodeChannel(data, 3, texels);
+        DecodeColorBlock(data + 8, texels);
+      } else if (format == Texture2D::BC5_RG) {
+        DecodeChannel(data, 0, texels);
+        DecodeChannel(data + 8, 1, texels);
+      } else {
+        DecodeBC7(data, texels);
+      }
+      for (unsigned int y = 0; y < 4 && blockY * 4 + y < height; y++)
+        for (unsigned int x = 0; x < 4 && blockX * 4 + x < width; x++)
+          memcpy(&pixels[((blockY * 4 + y) * width + blockX * 4 + x) * 4],
+                 &texels[(y * 4 + x) * 4], 4);
+    }
+}
+} // namespace TextureUtils
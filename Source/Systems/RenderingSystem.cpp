@@ -5,7 +5,11 @@
 #include "Modules/Statics/IAssetManager.h"
 #include "Modules/Statics/IComponentManager.h"
 #include "Modules/Statics/IEntityManager.h"
+#include "Modules/Statics/IJobSystem.h"
+#include "Modules/Statics/ISpatialIndex.h"
 
+#include "Engine/AssetTypes/Material.h"
+#include "Engine/AssetTypes/Mesh.h"
 #include "Engine/AssetTypes/Settings/RenderSettings.h"
 
 #include "Modules/Graphics/ICommandBuffer.h"
@@ -18,12 +22,33 @@
 #include "Engine/Components/SkyLightComponent.h"
 #include "Engine/Components/TransformComponent.h"
 #include "Utility/Typedefs.h"
+#include <algorithm>
 
 REGISTER_SERIALIZED_CLASS(RenderingSystem)
 
 typedef std::unordered_map<unsigned int, IComponent *> IComponentMapType;
 
 bool RenderingSystem::Initialize() {
+  ICommandBuffer *buffer = Statics::Get<IGraphics>()->GetCommandBuffer(
+      IGraphics::CommandBufferType::Main);
+  DirectionalLightColorHandle =
+      buffer->GetUniformHandle("DirectionalLight.Color");
+  DirectionalLightDirectionHandle =
+      buffer->GetUniformHandle("DirectionalLight.Direction");
+
+  LightDataHandle = buffer->GetUniformHandle("_LightData");
+  ClusterRangesHandle = buffer->GetUniformHandle("_ClusterRanges");
+  LightIndicesHandle = buffer->GetUniformHandle("_LightIndices");
+  ClusterParamsHandle = buffer->GetUniformHandle("_ClusterParams");
+  ClusterScreenHandle = buffer->GetUniformHandle("_ClusterScreen");
+  ObjectLightsHandle = buffer->GetUniformHandle("_ObjectLights");
+  ObjectLightCountHandle = buffer->GetUniformHandle("_ObjectLightCount");
+
+  IGraphics *graphics = Statics::Get<IGraphics>();
+  LightDataBufferId = graphics->CreateBufferId();
+  ClusterRangesBufferId = graphics->CreateBufferId();
+  LightIndicesBufferId = graphics->CreateBufferId();
+
   Active = true;
   return Active;
 }
@@ -47,9 +72,18 @@ bool RenderingSystem::Update() {
       Statics::Get<IGraphics>()->GetContext()->GetFrameAspectRatio(),
       camera->GetNearPlane(), camera->GetFarPlane()));
 
+  RenderSettings *renderSettings =
+      Statics::Get<IAssetManager>()->GetAssetOfType<RenderSettings>();
+  LightAssignment = renderSettings->LightAssignment;
+  LodPixelError = renderSettings->LodPixelError;
+
   // TODO Draw Skybox
   FindLights();
 
+  UpdateLightParameters();
+  if (LightAssignment == LIGHT_ASSIGNMENT_CLUSTERED)
+    UpdateLightClusters();
+
   DrawSkyBox();
   DrawOpaqueMeshes();
 
@@ -65,10 +99,7 @@ void RenderingSystem::DrawSkyBox() {
 }
 
 void RenderingSystem::FindLights() {
-  for (unsigned char x = 0; x < MAX_LIGHTS; x++)
-    LightComponents[x] = nullptr;
-
-  LightsFound = 0;
+  LightComponents.clear();
   CachedDirectionalLight = nullptr;
 
   IComponentManager *componentManager = Statics::Get<IComponentManager>();
@@ -78,20 +109,18 @@ void RenderingSystem::FindLights() {
 
   for (unsigned int x = 0; x < lightComponentMap->Count(); x++) {
     LightComponent *light = lightComponentMap->AtIndex(x);
-    if (light->LightType != DIRECTIONAL_LIGHT_TYPE && LightsFound != MAX_LIGHTS)
-      LightComponents[LightsFound++] = light;
+    if (light->LightType != DIRECTIONAL_LIGHT_TYPE)
+      LightComponents.push_back(light);
     else if (light->LightType == DIRECTIONAL_LIGHT_TYPE &&
              !CachedDirectionalLight)
       CachedDirectionalLight = light;
   }
 }
 
-void RenderingSystem::SetLightParameters(unsigned int shaderId) {
-  // set camera position
-
+void RenderingSystem::UpdateLightParameters() {
   // set for directional light
-  glm::vec4 directionalColor = glm::vec4(1, 1, 1, 0);
-  glm::vec4 directionalDirection = glm::vec4(0, -1, 0, 0);
+  DirectionalLightColor = glm::vec4(1, 1, 1, 0);
+  DirectionalLightDirection = glm::vec4(0, -1, 0, 0);
 
   IComponentManager *componentManager = Statics::Get<IComponentManager>();
 
@@ -99,32 +128,20 @@ void RenderingSystem::SetLightParameters(unsigned int shaderId) {
     TransformComponent *xform =
         componentManager->GetComponentOfType<TransformComponent>(
             CachedDirectionalLight->EntityId());
-    directionalColor.x = CachedDirectionalLight->Color[0];
-    directionalColor.y = CachedDirectionalLight->Color[1];
-    directionalColor.z = CachedDirectionalLight->Color[2];
-    directionalColor.w = CachedDirectionalLight->Intensity;
+    DirectionalLightColor.x = CachedDirectionalLight->Color[0];
+    DirectionalLightColor.y = CachedDirectionalLight->Color[1];
+    DirectionalLightColor.z = CachedDirectionalLight->Color[2];
+    DirectionalLightColor.w = CachedDirectionalLight->Intensity;
 
     glm::quat q = xform->GetRotation();
     glm::vec3 dir = glm::vec3(0, 0, 1) * q;
-    directionalDirection =
+    DirectionalLightDirection =
         glm::vec4(dir.x, dir.y, dir.x, CachedDirectionalLight->ShadowEnabled);
   }
 
-  ActiveCommandBuffer->SetVector("DirectionalLight.Color", shaderId,
-                                 directionalColor);
-  ActiveCommandBuffer->SetVector("DirectionalLight.Direction", shaderId,
-                                 directionalDirection);
-  //
-  for (unsigned char x = 0; x < MAX_LIGHTS; x++) {
-    char lightId[64];
-    glm::vec4 lightColor = glm::vec4(0, 0, 0, 0);
-    sprintf(lightId, "Lights[%i]", x);
-    if (x >= LightsFound) {
-      std::string col = std::string(lightId) + ".Color";
-      ActiveCommandBuffer->SetVector(col, shaderId, lightColor);
-      continue;
-    }
-
+  LightValues.resize(LightComponents.size());
+  LightSpheres.resize(LightComponents.size());
+  for (unsigned int x = 0; x < LightComponents.size(); x++) {
     LightComponent *light = LightComponents[x];
     TransformComponent *xform =
         componentManager->GetComponentOfType<TransformComponent>(
@@ -136,29 +153,142 @@ void RenderingSystem::SetLightParameters(unsigned int shaderId) {
     if (light->LightType == SPOT_LIGHT_TYPE)
       dir = glm::vec3(0, 0, 1) * xform->GetRotation();
 
-    glm::vec4 pos4 = glm::vec4(pos.x, pos.y, pos.z, 1.0);
-    glm::vec4 dir4 = glm::vec4(dir.x, dir.y, dir.z, 1.0);
+    LightUniformValues &values = LightValues[x];
+    values.Position = glm::vec4(pos.x, pos.y, pos.z, 1.0);
+    values.Direction = glm::vec4(dir.x, dir.y, dir.z, 1.0);
+    values.Color = glm::vec4(light->Color[0], light->Color[1], light->Color[2],
+                             light->Intensity);
+    values.Params0 = glm::vec4(light->LightType, light->InnerAngle,
+                               light->OuterAngle, light->ShadowEnabled);
+    values.Params1 = glm::vec4(light->Constant, light->Linear,
+                               light->Quadratic, light->CutOff);
+    LightSpheres[x] = glm::vec4(pos, light->GetAttenuationRadius());
+  }
 
-    lightColor = glm::vec4(light->Color[0], light->Color[1], light->Color[2],
-                           light->Intensity);
+  // both assignment modes read the light data from the same buffer
+  ActiveCommandBuffer->UpdateTextureBuffer(
+      LightDataBufferId, ICommandBuffer::ETextureBufferFormat::Float4,
+      LightValues.data(),
+      static_cast<unsigned int>(LightValues.size() *
+                                sizeof(LightUniformValues)));
+}
 
-    glm::vec4 params0(light->LightType, light->InnerAngle, light->OuterAngle,
-                      light->ShadowEnabled);
+void RenderingSystem::UpdateLightClusters() {
+  CameraComponent *camera = SceneUtils::GetActiveCamera();
+  IRenderContext *context = Statics::Get<IGraphics>()->GetContext();
+  ClusterGrid.SetProjection(camera->GetFOV(), context->GetFrameAspectRatio(),
+                            camera->GetNearPlane(), camera->GetFarPlane());
+
+  glm::mat4 viewMatrix = camera->GetViewMatrix();
+  ClusterLights.resize(LightComponents.size());
+  for (unsigned int x = 0; x < LightComponents.size(); x++) {
+    glm::vec4 viewPosition =
+        viewMatrix * glm::vec4(glm::vec3(LightSpheres[x]), 1.f);
+    ClusterLights[x].ViewPosition = glm::vec3(viewPosition);
+    ClusterLights[x].Radius = LightSpheres[x].w;
+  }
+  ClusterGrid.Build(ClusterLights);
+
+  int width, height;
+  context->GetWindowFramebufferSize(width, height);
+  ClusterParams = glm::vec4(ClusterGrid.GetTilesX(), ClusterGrid.GetTilesY(),
+                            ClusterGrid.GetSliceScale(),
+                            ClusterGrid.GetSliceBias());
+  ClusterScreen = glm::vec4(width, height, ClusterGrid.GetSlices(), 0);
+
+  // uploaded ahead of the draws, the recording threads only bind them
+  const std::vector<unsigned int> &ranges = ClusterGrid.GetClusterRanges();
+  const std::vector<unsigned int> &indices = ClusterGrid.GetLightIndices();
+  ActiveCommandBuffer->UpdateTextureBuffer(
+      ClusterRangesBufferId, ICommandBuffer::ETextureBufferFormat::UInt2,
+      ranges.data(),
+      static_cast<unsigned int>(ranges.size() * sizeof(unsigned int)));
+  ActiveCommandBuffer->UpdateTextureBuffer(
+      LightIndicesBufferId, ICommandBuffer::ETextureBufferFormat::UInt,
+      indices.data(),
+      static_cast<unsigned int>(indices.size() * sizeof(unsigned int)));
+}
 
-    glm::vec4 params1(light->Constant, light->Linear, light->Quadratic,
-                      light->CutOff);
+void RenderingSystem::AssignObjectLights(unsigned int begin,
+                                         unsigned int end) {
+  for (unsigned int x = begin; x < end; x++) {
+    RendererComponent *renderer = VisibleRenderers[x];
+    glm::vec3 boundsMin = VisibleTransforms[x]->GetPosition();
+    glm::vec3 boundsMax = boundsMin;
+    if (renderer->HasWorldBounds) {
+      boundsMin = renderer->WorldBounds.GetMin();
+      boundsMax = renderer->WorldBounds.GetMax();
+    }
+
+    // keeps the most important lights sorted by descending importance
+    float importance[MAX_OBJECT_LIGHTS];
+    int indices[MAX_OBJECT_LIGHTS];
+    unsigned int count = 0;
+    for (unsigned int y = 0; y < VisibleLightIndices.size(); y++) {
+      unsigned int lightIndex = VisibleLightIndices[y];
+      const glm::vec4 &sphere = LightSpheres[lightIndex];
+      glm::vec3 position(sphere);
+      glm::vec3 closest = glm::clamp(position, boundsMin, boundsMax);
+      float distance = glm::length(closest - position);
+      if (distance > sphere.w)
+        continue;
+
+      const LightUniformValues &values = LightValues[lightIndex];
+      const glm::vec4 &attenuation = values.Params1;
+      float brightest = glm::max(glm::max(values.Color.x, values.Color.y),
+                                 values.Color.z) *
+                        values.Color.w;
+      float lightImportance =
+          brightest / glm::max(attenuation.x + attenuation.y * distance +
+                                   attenuation.z * distance * distance,
+                               1e-4f);
+
+      unsigned int slot = count;
+      while (slot > 0 && importance[slot - 1] < lightImportance) {
+        if (slot < MAX_OBJECT_LIGHTS) {
+          importance[slot] = importance[slot - 1];
+          indices[slot] = indices[slot - 1];
+        }
+        slot--;
+      }
+      if (slot >= MAX_OBJECT_LIGHTS)
+        continue;
+      importance[slot] = lightImportance;
+      indices[slot] = static_cast<int>(lightIndex);
+      if (count < MAX_OBJECT_LIGHTS)
+        count++;
+    }
 
-    ActiveCommandBuffer->SetVector(std::string(lightId) + ".Position", shaderId,
-                                   pos4);
-    ActiveCommandBuffer->SetVector(std::string(lightId) + ".Direction",
-                                   shaderId, dir4);
-    ActiveCommandBuffer->SetVector(std::string(lightId) + ".Color", shaderId,
-                                   lightColor);
-    ActiveCommandBuffer->SetVector(std::string(lightId) + ".Params0", shaderId,
-                                   params0);
-    ActiveCommandBuffer->SetVector(std::string(lightId) + ".Params1", shaderId,
-                                   params1);
+    ObjectLightList &list = ObjectLights[x];
+    list.Indices = glm::vec4(-1);
+    for (unsigned int y = 0; y < count; y++)
+      list.Indices[y] = static_cast<float>(indices[y]);
+    list.Count = static_cast<float>(count);
+  }
+}
+
+void RenderingSystem::SetLightParameters(ICommandBuffer *buffer,
+                                         unsigned int shaderId,
+                                         unsigned int rendererIndex) {
+  buffer->SetVector(DirectionalLightColorHandle, shaderId,
+                    DirectionalLightColor);
+  buffer->SetVector(DirectionalLightDirectionHandle, shaderId,
+                    DirectionalLightDirection);
+  // every sampler gets its buffer so no two samplers share a texture unit
+  buffer->SetTextureBuffer(LightDataHandle, shaderId, LightDataBufferId);
+  buffer->SetTextureBuffer(ClusterRangesHandle, shaderId,
+                           ClusterRangesBufferId);
+  buffer->SetTextureBuffer(LightIndicesHandle, shaderId, LightIndicesBufferId);
+  if (LightAssignment == LIGHT_ASSIGNMENT_PER_OBJECT) {
+    const ObjectLightList &list = ObjectLights[rendererIndex];
+    buffer->SetVector(ObjectLightsHandle, shaderId, list.Indices);
+    buffer->SetFloat(ObjectLightCountHandle, shaderId, list.Count);
+    return;
   }
+  // a negative count makes the shader read the cluster of the fragment
+  buffer->SetFloat(ObjectLightCountHandle, shaderId, -1.f);
+  buffer->SetVector(ClusterParamsHandle, shaderId, ClusterParams);
+  buffer->SetVector(ClusterScreenHandle, shaderId, ClusterScreen);
 }
 
 void RenderingSystem::DrawOpaqueMeshes() {
@@ -176,25 +306,223 @@ void RenderingSystem::DrawOpaqueMeshes() {
   if (!drawMeshes)
     return;
 
-  for (unsigned int x = 0; x < rendererComponents->Count(); x++) {
-    RendererComponent *renderer = rendererComponents->AtIndex(x);
-    unsigned int entityId = renderer->EntityId();
-    TransformComponent *transform = transformComponents->At(entityId);
+  CullRenderers(transformComponents, rendererComponents);
+
+  // a sphere of radius r at distance d is r / d * LodPixelScale pixels
+  // across
+  CameraComponent *camera = SceneUtils::GetActiveCamera();
+  int width, height;
+  Statics::Get<IGraphics>()->GetContext()->GetWindowFramebufferSize(width,
+                                                                     height);
+  LodPixelScale = height / glm::tan(camera->GetFOV() * .5f);
+  LodCameraPosition = glm::vec3(glm::inverse(camera->GetViewMatrix())[3]);
+
+  // anything touching the asset manager or the material state happens here,
+  // the recording threads only read what was gathered
+  VisibleMaterials.clear();
+  for (unsigned int x = 0; x < VisibleRenderers.size(); x++) {
+    Material *material =
+        GraphicsUtils::GetMaterial(VisibleRenderers[x]->MaterialReference);
+    material->BindUniformHandles(ActiveCommandBuffer);
+    VisibleMaterials.push_back(material);
+    SelectLod(VisibleRenderers[x]);
+  }
+
+  IGraphics *graphics = Statics::Get<IGraphics>();
+  IJobSystem *jobSystem = Statics::Get<IJobSystem>();
+  unsigned int rendererCount =
+      static_cast<unsigned int>(VisibleRenderers.size());
+  // per object lights are set per draw, those can't be batched
+  if (LightAssignment == LIGHT_ASSIGNMENT_CLUSTERED)
+    rendererCount = PartitionStaticRenderers();
+
+  if (LightAssignment == LIGHT_ASSIGNMENT_PER_OBJECT) {
+    ObjectLights.resize(rendererCount);
+    jobSystem->ParallelFor(rendererCount, MIN_RENDERERS_PER_JOB,
+                           [this](unsigned int begin, unsigned int end,
+                                  unsigned int) {
+                             AssignObjectLights(begin, end);
+                           });
+  }
+  unsigned int rangeCount =
+      jobSystem->GetRangeCount(rendererCount, MIN_RENDERERS_PER_JOB);
 
-    if (!transform || !renderer)
+  std::vector<ICommandBuffer *> buffers(rangeCount);
+  for (unsigned int x = 0; x < rangeCount; x++) {
+    buffers[x] = graphics->GetSecondaryCommandBuffer(x);
+    buffers[x]->ResetCommandBuffer();
+  }
+
+  jobSystem->ParallelFor(
+      rendererCount, MIN_RENDERERS_PER_JOB,
+      [this, &buffers](unsigned int begin, unsigned int end,
+                       unsigned int rangeIndex) {
+        DrawRenderers(buffers[rangeIndex], begin, end);
+      });
+
+  // merge in range order so the output doesn't depend on thread timing
+  for (unsigned int x = 0; x < rangeCount; x++)
+    ActiveCommandBuffer->Append(buffers[x]);
+
+  DrawStaticBatches(rendererCount);
+}
+
+unsigned int RenderingSystem::PartitionStaticRenderers() {
+  // dynamic renderers keep their order, static ones follow them
+  unsigned int dynamicCount = 0;
+  PartitionedRenderers.clear();
+  PartitionedTransforms.clear();
+  PartitionedMaterials.clear();
+  for (unsigned char pass = 0; pass < 2; pass++)
+    for (unsigned int x = 0; x < VisibleRenderers.size(); x++) {
+      if ((VisibleRenderers[x]->Static != 0) != (pass == 1))
+        continue;
+      PartitionedRenderers.push_back(VisibleRenderers[x]);
+      PartitionedTransforms.push_back(VisibleTransforms[x]);
+      PartitionedMaterials.push_back(VisibleMaterials[x]);
+      if (pass == 0)
+        dynamicCount++;
+    }
+  VisibleRenderers.swap(PartitionedRenderers);
+  VisibleTransforms.swap(PartitionedTransforms);
+  VisibleMaterials.swap(PartitionedMaterials);
+  return dynamicCount;
+}
+
+void RenderingSystem::DrawStaticBatches(unsigned int begin) {
+  // batches share the material, draws of the same mesh end up adjacent
+  StaticRendererIndices.clear();
+  for (unsigned int x = begin; x < VisibleRenderers.size(); x++)
+    StaticRendererIndices.push_back(x);
+  std::sort(StaticRendererIndices.begin(), StaticRendererIndices.end(),
+            [this](unsigned int a, unsigned int b) {
+              if (VisibleMaterials[a] != VisibleMaterials[b])
+                return VisibleMaterials[a] < VisibleMaterials[b];
+              RendererComponent *rendererA = VisibleRenderers[a];
+              RendererComponent *rendererB = VisibleRenderers[b];
+              if (rendererA->MeshReference != rendererB->MeshReference)
+                return rendererA->MeshReference < rendererB->MeshReference;
+              return rendererA->Lod < rendererB->Lod;
+            });
+
+  unsigned int x = 0;
+  while (x < StaticRendererIndices.size()) {
+    Material *material = VisibleMaterials[StaticRendererIndices[x]];
+    BatchMatrices.clear();
+    BatchMatricesInv.clear();
+    BatchMeshIds.clear();
+    BatchLods.clear();
+    for (; x < StaticRendererIndices.size(); x++) {
+      unsigned int index = StaticRendererIndices[x];
+      if (VisibleMaterials[index] != material)
+        break;
+      BatchMatrices.push_back(VisibleTransforms[index]->WorldTransform);
+      BatchMatricesInv.push_back(VisibleTransforms[index]->WorldTransformInv);
+      BatchMeshIds.push_back(VisibleRenderers[index]->MeshReference);
+      BatchLods.push_back(VisibleRenderers[index]->Lod);
+    }
+
+    unsigned int shaderId;
+    GraphicsUtils::SetUniformsFromMaterial(ActiveCommandBuffer, material,
+                                           shaderId);
+    SetLightParameters(ActiveCommandBuffer, shaderId, 0);
+    ActiveCommandBuffer->DrawMeshBatch(
+        BatchMatrices.data(), BatchMatricesInv.data(), BatchMeshIds.data(),
+        BatchLods.data(), static_cast<unsigned int>(BatchMeshIds.size()),
+        shaderId);
+  }
+}
+
+void RenderingSystem::SelectLod(RendererComponent *renderer) {
+  Mesh *mesh = Statics::Get<IAssetManager>()->GetAssetOfType<Mesh>(
+      renderer->MeshReference);
+  if (!mesh || mesh->GetLodCount() == 1 || !renderer->HasWorldBounds ||
+      mesh->BoundsSphere.w <= 0.f) {
+    renderer->Lod = 0;
+    return;
+  }
+
+  const BoundingSphere &sphere = renderer->WorldBoundsSphere;
+  float distance = glm::length(glm::vec3(sphere) - LodCameraPosition);
+  if (distance <= sphere.w) {
+    renderer->Lod = 0;
+    return;
+  }
+  // pixels covered by the radius, a level is allowed while its error
+  // relative to the mesh radius stays below the pixel error
+  float radiusPixels = sphere.w / distance * LodPixelScale * .5f;
+  float errorScale = radiusPixels / mesh->BoundsSphere.w;
+
+  unsigned int lodCount = mesh->GetLodCount();
+  unsigned int lod = std::min(renderer->Lod, lodCount - 1);
+  while (lod > 0 && mesh->LodErrors[lod - 1] * errorScale > LodPixelError)
+    lod--;
+  while (lod + 1 < lodCount &&
+         mesh->LodErrors[lod] * errorScale <
+             LodPixelError * (1.f - LOD_HYSTERESIS))
+    lod++;
+  renderer->Lod = lod;
+}
+
+void RenderingSystem::CullRenderers(
+    ComponentMap<TransformComponent> *transformComponents,
+    ComponentMap<RendererComponent> *rendererComponents) {
+  CameraComponent *camera = SceneUtils::GetActiveCamera();
+  CullingUtils::Frustum frustum = CullingUtils::ExtractFrustum(
+      camera->GetProjectionMatrix() * camera->GetViewMatrix());
+
+  // renderers are registered in the index by the transform system
+  ISpatialIndex *spatialIndex = Statics::Get<ISpatialIndex>();
+  VisibleEntityIds.clear();
+  spatialIndex->QueryFrustum(frustum, SPATIAL_PROXY_RENDERER,
+                             VisibleEntityIds);
+
+  if (LightAssignment == LIGHT_ASSIGNMENT_PER_OBJECT) {
+    // light proxies cover the attenuation radius, only lights touching the
+    // frustum can reach a visible renderer
+    VisibleLightIds.clear();
+    spatialIndex->QueryFrustum(frustum, SPATIAL_PROXY_LIGHT, VisibleLightIds);
+    std::sort(VisibleLightIds.begin(), VisibleLightIds.end());
+    VisibleLightIndices.clear();
+    for (unsigned int x = 0; x < LightComponents.size(); x++)
+      if (std::binary_search(VisibleLightIds.begin(), VisibleLightIds.end(),
+                             LightComponents[x]->EntityId()))
+        VisibleLightIndices.push_back(x);
+  }
+
+  VisibleRenderers.clear();
+  VisibleTransforms.clear();
+  for (unsigned int x = 0; x < VisibleEntityIds.size(); x++) {
+    unsigned int entityId = VisibleEntityIds[x];
+    RendererComponent *renderer = rendererComponents->At(entityId);
+    TransformComponent *transform = transformComponents->At(entityId);
+    if (!renderer || !transform)
       continue;
+    VisibleRenderers.push_back(renderer);
+    VisibleTransforms.push_back(transform);
+  }
+
+  unsigned int visibleCount =
+      static_cast<unsigned int>(VisibleRenderers.size());
+  IGraphics::FrameStats &stats = Statics::Get<IGraphics>()->GetFrameStats();
+  stats.VisibleRenderers = visibleCount;
+  stats.CulledRenderers =
+      spatialIndex->GetProxyCount(SPATIAL_PROXY_RENDERER) - visibleCount;
+}
 
-    // TODO cache material if it repeats
-    // discard object if it's not in the view frustrum
+void RenderingSystem::DrawRenderers(ICommandBuffer *buffer, unsigned int begin,
+                                    unsigned int end) {
+  for (unsigned int x = begin; x < end; x++) {
+    RendererComponent *renderer = VisibleRenderers[x];
+    TransformComponent *transform = VisibleTransforms[x];
 
     unsigned int shaderId;
-    GraphicsUtils::SetUniformsFromMaterial(
-        ActiveCommandBuffer, renderer->MaterialReference, shaderId);
+    GraphicsUtils::SetUniformsFromMaterial(buffer, VisibleMaterials[x],
+                                           shaderId);
     // TODO track which shader had lighting uniforms already set
-    SetLightParameters(shaderId);
-    ActiveCommandBuffer->DrawMesh(transform->WorldTransform,
-                                  transform->WorldTransformInv,
-                                  renderer->MeshReference, shaderId);
+    SetLightParameters(buffer, shaderId, x);
+    buffer->DrawMesh(transform->WorldTransform, transform->WorldTransformInv,
+                     renderer->MeshReference, shaderId, renderer->Lod);
   }
 }
 
@@ -0,0 +1,20 @@
+#include "Systems/SceneStreamingSystem.h"
+#include "Engine/Components/CameraComponent.h"
+#include "Modules/Statics/ISceneManager.h"
+#include "Modules/Utility/SceneUtils.h"
+
+REGISTER_SERIALIZED_CLASS(SceneStreamingSystem)
+
+bool SceneStreamingSystem::Initialize() {
+  Active = true;
+  return Active;
+}
+
+bool SceneStreamingSystem::Update() {
+  CameraComponent *camera = SceneUtils::GetActiveCamera();
+  if (!camera)
+    return true;
+  glm::vec3 position = glm::vec3(glm::inverse(camera->GetViewMatrix())[3]);
+  Statics::Get<ISceneManager>()->UpdateStreaming(position);
+  return true;
+}
@@ -1,7 +1,12 @@
 #include "Systems/TransformSystem.h"
+#include "Engine/AssetTypes/Mesh.h"
+#include "Engine/Components/LightComponent.h"
+#include "Engine/Components/RendererComponent.h"
 #include "Engine/Components/TransformComponent.h"
+#include "Modules/Statics/IAssetManager.h"
 #include "Modules/Statics/IComponentManager.h"
 #include "Modules/Statics/IEventSystem.h"
+#include "Modules/Statics/ISpatialIndex.h"
 
 #include <algorithm>
 #include <glm/gtx/matrix_decompose.hpp>
@@ -17,13 +22,33 @@ bool TransformSystem::Initialize() {
   Delegate delegate;
   delegate.SetFunction<TransformSystem, &TransformSystem::OnSceneReload>(this);
   Statics::Get<IEventSystem>()->AddDelegate(EventType::OnSceneLoad, delegate);
+  // scenes unloaded on their own leave proxies of destroyed entities behind
+  Statics::Get<IEventSystem>()->AddDelegate(EventType::OnSceneUnload,
+                                            delegate);
 
   CalculateTransforms(false);
   Active = true;
   return Active;
 }
 
-void TransformSystem::OnSceneReload() { CalculateTransforms(false); }
+void TransformSystem::OnSceneReload() {
+  ResetSpatialIndex();
+  CalculateTransforms(false);
+}
+
+void TransformSystem::ResetSpatialIndex() {
+  // proxies of the previous scene are gone, persistent entities get new ones
+  Statics::Get<ISpatialIndex>()->Clear();
+  IComponentManager *componentManager = Statics::Get<IComponentManager>();
+  ComponentMap<RendererComponent> *renderers =
+      componentManager->GetComponentMap<RendererComponent>();
+  for (unsigned int x = 0; renderers && x < renderers->Count(); x++)
+    renderers->AtIndex(x)->SpatialProxyId = SPATIAL_PROXY_NONE;
+  ComponentMap<LightComponent> *lights =
+      componentManager->GetComponentMap<LightComponent>();
+  for (unsigned int x = 0; lights && x < lights->Count(); x++)
+    lights->AtIndex(x)->SpatialProxyId = SPATIAL_PROXY_NONE;
+}
 
 void TransformSystem::CalculateTransforms(bool ignoreStatic) {
   // recalculate matrices based on local PSR values
@@ -58,6 +83,11 @@ void TransformSystem::CalculateLocalTransforms(bool ignoreStatic) {
 }
 
 void TransformSystem::CalculateWorldTransforms(bool ignoreStatic) {
+  IComponentManager *componentManager = Statics::Get<IComponentManager>();
+  ComponentMap<RendererComponent> *rendererComponents =
+      componentManager->GetComponentMap<RendererComponent>();
+  ComponentMap<LightComponent> *lightComponents =
+      componentManager->GetComponentMap<LightComponent>();
   for (unsigned int x = 0; x < TransformComponentMap->Count(); x++) {
     TransformComponent *transform = TransformComponentMap->AtIndex(x);
 
@@ -99,9 +129,64 @@ void TransformSystem::CalculateWorldTransforms(bool ignoreStatic) {
                    perspective);
 
     transform->WorldRotation = glm::conjugate(transform->WorldRotation);
+
+    if (rendererComponents)
+      UpdateRendererBounds(transform,
+                           rendererComponents->At(transform->EntityId()));
+    if (lightComponents)
+      UpdateLightBounds(transform, lightComponents->At(transform->EntityId()));
   }
 }
 
+void TransformSystem::UpdateRendererBounds(TransformComponent *transform,
+                                           RendererComponent *renderer) {
+  if (!renderer)
+    return;
+  Mesh *mesh = Statics::Get<IAssetManager>()->GetAssetOfType<Mesh>(
+      renderer->MeshReference);
+  ISpatialIndex *spatialIndex = Statics::Get<ISpatialIndex>();
+  // the proxy is replaced when the mesh arrives or goes away
+  bool hadWorldBounds = renderer->HasWorldBounds;
+  renderer->HasWorldBounds = mesh != nullptr;
+  if (renderer->SpatialProxyId != SPATIAL_PROXY_NONE &&
+      hadWorldBounds != renderer->HasWorldBounds) {
+    spatialIndex->DestroyProxy(renderer->SpatialProxyId);
+    renderer->SpatialProxyId = SPATIAL_PROXY_NONE;
+  }
+  // renderers without a mesh never get culled
+  if (!mesh) {
+    if (renderer->SpatialProxyId == SPATIAL_PROXY_NONE)
+      renderer->SpatialProxyId = spatialIndex->CreateUnboundedProxy(
+          renderer->EntityId(), SPATIAL_PROXY_RENDERER);
+    return;
+  }
+  renderer->WorldBounds = mesh->Bounds.Transform(transform->WorldTransform);
+  renderer->WorldBoundsSphere = BoundsUtils::TransformSphere(
+      mesh->BoundsSphere, transform->WorldTransform);
+
+  if (renderer->SpatialProxyId == SPATIAL_PROXY_NONE)
+    renderer->SpatialProxyId = spatialIndex->CreateProxy(
+        renderer->WorldBounds, renderer->EntityId(), SPATIAL_PROXY_RENDERER);
+  else
+    spatialIndex->MoveProxy(renderer->SpatialProxyId, renderer->WorldBounds);
+}
+
+void TransformSystem::UpdateLightBounds(TransformComponent *transform,
+                                        LightComponent *light) {
+  if (!light || light->LightType == DIRECTIONAL_LIGHT_TYPE)
+    return;
+  BoundingBox bounds;
+  bounds.Center = transform->WorldPosition;
+  bounds.Extents = glm::vec3(light->GetAttenuationRadius());
+
+  ISpatialIndex *spatialIndex = Statics::Get<ISpatialIndex>();
+  if (light->SpatialProxyId == SPATIAL_PROXY_NONE)
+    light->SpatialProxyId = spatialIndex->CreateProxy(
+        bounds, light->EntityId(), SPATIAL_PROXY_LIGHT);
+  else
+    spatialIndex->MoveProxy(light->SpatialProxyId, bounds);
+}
+
 bool TransformSystem::Update() {
   CalculateTransforms();
   return true;
@@ -0,0 +1,59 @@
+#include "Utility/Bounds.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+BoundingBox BoundingBox::FromMinMax(const glm::vec3 &min,
+                                    const glm::vec3 &max) {
+  BoundingBox box;
+  box.Center = (min + max) * .5f;
+  box.Extents = (max - min) * .5f;
+  return box;
+}
+
+BoundingBox BoundingBox::Transform(const glm::mat4 &matrix) const {
+  BoundingBox box;
+  box.Center = glm::vec3(matrix * glm::vec4(Center, 1.f));
+  // extents along each world axis are the absolute rotated extents
+  for (int row = 0; row < 3; row++)
+    box.Extents[row] = fabsf(matrix[0][row]) * Extents.x +
+                       fabsf(matrix[1][row]) * Extents.y +
+                       fabsf(matrix[2][row]) * Extents.z;
+  return box;
+}
+
+namespace BoundsUtils {
+void Calculate(const std::vector<glm::vec3> &points, BoundingBox &box,
+               BoundingSphere &sphere) {
+  if (points.size() == 0) {
+    box = BoundingBox();
+    sphere = BoundingSphere(0);
+    return;
+  }
+
+  glm::vec3 min = points[0];
+  glm::vec3 max = points[0];
+  for (size_t x = 1; x < points.size(); x++) {
+    min = glm::min(min, points[x]);
+    max = glm::max(max, points[x]);
+  }
+  box = BoundingBox::FromMinMax(min, max);
+
+  // sphere around the box center, tighter than the box diagonal
+  float radiusSquared = 0.f;
+  for (size_t x = 0; x < points.size(); x++) {
+    glm::vec3 offset = points[x] - box.Center;
+    radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+  }
+  sphere = BoundingSphere(box.Center, sqrtf(radiusSquared));
+}
+
+BoundingSphere TransformSphere(const BoundingSphere &sphere,
+                               const glm::mat4 &matrix) {
+  glm::vec3 center = glm::vec3(matrix * glm::vec4(glm::vec3(sphere), 1.f));
+  float scale = std::max(glm::length(glm::vec3(matrix[0])),
+                         std::max(glm::length(glm::vec3(matrix[1])),
+                                  glm::length(glm::vec3(matrix[2]))));
+  return BoundingSphere(center, sphere.w * scale);
+}
+} // namespace BoundsUtils
@@ -1,20 +1,49 @@
 #include "Utility/Data/DataNode.h"
 #include "Utility/Data/DataStruct.h"
-#include "Utility/Data/SSD.h"
 #include "Utility/Data/SerializedFactory.h"
 #include "Utility/Data/TypedAttribute.h"
+#include <string.h>
 
-DataNode::DataNode(SSD::Node *node) {
-  NodeName = String(node->Name);
-  UniqueID = node->UniqueID;
-  for (unsigned int x = 0; x < node->NodeCount; x++)
-    Nodes.push_back(new DataNode(node->Nodes[x]));
+template <class T, DataStruct::DataType Type>
+static void DecodeValues(const unsigned char *bytes, size_t count, T *out) {
+  DataStruct::UnpackArray(Type, bytes, count, out);
+}
+
+// v2 payloads are already in host order
+template <class T>
+static void CopyValues(const unsigned char *bytes, size_t count, T *out) {
+  memcpy(out, bytes, count * sizeof(T));
+}
 
-  for (unsigned int x = 0; x < node->AttributeCount; x++) {
-    SSD::Attribute *attribute = node->Attributes[x];
-    String typeName = String(attribute->DataType);
-    Attributes.push_back(MakeTypedAttribute(attribute));
+template <class T, DataStruct::DataType Type>
+static ISerialized *MakeValues(const String &name, const String &typeName,
+                               bool isSingleElement,
+                               const unsigned char *values, size_t count,
+                               const std::shared_ptr<void> &owner,
+                               bool bigEndian) {
+  typename TypedAttribute<T>::Decoder decoder =
+      bigEndian ? DecodeValues<T, Type> : CopyValues<T>;
+  if (isSingleElement && count > 0) {
+    T value;
+    decoder(values, 1, &value);
+    return new TypedAttributeValue<T>(name, typeName, value);
   }
+  if (owner)
+    return new TypedAttribute<T>(name, typeName, values, count, decoder,
+                                 owner);
+  std::vector<T> data(count);
+  if (count)
+    decoder(values, count, &data[0]);
+  return new TypedAttribute<T>(name, typeName, data);
+}
+
+DataNode::DataNode(const String &name, unsigned int uniqueID,
+                   std::vector<ISerialized *> &attributes,
+                   std::vector<IDataNode *> &nodes) {
+  NodeName = name;
+  UniqueID = uniqueID;
+  Attributes = attributes;
+  Nodes = nodes;
 }
 
 unsigned int DataNode::GetUniqueID() { return UniqueID; }
@@ -22,8 +51,17 @@ unsigned int DataNode::GetUniqueID() { return UniqueID; }
 void DataNode::SetUniqueID(const unsigned int &newID) { UniqueID = newID; }
 
 DataNode::~DataNode() {
-  for (unsigned int x = 0; x < Attributes.size(); x++)
+  for (unsigned int x = 0; x < Attributes.size(); x++) {
+    // class arrays own their nodes, which may hold on to a mapped file
+    TypedAttribute<IDataNode *> *attributeNodes =
+        dynamic_cast<TypedAttribute<IDataNode *> *>(Attributes[x]);
+    if (attributeNodes) {
+      std::vector<IDataNode *> nodes = attributeNodes->Get();
+      for (size_t y = 0; y < nodes.size(); y++)
+        delete nodes[y];
+    }
     delete Attributes[x];
+  }
 
   for (unsigned int x = 0; x < Nodes.size(); x++)
     delete Nodes[x];
@@ -64,136 +102,62 @@ ISerialized *DataNode::Deserialize() {
   return serializedClass;
 }
 
-ISerialized *DataNode::MakeTypedAttribute(SSD::Attribute *attribute) {
-  // unpack data here
-  String name = String(attribute->Name);
-  String typeName = String(attribute->DataType);
-
-  if (typeName == "char") {
-    if (attribute->IsSingleElement) {
-      // single string
-      char *temp = new char[attribute->ByteCount];
-      for (size_t x = 0; x < attribute->ByteCount; x++)
-        temp[x] = attribute->Values[x];
-      String tempStr = String(temp);
-      delete[] temp;
-      return new TypedAttributeValue<String>(name, typeName, tempStr);
-    } else {
-      // an array of strings
-      std::vector<String> strings;
-      size_t x = 0, stringChar = 0;
-      char *temp = new char[attribute->ByteCount];
-      while (x != attribute->ByteCount) {
-        temp[stringChar++] = attribute->Values[x++];
-        if (temp[stringChar - 1] == '\0') {
-          strings.push_back(temp);
-          stringChar = 0;
-        }
-      }
-      delete[] temp;
-      return new TypedAttribute<String>(name, typeName, strings);
-    }
-  }
-
-  if (typeName == "SerializedClass") {
-    std::vector<IDataNode *> nodes;
-    for (size_t x = 0; x < attribute->ElementCount; x++) {
-      nodes.push_back(new DataNode(attribute->Nodes[x]));
-    }
-    return new TypedAttribute<IDataNode *>(name, typeName, nodes);
-  }
-
-  unsigned char stride;
-  DataStruct::GetStride(typeName, stride);
-
-  std::vector<int> data_int;
-  std::vector<unsigned int> data_uint;
-  std::vector<unsigned short> data_ushort;
-  std::vector<short> data_short;
-  std::vector<float> data_float;
-  std::vector<unsigned char> data_uchar;
-
-  for (unsigned int x = 0; x < attribute->ElementCount * stride; x += stride) {
-    unsigned char *value = new unsigned char[stride];
-    for (unsigned char y = 0; y < stride; y++)
-      value[y] = attribute->Values[x + y];
-
-    if (typeName == "int") {
-      if (attribute->IsSingleElement) {
-        ISerialized *singleElementAttribute = new TypedAttributeValue<int>(
-            name, typeName, DataStruct::GetInt32(value));
-        delete[] value;
-        return singleElementAttribute;
-      }
-      data_int.push_back(DataStruct::GetInt32(value));
-    }
+String DataNode::Name() { return NodeName; }
+std::vector<ISerialized *> DataNode::GetAttributes() { return Attributes; }
+std::vector<IDataNode *> DataNode::GetNodes() { return Nodes; }
 
-    if (typeName == "unsigned int" || typeName == "uid") {
-      if (attribute->IsSingleElement) {
-        ISerialized *singleElementAttribute =
-            new TypedAttributeValue<unsigned int>(name, typeName,
-                                                  DataStruct::GetUInt32(value));
-        delete[] value;
-        return singleElementAttribute;
-      }
-      data_uint.push_back(DataStruct::GetUInt32(value));
-    }
-    if (typeName == "unsigned short") {
-      if (attribute->IsSingleElement) {
-        ISerialized *singleElementAttribute =
-            new TypedAttributeValue<unsigned short>(
-                name, typeName, DataStruct::GetUShort(value));
-        delete[] value;
-        return singleElementAttribute;
-      }
-      data_ushort.push_back(DataStruct::GetUShort(value));
-    }
-    if (typeName == "short") {
-      if (attribute->IsSingleElement) {
-        ISerialized *singleElementAttribute = new TypedAttributeValue<short>(
-            name, typeName, DataStruct::GetShort(value));
-        delete[] value;
-        return singleElementAttribute;
-      }
-      data_short.push_back(DataStruct::GetShort(value));
+ISerialized *DataNode::MakeValueAttribute(
+    const String &name, const String &typeName, bool isSingleElement,
+    const unsigned char *values, unsigned int byteCount,
+    unsigned int elementCount, const std::shared_ptr<void> &owner,
+    bool bigEndian) {
+  DataStruct::DataType type = DataStruct::GetDataType(typeName);
+  const char *chars = (const char *)values;
+  if (type == DataStruct::Char) {
+    // strings are short, they are copied out of the file
+    if (isSingleElement) {
+      String value = std::string(chars, strnlen(chars, byteCount));
+      return new TypedAttributeValue<String>(name, typeName, value);
     }
-    if (typeName == "float") {
-      if (attribute->IsSingleElement) {
-        ISerialized *singleElementAttribute = new TypedAttributeValue<float>(
-            name, typeName, DataStruct::GetFloat(value));
-        delete[] value;
-        return singleElementAttribute;
-      }
-      data_float.push_back(DataStruct::GetFloat(value));
+    std::vector<String> strings;
+    size_t x = 0;
+    while (x < byteCount) {
+      size_t length = strnlen(chars + x, byteCount - x);
+      strings.push_back(String(std::string(chars + x, length)));
+      x += length + 1;
     }
-    if (typeName == "unsigned char") {
-      if (attribute->IsSingleElement) {
-        ISerialized *singleElementAttribute =
-            new TypedAttributeValue<unsigned char>(name, typeName, value[0]);
-        delete[] value;
-        return singleElementAttribute;
-      }
-
-      data_uchar.push_back(value[0]);
-    }
-    delete[] value;
+    return new TypedAttribute<String>(name, typeName, strings);
   }
 
-  if (typeName == "int")
-    return new TypedAttribute<int>(name, typeName, data_int);
-  if (typeName == "unsigned int" || typeName == "uid")
-    return new TypedAttribute<unsigned int>(name, typeName, data_uint);
-  if (typeName == "unsigned short")
-    return new TypedAttribute<unsigned short>(name, typeName, data_ushort);
-  if (typeName == "short")
-    return new TypedAttribute<short>(name, typeName, data_short);
-  if (typeName == "float")
-    return new TypedAttribute<float>(name, typeName, data_float);
-  if (typeName == "unsigned char")
-    return new TypedAttribute<unsigned char>(name, typeName, data_uchar);
-  return nullptr;
+  if ((size_t)elementCount * DataStruct::GetStride(type) > byteCount)
+    return nullptr;
+
+  switch (type) {
+  case DataStruct::Float:
+    return MakeValues<float, DataStruct::Float>(
+        name, typeName, isSingleElement, values, elementCount, owner,
+        bigEndian);
+  case DataStruct::UInt:
+    return MakeValues<unsigned int, DataStruct::UInt>(
+        name, typeName, isSingleElement, values, elementCount, owner,
+        bigEndian);
+  case DataStruct::Int:
+    return MakeValues<int, DataStruct::Int>(
+        name, typeName, isSingleElement, values, elementCount, owner,
+        bigEndian);
+  case DataStruct::UShort:
+    return MakeValues<unsigned short, DataStruct::UShort>(
+        name, typeName, isSingleElement, values, elementCount, owner,
+        bigEndian);
+  case DataStruct::Short:
+    return MakeValues<short, DataStruct::Short>(
+        name, typeName, isSingleElement, values, elementCount, owner,
+        bigEndian);
+  case DataStruct::UChar:
+    return MakeValues<unsigned char, DataStruct::UChar>(
+        name, typeName, isSingleElement, values, elementCount, owner,
+        bigEndian);
+  default:
+    return nullptr;
+  }
 }
-
-String DataNode::Name() { return NodeName; }
-std::vector<ISerialized *> DataNode::GetAttributes() { return Attributes; }
-std::vector<IDataNode *> DataNode::GetNodes() { return Nodes; }
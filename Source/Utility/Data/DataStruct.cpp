@@ -2,6 +2,12 @@
 #include "Utility/Common.h"
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define S_DATA_SSE2
+#endif
+
 namespace DataStruct {
 void GetStride(const String &typeName, unsigned char &stride) {
   stride = 1;
@@ -19,6 +25,89 @@ void GetStride(const String &typeName, unsigned char &stride) {
   if (typeName == "uid")
     stride = 4;
 }
+DataType GetDataType(const String &typeName) {
+  if (typeName == "float")
+    return Float;
+  if (typeName == "unsigned int" || typeName == "uid")
+    return UInt;
+  if (typeName == "int")
+    return Int;
+  if (typeName == "unsigned short")
+    return UShort;
+  if (typeName == "short")
+    return Short;
+  if (typeName == "unsigned char")
+    return UChar;
+  if (typeName == "char")
+    return Char;
+  return Unknown;
+}
+
+unsigned char GetStride(DataType type) {
+  switch (type) {
+  case Short:
+  case UShort:
+    return 2;
+  case Int:
+  case UInt:
+  case Float:
+    return 4;
+  default:
+    return 1;
+  }
+}
+
+static void SwapBytes16(const unsigned char *bytes, size_t count,
+                        unsigned short *out) {
+  size_t x = 0;
+#ifdef S_DATA_SSE2
+  // eight values per iteration
+  for (; x + 8 <= count; x += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(bytes + x * 2));
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    _mm_storeu_si128((__m128i *)(out + x), v);
+  }
+#endif
+  for (; x < count; x++)
+    out[x] = (unsigned short)((bytes[x * 2] << 8) | bytes[x * 2 + 1]);
+}
+
+static void SwapBytes32(const unsigned char *bytes, size_t count,
+                        unsigned int *out) {
+  size_t x = 0;
+#ifdef S_DATA_SSE2
+  // four values per iteration, swap bytes in each half then the halves
+  for (; x + 4 <= count; x += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(bytes + x * 4));
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xb1), 0xb1);
+    _mm_storeu_si128((__m128i *)(out + x), v);
+  }
+#endif
+  for (; x < count; x++) {
+    const unsigned char *value = bytes + x * 4;
+    out[x] = ((unsigned int)value[0] << 24) | ((unsigned int)value[1] << 16) |
+             ((unsigned int)value[2] << 8) | value[3];
+  }
+}
+
+void UnpackArray(DataType type, const unsigned char *bytes, size_t count,
+                 void *out) {
+  switch (type) {
+  case Short:
+  case UShort:
+    SwapBytes16(bytes, count, (unsigned short *)out);
+    break;
+  case Int:
+  case UInt:
+    SwapBytes32(bytes, count, (unsigned int *)out);
+    break;
+  default:
+    memcpy(out, bytes, count * GetStride(type));
+    break;
+  }
+}
+
 void UnpackUInt32(unsigned int &val, unsigned char *bytes) {
   val = (0xff000000 & (bytes[0] << 24)) | (0xff0000 & (bytes[1] << 16)) |
         (0xff00 & (bytes[2] << 8)) | (0xff & bytes[3]);
@@ -0,0 +1,135 @@
+#include "Utility/Data/Lz4.h"
+#include <string.h>
+
+namespace {
+const size_t MinMatch = 4;
+// the last match has to start this far from the end, the last bytes are
+// always literals
+const size_t MatchSafeDistance = 12;
+const size_t LastLiterals = 5;
+const size_t MaxOffset = 65535;
+const unsigned int HashBits = 14;
+
+unsigned int Read32(const unsigned char *data) {
+  unsigned int value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+unsigned int Hash(unsigned int sequence) {
+  return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+void WriteLength(std::vector<unsigned char> &out, size_t length) {
+  for (; length >= 255; length -= 255)
+    out.push_back(255);
+  out.push_back((unsigned char)length);
+}
+
+void WriteSequence(std::vector<unsigned char> &out,
+                   const unsigned char *literals, size_t literalCount,
+                   size_t offset, size_t matchLength) {
+  size_t token = out.size();
+  out.push_back(0);
+  unsigned char literalNibble =
+      (unsigned char)(literalCount < 15 ? literalCount : 15);
+  if (literalCount >= 15)
+    WriteLength(out, literalCount - 15);
+  out.insert(out.end(), literals, literals + literalCount);
+  unsigned char matchNibble = 0;
+  if (matchLength) {
+    out.push_back((unsigned char)(offset & 0xff));
+    out.push_back((unsigned char)(offset >> 8));
+    size_t length = matchLength - MinMatch;
+    matchNibble = (unsigned char)(length < 15 ? length : 15);
+    if (length >= 15)
+      WriteLength(out, length - 15);
+  }
+  out[token] = (unsigned char)(literalNibble << 4 | matchNibble);
+}
+
+bool ReadLength(const unsigned char *&in, const unsigned char *end,
+                size_t &length) {
+  unsigned char byte;
+  do {
+    if (in >= end)
+      return false;
+    byte = *in++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+} // namespace
+
+namespace Lz4 {
+size_t Compress(const unsigned char *data, size_t size,
+                std::vector<unsigned char> &out) {
+  size_t start = out.size();
+  // positions are stored plus one, zero is empty
+  std::vector<size_t> table((size_t)1 << HashBits, 0);
+  size_t anchor = 0;
+  size_t position = 0;
+  size_t matchLimit = size > MatchSafeDistance ? size - MatchSafeDistance : 0;
+  while (position < matchLimit) {
+    unsigned int sequence = Read32(data + position);
+    size_t &slot = table[Hash(sequence)];
+    size_t candidate = slot;
+    slot = position + 1;
+    if (!candidate || position - (candidate - 1) > MaxOffset ||
+        Read32(data + candidate - 1) != sequence) {
+      position++;
+      continue;
+    }
+    size_t match = candidate - 1;
+    size_t length = MinMatch;
+    size_t lengthLimit = size - LastLiterals;
+    while (position + length < lengthLimit &&
+           data[match + length] == data[position + length])
+      length++;
+    WriteSequence(out, data + anchor, position - anchor, position - match,
+                  length);
+    position += length;
+    anchor = position;
+  }
+  WriteSequence(out, data + anchor, size - anchor, 0, 0);
+  return out.size() - start;
+}
+
+bool Decompress(const unsigned char *data, size_t size, unsigned char *out,
+                size_t outSize) {
+  const unsigned char *in = data;
+  const unsigned char *end = data + size;
+  size_t written = 0;
+  while (in < end) {
+    unsigned char token = *in++;
+    size_t literalCount = token >> 4;
+    if (literalCount == 15 && !ReadLength(in, end, literalCount))
+      return false;
+    if (literalCount > (size_t)(end - in) || literalCount > outSize - written)
+      return false;
+    memcpy(out + written, in, literalCount);
+    in += literalCount;
+    written += literalCount;
+    // the last sequence has no match
+    if (in == end)
+      break;
+
+    if (end - in < 2)
+      return false;
+    size_t offset = in[0] | (size_t)in[1] << 8;
+    in += 2;
+    size_t matchLength = token & 15;
+    if (matchLength == 15 && !ReadLength(in, end, matchLength))
+      return false;
+    matchLength += MinMatch;
+    if (offset == 0 || offset > written || matchLength > outSize - written)
+      return false;
+    // matches may overlap the bytes they produce
+    const unsigned char *match = out + written - offset;
+    for (size_t x = 0; x < matchLength; x++)
+      out[written + x] = match[x];
+    written += matchLength;
+  }
+  return written == outSize;
+}
+} // namespace Lz4
@@ -0,0 +1,138 @@
+// times reading an ssd file and decoding every array attribute
+// usage: SsdDecodeBenchmark [file] [iterations], run from the repo root
+#include "Modules/ResourceLoader/MappedFile.h"
+#include "Modules/ResourceLoader/SsdV1.h"
+#include "Modules/ResourceLoader/SsdV2.h"
+#include "Utility/Data/IDataNode.h"
+#include "Utility/Data/SSD.h"
+#include "Utility/Data/TypedAttribute.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCHMARK_DEFAULT_FILE "Assets/Scenes/SceneAssets/Meshes/geo.ssd"
+#define BENCHMARK_DEFAULT_ITERATIONS 50
+
+template <class T>
+static bool DecodeArray(ISerialized *attribute, std::vector<T> &values,
+                        unsigned long long &checksum) {
+  TypedAttribute<T> *array = dynamic_cast<TypedAttribute<T> *>(attribute);
+  if (!array)
+    return false;
+  values.resize(array->Size());
+  if (!values.empty())
+    array->CopyTo(values.data());
+  // keeps the decoding from being optimized away
+  for (size_t x = 0; x < values.size(); x += 64)
+    checksum += (unsigned long long)values[x];
+  checksum += values.size();
+  return true;
+}
+
+static void DecodeNode(IDataNode *node, unsigned long long &checksum) {
+  static std::vector<float> floats;
+  static std::vector<unsigned int> uints;
+  static std::vector<int> ints;
+  static std::vector<unsigned short> ushorts;
+  static std::vector<short> shorts;
+  static std::vector<unsigned char> uchars;
+  static std::vector<char> chars;
+  std::vector<ISerialized *> attributes = node->GetAttributes();
+  for (size_t x = 0; x < attributes.size(); x++) {
+    TypedAttribute<IDataNode *> *children =
+        dynamic_cast<TypedAttribute<IDataNode *> *>(attributes[x]);
+    if (children) {
+      std::vector<IDataNode *> nodes = children->Get();
+      for (size_t y = 0; y < nodes.size(); y++)
+        DecodeNode(nodes[y], checksum);
+      continue;
+    }
+    DecodeArray(attributes[x], floats, checksum) ||
+        DecodeArray(attributes[x], uints, checksum) ||
+        DecodeArray(attributes[x], ints, checksum) ||
+        DecodeArray(attributes[x], ushorts, checksum) ||
+        DecodeArray(attributes[x], shorts, checksum) ||
+        DecodeArray(attributes[x], uchars, checksum) ||
+        DecodeArray(attributes[x], chars, checksum);
+  }
+  std::vector<IDataNode *> nodes = node->GetNodes();
+  for (size_t x = 0; x < nodes.size(); x++)
+    DecodeNode(nodes[x], checksum);
+}
+
+static bool ReadNodes(const unsigned char *data, size_t size,
+                      const std::shared_ptr<void> &owner,
+                      std::vector<IDataNode *> &nodes) {
+  String error;
+  bool read = size > 3 && data[3] == SSD::Version2
+                  ? SsdV2::ReadNodes(data, size, owner, nodes, error)
+                  : SsdV1::ReadNodes(data, size, owner, nodes, error);
+  if (!read)
+    printf("%s\n", error.GetCharArray());
+  return read;
+}
+
+static void DeleteNodes(std::vector<IDataNode *> &nodes) {
+  for (size_t x = 0; x < nodes.size(); x++)
+    delete nodes[x];
+  nodes.clear();
+}
+
+// without an owner arrays are decoded while the file is read, with one they
+// stay in the data until they are copied out
+static bool Run(const char *name, const unsigned char *data, size_t size,
+                const std::shared_ptr<void> &owner, int iterations) {
+  unsigned long long checksum = 0;
+  std::chrono::high_resolution_clock::time_point start =
+      std::chrono::high_resolution_clock::now();
+  for (int x = 0; x < iterations; x++) {
+    std::vector<IDataNode *> nodes;
+    if (!ReadNodes(data, size, owner, nodes))
+      return false;
+    for (size_t y = 0; y < nodes.size(); y++)
+      DecodeNode(nodes[y], checksum);
+    DeleteNodes(nodes);
+  }
+  double totalMs = std::chrono::duration<double, std::milli>(
+                       std::chrono::high_resolution_clock::now() - start)
+                       .count();
+  printf("%-16s %8.3f ms per load  checksum %llu\n", name,
+         totalMs / iterations, checksum / iterations);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *fileName = argc > 1 ? argv[1] : BENCHMARK_DEFAULT_FILE;
+  int iterations = argc > 2 ? atoi(argv[2]) : BENCHMARK_DEFAULT_ITERATIONS;
+  if (iterations < 1)
+    iterations = 1;
+
+  std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+  if (!file->Open(fileName)) {
+    printf("couldn't open %s\n", fileName);
+    return 1;
+  }
+  printf("%s, %zu bytes, version %d, %d iterations\n", fileName,
+         file->GetSize(), file->GetSize() > 3 ? file->GetData()[3] : 0,
+         iterations);
+  std::shared_ptr<void> noOwner;
+  if (!Run("eager", file->GetData(), file->GetSize(), noOwner, iterations) ||
+      !Run("mapped", file->GetData(), file->GetSize(), file, iterations))
+    return 1;
+
+  // the same nodes written as version 2, arrays are copied as they are
+  std::vector<IDataNode *> nodes;
+  std::vector<unsigned char> version2;
+  if (!ReadNodes(file->GetData(), file->GetSize(), noOwner, nodes))
+    return 1;
+  SsdV2::WriteNodes(nodes, version2);
+  DeleteNodes(nodes);
+  std::shared_ptr<void> version2Owner(&version2, [](void *) {});
+  if (!Run("eager v2", version2.data(), version2.size(), noOwner,
+           iterations) ||
+      !Run("mapped v2", version2.data(), version2.size(), version2Owner,
+           iterations))
+    return 1;
+  return 0;
+}
@@ -0,0 +1,176 @@
+// checks the indirect commands built for a batch of mesh ranges and the
+// allocation of ranges in the shared buffers
+#include "Modules/Graphics/IndirectDraw.h"
+#include <stdio.h>
+
+static int Failures = 0;
+
+#define CHECK(condition)                                                       \
+  if (!(condition)) {                                                          \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);       \
+    Failures++;                                                                \
+  }
+
+static MeshRange MakeRange(unsigned int firstIndex, unsigned int indexCount,
+                           int baseVertex) {
+  MeshRange range;
+  range.FirstIndex = firstIndex;
+  range.IndexCount = indexCount;
+  range.BaseVertex = baseVertex;
+  return range;
+}
+
+static void CheckCommand(const DrawElementsIndirectCommand &command,
+                         const MeshRange &range, unsigned int instanceCount,
+                         unsigned int baseInstance) {
+  CHECK(command.Count == range.IndexCount);
+  CHECK(command.InstanceCount == instanceCount);
+  CHECK(command.FirstIndex == range.FirstIndex);
+  CHECK(command.BaseVertex == range.BaseVertex);
+  CHECK(command.BaseInstance == baseInstance);
+}
+
+static void TestEmptyBatch() {
+  std::vector<DrawElementsIndirectCommand> commands(3);
+  IndirectDrawUtils::BuildCommands(nullptr, 0, commands);
+  CHECK(commands.empty());
+}
+
+static void TestMergedInstances() {
+  MeshRange box = MakeRange(0, 36, 0);
+  MeshRange torus = MakeRange(36, 960, 24);
+  MeshRange ranges[] = {box, box, box, torus, box};
+  std::vector<DrawElementsIndirectCommand> commands;
+  IndirectDrawUtils::BuildCommands(ranges, 5, commands);
+  // only consecutive draws are merged, the base instance is the first draw
+  CHECK(commands.size() == 3);
+  if (commands.size() != 3)
+    return;
+  CheckCommand(commands[0], box, 3, 0);
+  CheckCommand(commands[1], torus, 1, 3);
+  CheckCommand(commands[2], box, 1, 4);
+}
+
+static void TestDistinctRanges() {
+  // same indices with a different base vertex are different meshes
+  MeshRange first = MakeRange(120, 36, 0);
+  MeshRange second = MakeRange(120, 36, 512);
+  MeshRange third = MakeRange(156, 36, 512);
+  MeshRange ranges[] = {first, second, third};
+  std::vector<DrawElementsIndirectCommand> commands;
+  IndirectDrawUtils::BuildCommands(ranges, 3, commands);
+  CHECK(commands.size() == 3);
+  if (commands.size() != 3)
+    return;
+  CheckCommand(commands[0], first, 1, 0);
+  CheckCommand(commands[1], second, 1, 1);
+  CheckCommand(commands[2], third, 1, 2);
+}
+
+static void TestPendingMeshes() {
+  // meshes still uploading have an empty range, later draws keep their index
+  MeshRange mesh = MakeRange(0, 36, 0);
+  MeshRange pending;
+  MeshRange ranges[] = {mesh, pending, mesh};
+  std::vector<DrawElementsIndirectCommand> commands;
+  IndirectDrawUtils::BuildCommands(ranges, 3, commands);
+  CHECK(commands.size() == 3);
+  if (commands.size() != 3)
+    return;
+  CheckCommand(commands[0], mesh, 1, 0);
+  CheckCommand(commands[1], pending, 1, 1);
+  CHECK(commands[1].Count == 0);
+  CheckCommand(commands[2], mesh, 1, 2);
+}
+
+static void TestCommandsAreReset() {
+  MeshRange mesh = MakeRange(0, 6, 0);
+  std::vector<DrawElementsIndirectCommand> commands;
+  IndirectDrawUtils::BuildCommands(&mesh, 1, commands);
+  IndirectDrawUtils::BuildCommands(&mesh, 1, commands);
+  CHECK(commands.size() == 1);
+}
+
+static void TestAllocatorAppends() {
+  BatchRangeAllocator allocator;
+  CHECK(allocator.Allocate(24) == 0);
+  CHECK(allocator.Allocate(8) == 24);
+  CHECK(allocator.GetUsedCount() == 32);
+  CHECK(allocator.GetFreeCount() == 0);
+}
+
+static void TestAllocatorReusesFreedRanges() {
+  BatchRangeAllocator allocator;
+  unsigned int first = allocator.Allocate(24);
+  unsigned int second = allocator.Allocate(8);
+  allocator.Allocate(16);
+  allocator.Free(first, 24);
+  CHECK(allocator.GetFreeCount() == 24);
+  // first fit, the rest of the range stays free
+  CHECK(allocator.Allocate(10) == 0);
+  CHECK(allocator.Allocate(20) == 48);
+  CHECK(allocator.GetFreeCount() == 14);
+  allocator.Free(second, 8);
+  // merged with the free range before it
+  CHECK(allocator.Allocate(22) == 10);
+  CHECK(allocator.GetFreeCount() == 0);
+  CHECK(allocator.GetUsedCount() == 68);
+}
+
+static void TestAllocatorMergesNeighbours() {
+  BatchRangeAllocator allocator;
+  unsigned int first = allocator.Allocate(4);
+  unsigned int second = allocator.Allocate(4);
+  unsigned int third = allocator.Allocate(4);
+  allocator.Allocate(4);
+  allocator.Free(first, 4);
+  allocator.Free(third, 4);
+  allocator.Free(second, 4);
+  CHECK(allocator.GetFreeCount() == 12);
+  CHECK(allocator.Allocate(12) == 0);
+}
+
+static void TestAllocatorShrinksAtTheEnd() {
+  BatchRangeAllocator allocator;
+  unsigned int first = allocator.Allocate(4);
+  unsigned int second = allocator.Allocate(4);
+  unsigned int third = allocator.Allocate(4);
+  allocator.Free(second, 4);
+  allocator.Free(third, 4);
+  // the freed tail isn't kept as a free range
+  CHECK(allocator.GetUsedCount() == 4);
+  CHECK(allocator.GetFreeCount() == 0);
+  allocator.Free(first, 4);
+  CHECK(allocator.GetUsedCount() == 0);
+}
+
+static void TestAllocatorWithResidentRanges() {
+  // meshes streamed in and out around resident ones keep reusing the space
+  BatchRangeAllocator allocator;
+  allocator.Allocate(6);
+  unsigned int streamed[2] = {allocator.Allocate(32), allocator.Allocate(32)};
+  allocator.Allocate(6);
+  for (unsigned int x = 0; x < 100; x++) {
+    unsigned int slot = x % 2;
+    allocator.Free(streamed[slot], 32);
+    streamed[slot] = allocator.Allocate(32);
+  }
+  CHECK(allocator.GetUsedCount() == 76);
+  CHECK(allocator.GetFreeCount() == 0);
+}
+
+int main() {
+  TestEmptyBatch();
+  TestMergedInstances();
+  TestDistinctRanges();
+  TestPendingMeshes();
+  TestCommandsAreReset();
+  TestAllocatorAppends();
+  TestAllocatorReusesFreedRanges();
+  TestAllocatorMergesNeighbours();
+  TestAllocatorShrinksAtTheEnd();
+  TestAllocatorWithResidentRanges();
+  if (Failures)
+    printf("%d checks failed\n", Failures);
+  return Failures ? 1 : 0;
+}
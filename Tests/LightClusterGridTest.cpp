@@ -0,0 +1,150 @@
+// checks the binning of lights into the clustered froxel grid
+#include "Modules/Graphics/LightClusterGrid.h"
+#include <stdio.h>
+
+static int Failures = 0;
+
+#define CHECK(condition)                                                       \
+  if (!(condition)) {                                                          \
+    printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);       \
+    Failures++;                                                                \
+  }
+
+static LightClusterGrid::ClusterLight MakeLight(float x, float y, float z,
+                                                float radius) {
+  LightClusterGrid::ClusterLight light;
+  light.ViewPosition = glm::vec3(x, y, z);
+  light.Radius = radius;
+  return light;
+}
+
+static unsigned int CountBinnedClusters(const LightClusterGrid &grid) {
+  unsigned int count = 0;
+  for (unsigned int x = 0; x < grid.GetClusterCount(); x++)
+    if (grid.GetLightCount(x))
+      count++;
+  return count;
+}
+
+static void TestSmallLight() {
+  // 90 degrees, so the ndc of a view position is x * 0.5625 / depth for a
+  // 16:9 aspect and y / depth
+  LightClusterGrid grid(16, 9, 24);
+  grid.SetProjection(1.5707964f, 16.f / 9.f, .1f, 100.f);
+  // depth 5 is slice 24 * log(50) / log(1000) = 13.6, ndc (0.3, -0.5) is
+  // tile (10.4, 2.25)
+  std::vector<LightClusterGrid::ClusterLight> lights;
+  lights.push_back(MakeLight(0.3f * 5.f / 0.5625f, -2.5f, -5.f, .01f));
+  grid.Build(lights);
+
+  CHECK(grid.GetSliceForDepth(5.f) == 13);
+  unsigned int cluster = grid.GetClusterIndex(10, 2, 13);
+  CHECK(grid.GetLightCount(cluster) == 1);
+  CHECK(CountBinnedClusters(grid) == 1);
+  CHECK(grid.GetLightIndices().size() == 1);
+  if (grid.GetLightIndices().size() != 1)
+    return;
+  CHECK(grid.GetLightIndices()[grid.GetClusterRanges()[cluster * 2]] == 0);
+}
+
+static void TestTileAndSliceRange() {
+  LightClusterGrid grid(8, 8, 16);
+  grid.SetProjection(1.5707964f, 1.f, 1.f, 100.f);
+  // depths 19 to 21 are slices 10.2 to 10.6, the ndc range is -1/19 to 1/19
+  // which covers tiles 3 and 4 on both axes
+  std::vector<LightClusterGrid::ClusterLight> lights;
+  lights.push_back(MakeLight(0.f, 0.f, -20.f, 1.f));
+  grid.Build(lights);
+
+  CHECK(grid.GetSliceForDepth(19.f) == 10);
+  CHECK(grid.GetSliceForDepth(21.f) == 10);
+  CHECK(CountBinnedClusters(grid) == 4);
+  for (unsigned int y = 3; y < 5; y++)
+    for (unsigned int x = 3; x < 5; x++)
+      CHECK(grid.GetLightCount(grid.GetClusterIndex(x, y, 10)) == 1);
+  CHECK(grid.GetLightIndices().size() == 4);
+}
+
+static void TestLightsOutsideTheDepthRange() {
+  LightClusterGrid grid(8, 8, 16);
+  grid.SetProjection(1.5707964f, 1.f, 1.f, 100.f);
+  std::vector<LightClusterGrid::ClusterLight> lights;
+  // behind the camera
+  lights.push_back(MakeLight(0.f, 0.f, 5.f, 1.f));
+  // in front of the camera but ending before the near plane
+  lights.push_back(MakeLight(0.f, 0.f, -.5f, .2f));
+  // starting past the far plane
+  lights.push_back(MakeLight(0.f, 0.f, -200.f, 10.f));
+  grid.Build(lights);
+  CHECK(grid.GetLightIndices().empty());
+  CHECK(CountBinnedClusters(grid) == 0);
+
+  // a light crossing the near plane is kept in the first slice
+  lights.push_back(MakeLight(0.f, 0.f, -1.2f, .5f));
+  grid.Build(lights);
+  CHECK(!grid.GetLightIndices().empty());
+  for (unsigned int x = 0; x < grid.GetLightIndices().size(); x++)
+    CHECK(grid.GetLightIndices()[x] == 3);
+  CHECK(grid.GetLightCount(grid.GetClusterIndex(4, 4, 0)) == 1);
+}
+
+static void TestRangesAreConsistent() {
+  LightClusterGrid grid;
+  grid.SetProjection(1.f, 16.f / 9.f, .1f, 500.f);
+  // deterministic scatter of lights in front of the camera
+  std::vector<LightClusterGrid::ClusterLight> lights;
+  unsigned int seed = 12345;
+  for (unsigned int x = 0; x < 200; x++) {
+    float values[4];
+    for (unsigned int y = 0; y < 4; y++) {
+      seed = seed * 1103515245u + 12345u;
+      values[y] = ((seed >> 8) & 0xffff) / 65535.f;
+    }
+    lights.push_back(MakeLight(values[0] * 80.f - 40.f, values[1] * 50.f - 25.f,
+                               -values[2] * 120.f, values[3] * 6.f + .1f));
+  }
+  grid.Build(lights);
+
+  const std::vector<unsigned int> &ranges = grid.GetClusterRanges();
+  const std::vector<unsigned int> &indices = grid.GetLightIndices();
+  CHECK(ranges.size() == grid.GetClusterCount() * 2);
+  CHECK(!indices.empty());
+  // the ranges follow each other and cover every index once
+  unsigned int offset = 0;
+  bool contiguous = true;
+  bool sorted = true;
+  for (unsigned int x = 0; x < grid.GetClusterCount(); x++) {
+    unsigned int begin = ranges[x * 2];
+    unsigned int count = ranges[x * 2 + 1];
+    contiguous = contiguous && begin == offset;
+    offset += count;
+    // pairs are added in light order, the sort keeps it within a cluster
+    for (unsigned int y = begin + 1; y < begin + count && y < indices.size();
+         y++)
+      sorted = sorted && indices[y - 1] < indices[y];
+  }
+  CHECK(contiguous);
+  CHECK(sorted);
+  CHECK(offset == indices.size());
+  bool validLights = true;
+  for (size_t x = 0; x < indices.size(); x++)
+    validLights = validLights && indices[x] < lights.size();
+  CHECK(validLights);
+
+  // building again gives the same result
+  std::vector<unsigned int> previousRanges = ranges;
+  std::vector<unsigned int> previousIndices = indices;
+  grid.Build(lights);
+  CHECK(grid.GetClusterRanges() == previousRanges);
+  CHECK(grid.GetLightIndices() == previousIndices);
+}
+
+int main() {
+  TestSmallLight();
+  TestTileAndSliceRange();
+  TestLightsOutsideTheDepthRange();
+  TestRangesAreConsistent();
+  if (Failures)
+    printf("%d checks failed\n", Failures);
+  return Failures ? 1 : 0;
+}